@@ -66,6 +66,7 @@
 #include <wsutil/version_info.h>
 #include <wsutil/report_message.h>
 #include <wiretap/wtap_opttypes.h>
+#include <wiretap/packet_index.h>
 
 #ifdef HAVE_PLUGINS
 #include <wsutil/plugins.h>
@@ -149,16 +150,25 @@ static bool cap_file_hashes    = true;  /* Calculate file hashes */
 #define HASH_STR_SIZE (65) /* Max hash size * 2 + '\0' */
 #define HASH_BUF_SIZE (1024 * 1024)
 
+/*
+ * Files can be scanned on several threads at once (--threads), so the
+ * counters filled in by the wiretap callbacks are per thread.
+ */
+static WS_THREAD_LOCAL unsigned int num_ipv4_addresses;
+static WS_THREAD_LOCAL unsigned int num_ipv6_addresses;
+static WS_THREAD_LOCAL unsigned int num_decryption_secrets;
 
-static char file_sha256[HASH_STR_SIZE];
-static char file_sha1[HASH_STR_SIZE];
-
-static char  *hash_buf;
-static gcry_md_hd_t hd;
+/*
+ * The wiretap readers aren't thread-safe; some of them keep state in
+ * static variables (json_log's token buffer, for example).  Only one
+ * thread at a time may open, read or close a file, so the threads
+ * overlap only the hashing and the reporting.
+ */
+static GMutex wtap_mutex;
 
-static unsigned int num_ipv4_addresses;
-static unsigned int num_ipv6_addresses;
-static unsigned int num_decryption_secrets;
+static uint32_t num_threads = 1;        /* Number of files to scan at once */
+static bool fast_scan;                  /* Only read record headers */
+static bool write_index;                /* Write a packet index next to each file */
 
 /*
  * If we have at least two packets with time stamps, and they're not in
@@ -219,6 +229,12 @@ typedef struct _capture_info {
     GArray               *interface_packet_counts;  /* array of per_packet interface_id counts; one entry per file IDB */
     uint32_t              pkt_interface_id_unknown; /* counts if packet interface_id didn't match a known one */
     GArray               *idb_info_strings;         /* array of IDB info strings */
+
+    char                  file_sha256[HASH_STR_SIZE];
+    char                  file_sha1[HASH_STR_SIZE];
+    unsigned int          num_ipv4_addresses;
+    unsigned int          num_ipv6_addresses;
+    unsigned int          num_decryption_secrets;
 } capture_info;
 
 static char *decimal_point;
@@ -593,8 +609,8 @@ print_stats(const char *filename, capture_info *cf_info)
         }
     }
     if (cap_file_hashes) {
-        printf     ("SHA256:              %s\n", file_sha256);
-        printf     ("SHA1:                %s\n", file_sha1);
+        printf     ("SHA256:              %s\n", cf_info->file_sha256);
+        printf     ("SHA1:                %s\n", cf_info->file_sha1);
     }
     if (cap_order)          printf     ("Strict time order:   %s\n", order_string(cf_info->order));
 
@@ -662,14 +678,14 @@ print_stats(const char *filename, capture_info *cf_info)
     }
 
     if (cap_file_nrb) {
-        if (num_ipv4_addresses != 0)
-            printf   ("Number of resolved IPv4 addresses in file: %u\n", num_ipv4_addresses);
-        if (num_ipv6_addresses != 0)
-            printf   ("Number of resolved IPv6 addresses in file: %u\n", num_ipv6_addresses);
+        if (cf_info->num_ipv4_addresses != 0)
+            printf   ("Number of resolved IPv4 addresses in file: %u\n", cf_info->num_ipv4_addresses);
+        if (cf_info->num_ipv6_addresses != 0)
+            printf   ("Number of resolved IPv6 addresses in file: %u\n", cf_info->num_ipv6_addresses);
     }
     if (cap_file_dsb) {
-        if (num_decryption_secrets != 0)
-            printf   ("Number of decryption secrets in file: %u\n", num_decryption_secrets);
+        if (cf_info->num_decryption_secrets != 0)
+            printf   ("Number of decryption secrets in file: %u\n", cf_info->num_decryption_secrets);
     }
 }
 
@@ -900,12 +916,12 @@ print_stats_table(const char *filename, capture_info *cf_info)
     if (cap_file_hashes) {
         putsep();
         putquote();
-        printf("%s", file_sha256);
+        printf("%s", cf_info->file_sha256);
         putquote();
 
         putsep();
         putquote();
-        printf("%s", file_sha1);
+        printf("%s", cf_info->file_sha1);
         putquote();
     }
 
@@ -1067,31 +1083,46 @@ hash_to_str(const unsigned char *hash, size_t length, char *str)
 }
 
 static void
-calculate_hashes(const char *filename)
+calculate_hashes(const char *filename, capture_info *cf_info)
 {
     FILE  *fh;
     size_t hash_bytes;
+    char  *hash_buf;
+    gcry_md_hd_t hd = NULL;
 
-    (void) g_strlcpy(file_sha256, "<unknown>", HASH_STR_SIZE);
-    (void) g_strlcpy(file_sha1, "<unknown>", HASH_STR_SIZE);
+    (void) g_strlcpy(cf_info->file_sha256, "<unknown>", HASH_STR_SIZE);
+    (void) g_strlcpy(cf_info->file_sha1, "<unknown>", HASH_STR_SIZE);
 
     if (cap_file_hashes) {
         fh = ws_fopen(filename, "rb");
+        gcry_md_open(&hd, GCRY_MD_SHA256, 0);
+        if (hd)
+            gcry_md_enable(hd, GCRY_MD_SHA1);
         if (fh && hd) {
+            hash_buf = (char *)g_malloc(HASH_BUF_SIZE);
             while((hash_bytes = fread(hash_buf, 1, HASH_BUF_SIZE, fh)) > 0) {
                 gcry_md_write(hd, hash_buf, hash_bytes);
             }
+            g_free(hash_buf);
             gcry_md_final(hd);
-            hash_to_str(gcry_md_read(hd, GCRY_MD_SHA256), HASH_SIZE_SHA256, file_sha256);
-            hash_to_str(gcry_md_read(hd, GCRY_MD_SHA1), HASH_SIZE_SHA1, file_sha1);
+            hash_to_str(gcry_md_read(hd, GCRY_MD_SHA256), HASH_SIZE_SHA256, cf_info->file_sha256);
+            hash_to_str(gcry_md_read(hd, GCRY_MD_SHA1), HASH_SIZE_SHA1, cf_info->file_sha1);
         }
         if (fh) fclose(fh);
-        if (hd) gcry_md_reset(hd);
+        gcry_md_close(hd);
     }
 }
 
+/*
+ * Read through a capture file and fill in "cf_info".  This doesn't print
+ * anything other than error messages, so it can be run on a worker thread.
+ *
+ * Returns 0 on success, 1 if the file couldn't be read to the end but
+ * there's still something to report, and 2 on failure.  Unless it returns
+ * 2, the caller must pass cf_info to report_cap_file() afterwards.
+ */
 static int
-process_cap_file(const char *filename, bool need_separator)
+scan_cap_file(const char *filename, capture_info *cf_info)
 {
     int                   status = 0;
     int                   err;
@@ -1104,7 +1135,6 @@ process_cap_file(const char *filename, bool need_separator)
     uint32_t              snaplen_min_inferred = 0xffffffff;
     uint32_t              snaplen_max_inferred =          0;
     wtap_rec              rec;
-    capture_info          cf_info;
     bool                  have_times = true;
     nstime_t              earliest_packet_time;
     int                   earliest_packet_time_tsprec;
@@ -1116,26 +1146,18 @@ process_cap_file(const char *filename, bool need_separator)
     order_t               order = IN_ORDER;
     unsigned int                 i;
     wtapng_iface_descriptions_t *idb_info;
+    wtap_packet_index_writer_t  *index_writer = NULL;
 
     pkt_cmt *pc = NULL, *prev = NULL;
 
-    cf_info.wth = wtap_open_offline(filename, WTAP_TYPE_AUTO, &err, &err_info, false, application_configuration_environment_prefix());
-    if (!cf_info.wth) {
+    g_mutex_lock(&wtap_mutex);
+    cf_info->wth = wtap_open_offline(filename, WTAP_TYPE_AUTO, &err, &err_info, false, application_configuration_environment_prefix());
+    if (!cf_info->wth) {
+        g_mutex_unlock(&wtap_mutex);
         report_cfile_open_failure(filename, err, err_info);
         return 2;
     }
 
-    /*
-     * Calculate the checksums. Do this after wtap_open_offline, so we don't
-     * bother calculating them for files that are not known capture types
-     * where we wouldn't print them anyway.
-     */
-    calculate_hashes(filename);
-
-    if (need_separator && long_report) {
-        printf("\n");
-    }
-
     nstime_set_zero(&earliest_packet_time);
     earliest_packet_time_tsprec = WTAP_TSPREC_UNKNOWN;
     nstime_set_zero(&latest_packet_time);
@@ -1143,17 +1165,17 @@ process_cap_file(const char *filename, bool need_separator)
     nstime_set_zero(&cur_time);
     nstime_set_zero(&prev_time);
 
-    cf_info.encap_counts = g_new0(int,WTAP_NUM_ENCAP_TYPES);
+    cf_info->encap_counts = g_new0(int,WTAP_NUM_ENCAP_TYPES);
 
-    idb_info = wtap_file_get_idb_info(cf_info.wth);
+    idb_info = wtap_file_get_idb_info(cf_info->wth);
 
     ws_assert(idb_info->interface_data != NULL);
 
-    cf_info.pkt_cmts = NULL;
-    cf_info.num_interfaces = idb_info->interface_data->len;
-    cf_info.interface_packet_counts  = g_array_sized_new(false, true, sizeof(uint32_t), cf_info.num_interfaces);
-    g_array_set_size(cf_info.interface_packet_counts, cf_info.num_interfaces);
-    cf_info.pkt_interface_id_unknown = 0;
+    cf_info->pkt_cmts = NULL;
+    cf_info->num_interfaces = idb_info->interface_data->len;
+    cf_info->interface_packet_counts  = g_array_sized_new(false, true, sizeof(uint32_t), cf_info->num_interfaces);
+    g_array_set_size(cf_info->interface_packet_counts, cf_info->num_interfaces);
+    cf_info->pkt_interface_id_unknown = 0;
 
     g_free(idb_info);
     idb_info = NULL;
@@ -1165,13 +1187,35 @@ process_cap_file(const char *filename, bool need_separator)
 
     /* Register callbacks for new name<->address maps from the file and
        decryption secrets from the file. */
-    wtap_set_cb_new_ipv4(cf_info.wth, count_ipv4_address);
-    wtap_set_cb_new_ipv6(cf_info.wth, count_ipv6_address);
-    wtap_set_cb_new_secrets(cf_info.wth, count_decryption_secret);
+    wtap_set_cb_new_ipv4(cf_info->wth, count_ipv4_address);
+    wtap_set_cb_new_ipv6(cf_info->wth, count_ipv6_address);
+    wtap_set_cb_new_secrets(cf_info->wth, count_decryption_secret);
+
+    if (write_index) {
+        int index_err;
+
+        index_writer = wtap_packet_index_writer_open(filename, &index_err);
+        if (index_writer == NULL) {
+            fprintf(stderr, "capinfos: Can't write packet index for \"%s\": %s.\n",
+                    filename, g_strerror(index_err));
+        }
+    }
 
     /* Tally up data that we need to parse through the file to find */
     wtap_rec_init(&rec, DEFAULT_INIT_BUFFER_SIZE_2048);
-    while (wtap_read(cf_info.wth, &rec, &err, &err_info, &data_offset))  {
+    while (fast_scan ?
+            wtap_read_header_only(cf_info->wth, &rec, &err, &err_info, &data_offset) :
+            wtap_read(cf_info->wth, &rec, &err, &err_info, &data_offset))  {
+        if (index_writer != NULL) {
+            int index_err;
+
+            if (!wtap_packet_index_writer_add(index_writer, data_offset, &rec, &index_err)) {
+                fprintf(stderr, "capinfos: Can't write packet index for \"%s\": %s.\n",
+                        filename, g_strerror(index_err));
+                wtap_packet_index_writer_close(index_writer, false, &index_err);
+                index_writer = NULL;
+            }
+        }
         if (rec.presence_flags & WTAP_HAS_TS) {
             prev_time = cur_time;
             cur_time = rec.ts;
@@ -1213,7 +1257,7 @@ process_cap_file(const char *filename, bool need_separator)
                     pc->next = NULL;
 
                     if (prev == NULL)
-                        cf_info.pkt_cmts = pc;
+                        cf_info->pkt_cmts = pc;
                     else
                         prev->next = pc;
 
@@ -1234,7 +1278,7 @@ process_cap_file(const char *filename, bool need_separator)
 
             if ((rec.rec_header.packet_header.pkt_encap > 0) &&
                     (rec.rec_header.packet_header.pkt_encap < WTAP_NUM_ENCAP_TYPES)) {
-                cf_info.encap_counts[rec.rec_header.packet_header.pkt_encap] += 1;
+                cf_info->encap_counts[rec.rec_header.packet_header.pkt_encap] += 1;
             } else {
                 fprintf(stderr, "capinfos: Unknown packet encapsulation %d in frame %u of file \"%s\"\n",
                         rec.rec_header.packet_header.pkt_encap, packet, filename);
@@ -1242,37 +1286,37 @@ process_cap_file(const char *filename, bool need_separator)
 
             /* Packet interface_id info */
             if (rec.presence_flags & WTAP_HAS_INTERFACE_ID) {
-                /* cf_info.num_interfaces is size, not index, so it's one more than max index */
-                if (rec.rec_header.packet_header.interface_id >= cf_info.num_interfaces) {
+                /* cf_info->num_interfaces is size, not index, so it's one more than max index */
+                if (rec.rec_header.packet_header.interface_id >= cf_info->num_interfaces) {
                     /*
                      * OK, re-fetch the number of interfaces, as there might have
                      * been an interface that was in the middle of packets, and
                      * grow the array to be big enough for the new number of
                      * interfaces.
                      */
-                    idb_info = wtap_file_get_idb_info(cf_info.wth);
+                    idb_info = wtap_file_get_idb_info(cf_info->wth);
 
-                    cf_info.num_interfaces = idb_info->interface_data->len;
-                    g_array_set_size(cf_info.interface_packet_counts, cf_info.num_interfaces);
+                    cf_info->num_interfaces = idb_info->interface_data->len;
+                    g_array_set_size(cf_info->interface_packet_counts, cf_info->num_interfaces);
 
                     g_free(idb_info);
                     idb_info = NULL;
                 }
-                if (rec.rec_header.packet_header.interface_id < cf_info.num_interfaces) {
-                    g_array_index(cf_info.interface_packet_counts, uint32_t,
+                if (rec.rec_header.packet_header.interface_id < cf_info->num_interfaces) {
+                    g_array_index(cf_info->interface_packet_counts, uint32_t,
                             rec.rec_header.packet_header.interface_id) += 1;
                 }
                 else {
-                    cf_info.pkt_interface_id_unknown += 1;
+                    cf_info->pkt_interface_id_unknown += 1;
                 }
             }
             else {
                 /* it's for interface_id 0 */
-                if (cf_info.num_interfaces != 0) {
-                    g_array_index(cf_info.interface_packet_counts, uint32_t, 0) += 1;
+                if (cf_info->num_interfaces != 0) {
+                    g_array_index(cf_info->interface_packet_counts, uint32_t, 0) += 1;
                 }
                 else {
-                    cf_info.pkt_interface_id_unknown += 1;
+                    cf_info->pkt_interface_id_unknown += 1;
                 }
             }
         }
@@ -1281,6 +1325,16 @@ process_cap_file(const char *filename, bool need_separator)
     } /* while */
     wtap_rec_cleanup(&rec);
 
+    if (index_writer != NULL) {
+        int index_err;
+
+        /* Only keep an index that covers the whole file. */
+        if (!wtap_packet_index_writer_close(index_writer, err == 0, &index_err)) {
+            fprintf(stderr, "capinfos: Can't write packet index for \"%s\": %s.\n",
+                    filename, g_strerror(index_err));
+        }
+    }
+
     /*
      * Get IDB info strings.
      * We do this at the end, so we can get information for all IDBs in
@@ -1288,14 +1342,14 @@ process_cap_file(const char *filename, bool need_separator)
      * we get, for example, a count of the number of statistics entries
      * for each interface as of the *end* of the file.
      */
-    idb_info = wtap_file_get_idb_info(cf_info.wth);
+    idb_info = wtap_file_get_idb_info(cf_info->wth);
 
-    cf_info.idb_info_strings = g_array_sized_new(false, false, sizeof(char*), cf_info.num_interfaces);
-    cf_info.num_interfaces = idb_info->interface_data->len;
-    for (i = 0; i < cf_info.num_interfaces; i++) {
+    cf_info->idb_info_strings = g_array_sized_new(false, false, sizeof(char*), cf_info->num_interfaces);
+    cf_info->num_interfaces = idb_info->interface_data->len;
+    for (i = 0; i < cf_info->num_interfaces; i++) {
         const wtap_block_t if_descr = g_array_index(idb_info->interface_data, wtap_block_t, i);
         char *s = wtap_get_debug_if_descr(if_descr, 21, "\n");
-        g_array_append_val(cf_info.idb_info_strings, s);
+        g_array_append_val(cf_info->idb_info_strings, s);
     }
 
     g_free(idb_info);
@@ -1312,92 +1366,213 @@ process_cap_file(const char *filename, bool need_separator)
             fprintf(stderr,
                     "  (will continue anyway, checksums might be incorrect)\n");
         } else {
-            cleanup_capture_info(&cf_info);
-            wtap_close(cf_info.wth);
+            cleanup_capture_info(cf_info);
+            wtap_close(cf_info->wth);
+            g_mutex_unlock(&wtap_mutex);
             return 2;
         }
     }
 
     /* File size */
-    size = wtap_file_size(cf_info.wth, &err);
+    size = wtap_file_size(cf_info->wth, &err);
     if (size == -1) {
         fprintf(stderr,
                 "capinfos: Can't get size of \"%s\": %s.\n",
                 filename, g_strerror(err));
-        cleanup_capture_info(&cf_info);
-        wtap_close(cf_info.wth);
+        cleanup_capture_info(cf_info);
+        wtap_close(cf_info->wth);
+        g_mutex_unlock(&wtap_mutex);
         return 2;
     }
 
-    cf_info.filesize = size;
+    cf_info->filesize = size;
 
     /* File Type */
-    cf_info.file_type = wtap_file_type_subtype(cf_info.wth);
-    cf_info.compression_type = wtap_get_compression_type(cf_info.wth);
+    cf_info->file_type = wtap_file_type_subtype(cf_info->wth);
+    cf_info->compression_type = wtap_get_compression_type(cf_info->wth);
 
     /* File Encapsulation */
-    cf_info.file_encap = wtap_file_encap(cf_info.wth);
+    cf_info->file_encap = wtap_file_encap(cf_info->wth);
 
-    cf_info.file_tsprec = wtap_file_tsprec(cf_info.wth);
+    cf_info->file_tsprec = wtap_file_tsprec(cf_info->wth);
 
     /* Packet size limit (snaplen) */
-    cf_info.snaplen = wtap_snapshot_length(cf_info.wth);
-    if (cf_info.snaplen > 0)
-        cf_info.snap_set = true;
+    cf_info->snaplen = wtap_snapshot_length(cf_info->wth);
+    if (cf_info->snaplen > 0)
+        cf_info->snap_set = true;
     else
-        cf_info.snap_set = false;
+        cf_info->snap_set = false;
+
+    g_mutex_unlock(&wtap_mutex);
+
+    /*
+     * Calculate the checksums. Do this after wtap_open_offline, so we don't
+     * bother calculating them for files that are not known capture types
+     * where we wouldn't print them anyway, and outside wtap_mutex, so that
+     * other threads can read their files meanwhile.
+     */
+    calculate_hashes(filename, cf_info);
 
-    cf_info.snaplen_min_inferred = snaplen_min_inferred;
-    cf_info.snaplen_max_inferred = snaplen_max_inferred;
+    cf_info->snaplen_min_inferred = snaplen_min_inferred;
+    cf_info->snaplen_max_inferred = snaplen_max_inferred;
 
     /* # of packets */
-    cf_info.packet_count = packet;
+    cf_info->packet_count = packet;
 
     /* File Times */
-    cf_info.times_known = have_times;
-    cf_info.earliest_packet_time = earliest_packet_time;
-    cf_info.earliest_packet_time_tsprec = earliest_packet_time_tsprec;
-    cf_info.latest_packet_time = latest_packet_time;
-    cf_info.latest_packet_time_tsprec = latest_packet_time_tsprec;
-    nstime_delta(&cf_info.duration, &latest_packet_time, &earliest_packet_time);
+    cf_info->times_known = have_times;
+    cf_info->earliest_packet_time = earliest_packet_time;
+    cf_info->earliest_packet_time_tsprec = earliest_packet_time_tsprec;
+    cf_info->latest_packet_time = latest_packet_time;
+    cf_info->latest_packet_time_tsprec = latest_packet_time_tsprec;
+    nstime_delta(&cf_info->duration, &latest_packet_time, &earliest_packet_time);
     /* Duration precision is the higher of the earliest and latest packet timestamp precisions. */
-    if (cf_info.latest_packet_time_tsprec > cf_info.earliest_packet_time_tsprec)
-        cf_info.duration_tsprec = cf_info.latest_packet_time_tsprec;
+    if (cf_info->latest_packet_time_tsprec > cf_info->earliest_packet_time_tsprec)
+        cf_info->duration_tsprec = cf_info->latest_packet_time_tsprec;
     else
-        cf_info.duration_tsprec = cf_info.earliest_packet_time_tsprec;
-    cf_info.know_order = know_order;
-    cf_info.order = order;
+        cf_info->duration_tsprec = cf_info->earliest_packet_time_tsprec;
+    cf_info->know_order = know_order;
+    cf_info->order = order;
 
     /* Number of packet bytes */
-    cf_info.packet_bytes = bytes;
+    cf_info->packet_bytes = bytes;
 
-    cf_info.data_rate   = 0.0;
-    cf_info.packet_rate = 0.0;
-    cf_info.packet_size = 0.0;
+    cf_info->data_rate   = 0.0;
+    cf_info->packet_rate = 0.0;
+    cf_info->packet_size = 0.0;
 
     if (packet > 0) {
         double delta_time = nstime_to_sec(&latest_packet_time) - nstime_to_sec(&earliest_packet_time);
         if (delta_time > 0.0) {
-            cf_info.data_rate   = (double)bytes  / delta_time; /* Data rate per second */
-            cf_info.packet_rate = (double)packet / delta_time; /* packet rate per second */
+            cf_info->data_rate   = (double)bytes  / delta_time; /* Data rate per second */
+            cf_info->packet_rate = (double)packet / delta_time; /* packet rate per second */
         }
-        cf_info.packet_size = (double)bytes / packet;                  /* Avg packet size      */
+        cf_info->packet_size = (double)bytes / packet;                  /* Avg packet size      */
+    }
+
+    cf_info->num_ipv4_addresses = num_ipv4_addresses;
+    cf_info->num_ipv6_addresses = num_ipv6_addresses;
+    cf_info->num_decryption_secrets = num_decryption_secrets;
+
+    return status;
+}
+
+/*
+ * Print the information gathered by scan_cap_file() and free it.
+ */
+static void
+report_cap_file(const char *filename, capture_info *cf_info, bool need_separator)
+{
+    if (need_separator && long_report) {
+        printf("\n");
     }
 
     if (!long_report && table_report_header) {
-      print_stats_table_header(&cf_info);
+      print_stats_table_header(cf_info);
     }
 
     if (long_report) {
-        print_stats(filename, &cf_info);
+        print_stats(filename, cf_info);
     } else {
-        print_stats_table(filename, &cf_info);
+        print_stats_table(filename, cf_info);
     }
+    fflush(stdout);
+
+    cleanup_capture_info(cf_info);
+    g_mutex_lock(&wtap_mutex);
+    wtap_close(cf_info->wth);
+    g_mutex_unlock(&wtap_mutex);
+}
 
-    cleanup_capture_info(&cf_info);
-    wtap_close(cf_info.wth);
+typedef struct {
+    const char   *filename;
+    capture_info  cf_info;
+    int           status;
+    bool          done;
+} cap_file_job_t;
 
-    return status;
+static GMutex jobs_mutex;
+static GCond  jobs_cond;
+
+static void
+scan_cap_file_job(void *data, void *user_data _U_)
+{
+    cap_file_job_t *job = (cap_file_job_t *)data;
+    int status;
+
+    status = scan_cap_file(job->filename, &job->cf_info);
+
+    g_mutex_lock(&jobs_mutex);
+    job->status = status;
+    job->done = true;
+    g_cond_broadcast(&jobs_cond);
+    g_mutex_unlock(&jobs_mutex);
+}
+
+/*
+ * Scan the files on num_threads worker threads and report them in the
+ * order they were given, each as soon as it and all the ones before it
+ * are done. At most two files per thread are in flight, so the number
+ * of open files stays bounded however many are on the command line.
+ *
+ * Returns the overall error status.
+ */
+static int
+process_cap_files(char **filenames, int num_files)
+{
+    GThreadPool    *pool;
+    cap_file_job_t *jobs;
+    int             max_in_flight = 2 * (int)num_threads;
+    int             next_queued = 0;
+    int             next_reported;
+    bool            need_separator = false;
+    int             overall_error_status = 0;
+
+    jobs = g_new0(cap_file_job_t, num_files);
+    pool = g_thread_pool_new(scan_cap_file_job, NULL, (int)num_threads, false, NULL);
+
+    for (next_reported = 0; next_reported < num_files; next_reported++) {
+        cap_file_job_t *job = &jobs[next_reported];
+
+        while (next_queued < num_files && next_queued < next_reported + max_in_flight) {
+            jobs[next_queued].filename = filenames[next_queued];
+            g_thread_pool_push(pool, &jobs[next_queued], NULL);
+            next_queued++;
+        }
+
+        g_mutex_lock(&jobs_mutex);
+        while (!job->done)
+            g_cond_wait(&jobs_cond, &jobs_mutex);
+        g_mutex_unlock(&jobs_mutex);
+
+        if (job->status != 2) {
+            report_cap_file(job->filename, &job->cf_info, need_separator);
+            need_separator = true;
+        }
+        if (job->status) {
+            overall_error_status = job->status;
+            if (stop_after_failure) {
+                next_reported++;
+                break;
+            }
+        }
+    }
+
+    /* Let the files that are still being scanned finish, then discard them. */
+    g_thread_pool_free(pool, true, true);
+    for (; next_reported < next_queued; next_reported++) {
+        cap_file_job_t *job = &jobs[next_reported];
+
+        if (job->done && job->status != 2) {
+            cleanup_capture_info(&job->cf_info);
+            g_mutex_lock(&wtap_mutex);
+            wtap_close(job->cf_info.wth);
+            g_mutex_unlock(&wtap_mutex);
+        }
+    }
+    g_free(jobs);
+
+    return overall_error_status;
 }
 
 static void
@@ -1462,6 +1637,11 @@ print_usage(FILE *output)
     fprintf(output, "  -A generate all infos (default)\n");
     fprintf(output, "  -K disable displaying the capture comment\n");
     fprintf(output, "  -P disable displaying individual packet comments\n");
+    fprintf(output, "  --fast                   skip the hashes and packet comments, which need every\n");
+    fprintf(output, "                           byte of the file to be read, and skip packet data\n");
+    fprintf(output, "                           where the file format allows it\n");
+    fprintf(output, "  --threads <n>            process <n> files at once (0 = one per CPU)\n");
+    fprintf(output, "  --write-index            write a packet index next to each file\n");
     fprintf(output, "\n");
     fprintf(output, "Options are processed from left to right order with later options superseding\n");
     fprintf(output, "or adding to earlier options.\n");
@@ -1477,9 +1657,15 @@ main(int argc, char *argv[])
     bool need_separator = false;
     int    opt;
     int    overall_error_status = EXIT_SUCCESS;
+#define LONGOPT_THREADS     LONGOPT_BASE_APPLICATION+1
+#define LONGOPT_FAST        LONGOPT_BASE_APPLICATION+2
+#define LONGOPT_WRITE_INDEX LONGOPT_BASE_APPLICATION+3
     static const struct ws_option long_options[] = {
         {"help", ws_no_argument, NULL, 'h'},
         {"version", ws_no_argument, NULL, 'v'},
+        {"threads", ws_required_argument, NULL, LONGOPT_THREADS},
+        {"fast", ws_no_argument, NULL, LONGOPT_FAST},
+        {"write-index", ws_no_argument, NULL, LONGOPT_WRITE_INDEX},
         LONGOPT_WSLOG
         {0, 0, 0, 0 }
     };
@@ -1720,6 +1906,26 @@ main(int argc, char *argv[])
                 field_separator = ' ';
                 break;
 
+            case LONGOPT_THREADS:
+                if (!get_uint32(ws_optarg, "number of threads", &num_threads)) {
+                    overall_error_status = WS_EXIT_INVALID_OPTION;
+                    goto exit;
+                }
+                if (num_threads == 0)
+                    num_threads = g_get_num_processors();
+                break;
+
+            case LONGOPT_FAST:
+                /* Skip the infos that need every byte of the file. */
+                cap_file_hashes = false;
+                pkt_comments    = false;
+                fast_scan       = true;
+                break;
+
+            case LONGOPT_WRITE_INDEX:
+                write_index = true;
+                break;
+
             case 'h':
                 show_help_header("Print various information (infos) about capture files.");
                 print_usage(stdout);
@@ -1747,18 +1953,22 @@ main(int argc, char *argv[])
 
     if (cap_file_hashes) {
         gcry_check_version(NULL);
-        gcry_md_open(&hd, GCRY_MD_SHA256, 0);
-        if (hd)
-            gcry_md_enable(hd, GCRY_MD_SHA1);
-
-        hash_buf = (char *)g_malloc(HASH_BUF_SIZE);
     }
 
     overall_error_status = 0;
 
+    if (num_threads > 1) {
+        overall_error_status = process_cap_files(&argv[ws_optind], argc - ws_optind);
+        goto exit;
+    }
+
     for (opt = ws_optind; opt < argc; opt++) {
+        capture_info cf_info;
 
-        status = process_cap_file(argv[opt], need_separator);
+        status = scan_cap_file(argv[opt], &cf_info);
+        if (status != 2) {
+            report_cap_file(argv[opt], &cf_info, need_separator);
+        }
         if (status) {
             /* Something failed.  It's been reported; remember that processing
                one file failed and, if -C was specified, stop. */
@@ -1776,8 +1986,6 @@ main(int argc, char *argv[])
     }
 
 exit:
-    g_free(hash_buf);
-    gcry_md_close(hd);
     wtap_cleanup();
     free_progdirs();
     return overall_error_status;
@@ -29,6 +29,10 @@
 #include <glib.h>
 #include <gcrypt.h>
 
+#ifdef HAVE_XXHASH
+#include <xxhash.h>
+#endif /* HAVE_XXHASH */
+
 #ifdef HAVE_UNISTD_H
 #include <unistd.h>
 #endif
@@ -39,6 +43,7 @@
 
 #include <wiretap/secrets-types.h>
 #include <wiretap/wtap.h>
+#include <wiretap/packet_index.h>
 
 #include "epan/etypes.h"
 #include "epan/dissectors/packet-ieee80211-radiotap-defs.h"
@@ -86,11 +91,24 @@ struct select_item {
 
 /*
  * Duplicate frame detection
+ *
+ * fd_hash[] holds the digests of the last dup_window frames in arrival
+ * order, so the slot we're about to overwrite is always the one to
+ * evict. dup_set indexes the same digests, so checking a frame against
+ * the window is a single lookup rather than a scan of the whole ring.
  */
-typedef struct _fd_hash_t {
+typedef struct _dup_entry_t {
     uint8_t    digest[16];
     uint32_t   len;
-    nstime_t   frame_time;
+    unsigned   count;       /* Number of fd_hash[] slots with this digest */
+    nstime_t   last_time;   /* Timestamp of the most recent of them */
+} dup_entry_t;
+
+typedef struct _fd_hash_t {
+    uint8_t      digest[16];
+    uint32_t     len;
+    nstime_t     frame_time;
+    dup_entry_t *entry;     /* NULL if the slot hasn't been used yet */
 } fd_hash_t;
 
 #define DEFAULT_DUP_DEPTH       5   /* Used with -d */
@@ -99,6 +117,11 @@ typedef struct _fd_hash_t {
 static fd_hash_t fd_hash[MAX_DUP_DEPTH];
 static unsigned  dup_window    = DEFAULT_DUP_DEPTH;
 static unsigned  cur_dup_entry;
+static GHashTable *dup_set;
+
+static bool      dup_ignore_mutable;    /* Used with --dup-ignore-mutable */
+static uint8_t  *dup_scratch;
+static uint32_t  dup_scratch_size;
 
 static uint32_t  ignored_bytes;  /* Used with -I */
 
@@ -667,8 +690,130 @@ set_unused_info(wtap_rec *rec) {
     }
 }
 
-static bool
-is_duplicate(wtap_rec *rec) {
+static unsigned
+dup_entry_hash(const void *key)
+{
+    const dup_entry_t *entry = (const dup_entry_t *)key;
+    uint32_t h;
+
+    /* The digest is already evenly distributed; just use part of it. */
+    memcpy(&h, entry->digest, sizeof h);
+    return h ^ entry->len;
+}
+
+static gboolean
+dup_entry_equal(const void *a, const void *b)
+{
+    const dup_entry_t *ea = (const dup_entry_t *)a;
+    const dup_entry_t *eb = (const dup_entry_t *)b;
+
+    return ea->len == eb->len && memcmp(ea->digest, eb->digest, 16) == 0;
+}
+
+/*
+ * Zero the fields that change as a packet is forwarded (IPv4 TTL and
+ * header checksum, IPv6 hop limit, TCP and UDP checksums), so that
+ * copies of a packet taken on either side of a router compare equal.
+ * Only IP directly over Ethernet (optionally VLAN tagged), Linux cooked
+ * captures and raw IP are understood; other frames are left alone.
+ */
+static void
+mask_mutable_fields(uint8_t *fd, uint32_t len, int encap)
+{
+    uint32_t ip_off;
+    uint16_t etype;
+    uint32_t l4_off;
+    uint8_t  l4_proto;
+
+    switch (encap) {
+        case WTAP_ENCAP_ETHERNET:
+            if (len < 14)
+                return;
+            etype = pntohu16(fd + 12);
+            ip_off = 14;
+            while ((etype == ETHERTYPE_VLAN || etype == ETHERTYPE_IEEE_802_1AD)
+                   && len >= ip_off + VLAN_SIZE) {
+                etype = pntohu16(fd + ip_off + 2);
+                ip_off += VLAN_SIZE;
+            }
+            break;
+        case WTAP_ENCAP_SLL:
+            if (len < sizeof(struct sll_header))
+                return;
+            etype = pntohu16(fd + offsetof(struct sll_header, sll_protocol));
+            ip_off = sizeof(struct sll_header);
+            break;
+        case WTAP_ENCAP_SLL2:
+            if (len < sizeof(struct sll2_header))
+                return;
+            etype = pntohu16(fd + offsetof(struct sll2_header, sll2_protocol));
+            ip_off = sizeof(struct sll2_header);
+            break;
+        case WTAP_ENCAP_RAW_IP:
+        case WTAP_ENCAP_RAW_IP4:
+        case WTAP_ENCAP_RAW_IP6:
+            if (len < 1)
+                return;
+            etype = (fd[0] >> 4) == 6 ? ETHERTYPE_IPv6 : ETHERTYPE_IP;
+            ip_off = 0;
+            break;
+        default:
+            /* no support for current pkt_encap */
+            return;
+    }
+
+    if (etype == ETHERTYPE_IP) {
+        uint32_t ihl;
+
+        if (len < ip_off + 20 || (fd[ip_off] >> 4) != 4)
+            return;
+        ihl = (fd[ip_off] & 0x0f) * 4;
+        if (ihl < 20)
+            return;
+        fd[ip_off + 8] = 0;         /* TTL */
+        fd[ip_off + 10] = 0;        /* header checksum */
+        fd[ip_off + 11] = 0;
+        /* Only the first fragment has the transport header. */
+        if ((pntohu16(fd + ip_off + 6) & 0x1fff) != 0)
+            return;
+        l4_proto = fd[ip_off + 9];
+        l4_off = ip_off + ihl;
+    } else if (etype == ETHERTYPE_IPv6) {
+        if (len < ip_off + 40 || (fd[ip_off] >> 4) != 6)
+            return;
+        fd[ip_off + 7] = 0;         /* hop limit */
+        /* Extension headers aren't followed. */
+        l4_proto = fd[ip_off + 6];
+        l4_off = ip_off + 40;
+    } else {
+        return;
+    }
+
+    switch (l4_proto) {
+        case 6:     /* TCP */
+            if (len >= l4_off + 18) {
+                fd[l4_off + 16] = 0;
+                fd[l4_off + 17] = 0;
+            }
+            break;
+        case 17:    /* UDP */
+            if (len >= l4_off + 8) {
+                fd[l4_off + 6] = 0;
+                fd[l4_off + 7] = 0;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/*
+ * Compute the digest of the current frame into fd_hash[cur_dup_entry],
+ * skipping the bytes requested with -I or --skip-radiotap-header.
+ */
+static void
+dup_digest(wtap_rec *rec, bool use_radiotap)
+{
     uint8_t* fd = ws_buffer_start_ptr(&rec->data);
     uint32_t len = rec->rec_header.packet_header.caplen;
     const struct ieee80211_radiotap_header* tap_header;
@@ -683,152 +828,149 @@ is_duplicate(wtap_rec *rec) {
     }
 
     /* Get the size of radiotap header and use that as offset (-p option) */
-    if (skip_radiotap == true) {
+    if (use_radiotap && skip_radiotap == true) {
         tap_header = (const struct ieee80211_radiotap_header*)fd;
         offset = pletohu16(&tap_header->it_len);
         if (offset >= len)
             offset = 0;
     }
 
+    if (dup_ignore_mutable) {
+        /* Don't change the frame we're going to write; work on a copy. */
+        if (len > dup_scratch_size) {
+            dup_scratch = (uint8_t *)g_realloc(dup_scratch, len);
+            dup_scratch_size = len;
+        }
+        memcpy(dup_scratch, fd, len);
+        mask_mutable_fields(dup_scratch, len, rec->rec_header.packet_header.pkt_encap);
+        fd = dup_scratch;
+    }
+
     new_fd  = &fd[offset];
     new_len = len - (offset);
 
+    /*
+     * Calculate our digest. With -V the digests are printed, and scripts
+     * compare them across files and editcap builds, so those are always
+     * MD5. Otherwise they're only compared with each other, so use the
+     * much faster XXH3 if we have it.
+     */
+#ifdef HAVE_XXHASH
+    if (!verbose) {
+        XXH128_canonical_t canonical;
+
+        XXH128_canonicalFromHash(&canonical, XXH3_128bits(new_fd, new_len));
+        memcpy(fd_hash[cur_dup_entry].digest, canonical.digest, 16);
+    } else
+#endif
+    {
+        gcry_md_hash_buffer(GCRY_MD_MD5, fd_hash[cur_dup_entry].digest, new_fd, new_len);
+    }
+
+    fd_hash[cur_dup_entry].len = len;
+}
+
+/*
+ * Move on to the next fd_hash[] slot, dropping the frame that was
+ * in it from the window.
+ */
+static void
+dup_advance(void)
+{
+    dup_entry_t *entry;
+
     cur_dup_entry++;
     if (cur_dup_entry >= dup_window)
         cur_dup_entry = 0;
 
-    /* Calculate our digest */
-    gcry_md_hash_buffer(GCRY_MD_MD5, fd_hash[cur_dup_entry].digest, new_fd, new_len);
+    entry = fd_hash[cur_dup_entry].entry;
+    if (entry != NULL) {
+        if (--entry->count == 0)
+            g_hash_table_remove(dup_set, entry);
+        fd_hash[cur_dup_entry].entry = NULL;
+    }
+}
 
-    fd_hash[cur_dup_entry].len = len;
+/*
+ * Add the digest in fd_hash[cur_dup_entry] to the window. Returns the
+ * set entry for it; a count above one means an earlier frame in the
+ * window has the same digest.
+ */
+static dup_entry_t *
+dup_insert(void)
+{
+    dup_entry_t key;
+    dup_entry_t *entry;
 
-    /* Look for duplicates */
-    for (unsigned i = 0; i < dup_window; i++) {
-        if (i == cur_dup_entry)
-            continue;
+    memcpy(key.digest, fd_hash[cur_dup_entry].digest, 16);
+    key.len = fd_hash[cur_dup_entry].len;
 
-        if (fd_hash[i].len == fd_hash[cur_dup_entry].len
-            && memcmp(fd_hash[i].digest, fd_hash[cur_dup_entry].digest, 16) == 0) {
-            return true;
-        }
+    entry = (dup_entry_t *)g_hash_table_lookup(dup_set, &key);
+    if (entry == NULL) {
+        entry = g_new(dup_entry_t, 1);
+        memcpy(entry->digest, key.digest, 16);
+        entry->len = key.len;
+        entry->count = 0;
+        nstime_set_unset(&entry->last_time);
+        g_hash_table_add(dup_set, entry);
     }
+    entry->count++;
+    fd_hash[cur_dup_entry].entry = entry;
 
-    return false;
+    return entry;
 }
 
 static bool
-is_duplicate_rel_time(wtap_rec *rec, const nstime_t *current) {
-    uint8_t* fd = ws_buffer_start_ptr(&rec->data);
-    uint32_t len = rec->rec_header.packet_header.caplen;
-    int i;
+is_duplicate(wtap_rec *rec) {
+    dup_entry_t *entry;
 
-    /*Hint to ignore some bytes at the start of the frame for the digest calculation(-I option) */
-    uint32_t offset = ignored_bytes;
-    uint32_t new_len;
-    uint8_t *new_fd;
+    dup_advance();
+    dup_digest(rec, true);
 
-    if (len <= ignored_bytes) {
-        offset = 0;
-    }
+    /*
+     * With a window of 0 or 1 there's no other slot to compare against;
+     * the one we just evicted is the one we're reusing.
+     */
+    entry = dup_insert();
 
-    new_fd  = &fd[offset];
-    new_len = len - (offset);
+    return entry->count > 1;
+}
 
-    cur_dup_entry++;
-    if (cur_dup_entry >= dup_window)
-        cur_dup_entry = 0;
+static bool
+is_duplicate_rel_time(wtap_rec *rec, const nstime_t *current) {
+    dup_entry_t *entry;
+    nstime_t delta;
+    bool dup = false;
 
-    /* Calculate our digest */
-    gcry_md_hash_buffer(GCRY_MD_MD5, fd_hash[cur_dup_entry].digest, new_fd, new_len);
+    dup_advance();
+    dup_digest(rec, false);
 
-    fd_hash[cur_dup_entry].len = len;
     fd_hash[cur_dup_entry].frame_time.secs = current->secs;
     fd_hash[cur_dup_entry].frame_time.nsecs = current->nsecs;
 
+    entry = dup_insert();
+
     /*
-     * Look for relative time related duplicates.
-     * This is hopefully a reasonably efficient mechanism for
-     * finding duplicates by rel time in the fd_hash[] cache.
-     * We check starting from the most recently added hash
-     * entries and work backwards towards older packets.
-     * This approach allows the dup test to be terminated
-     * when the relative time of a cached entry is found to
-     * be beyond the dup time window.
+     * Compare against the most recent earlier frame with the same
+     * digest. As before, this assumes that the input trace file is
+     * "well-formed" in the sense that the packet timestamps are in
+     * chronologically increasing order (which is NOT always the case!!).
      *
-     * Of course this assumes that the input trace file is
-     * "well-formed" in the sense that the packet timestamps are
-     * in strict chronologically increasing order (which is NOT
-     * always the case!!).
-     *
-     * The fd_hash[] table was deliberately created large (1,000,000).
-     * Looking for time related duplicates in large trace files with
-     * non-fractional dup time window values can potentially take
-     * a long time to complete.
+     * A negative delta implies that the current packet has an absolute
+     * timestamp less than the cached packet. That's not a duplicate by
+     * time, and the cached packet stays the one later packets are
+     * compared against.
      */
-
-    for (i = cur_dup_entry - 1;; i--) {
-        nstime_t delta;
-        int cmp;
-
-        if (i < 0)
-            i = dup_window - 1;
-
-        if (i == (int)cur_dup_entry) {
-            /*
-             * We've decremented back to where we started.
-             * Check no more!
-             */
-            break;
-        }
-
-        if (nstime_is_unset(&(fd_hash[i].frame_time))) {
-            /*
-             * We've decremented to an unused fd_hash[] entry.
-             * Check no more!
-             */
-            break;
-        }
-
-        nstime_delta(&delta, current, &fd_hash[i].frame_time);
-
+    if (entry->count > 1 && !nstime_is_unset(&entry->last_time)) {
+        nstime_delta(&delta, current, &entry->last_time);
         if (delta.secs < 0 || delta.nsecs < 0) {
-            /*
-             * A negative delta implies that the current packet
-             * has an absolute timestamp less than the cached packet
-             * that it is being compared to.  This is NOT a normal
-             * situation since trace files usually have packets in
-             * chronological order (oldest to newest).
-             *
-             * There are several possible ways to deal with this:
-             * 1. 'continue' dup checking with the next cached frame.
-             * 2. 'break' from looking for a duplicate of the current frame.
-             * 3. Take the absolute value of the delta and see if that
-             * falls within the specified dup time window.
-             *
-             * Currently this code does option 1.  But it would pretty
-             * easy to add yet-another-editcap-option to select one of
-             * the other behaviors for dealing with out-of-sequence
-             * packets.
-             */
-            continue;
-        }
-
-        cmp = nstime_cmp(&delta, &relative_time_window);
-
-        if (cmp > 0) {
-            /*
-             * The delta time indicates that we are now looking at
-             * cached packets beyond the specified dup time window.
-             * Check no more!
-             */
-            break;
-        } else if (fd_hash[i].len == fd_hash[cur_dup_entry].len
-                   && memcmp(fd_hash[i].digest, fd_hash[cur_dup_entry].digest, 16) == 0) {
-            return true;
+            return false;
         }
+        dup = nstime_cmp(&delta, &relative_time_window) <= 0;
     }
+    entry->last_time = *current;
 
-    return false;
+    return dup;
 }
 
 static void
@@ -1109,6 +1251,9 @@ print_usage(FILE *output)
     fprintf(output, "  --skip-radiotap-header skip radiotap header when checking for packet duplicates.\n");
     fprintf(output, "                         Useful when processing packets captured by multiple radios\n");
     fprintf(output, "                         on the same channel in the vicinity of each other.\n");
+    fprintf(output, "  --dup-ignore-mutable   ignore the IPv4 TTL and header checksum, the IPv6 hop\n");
+    fprintf(output, "                         limit and TCP/UDP checksums when checking for packet\n");
+    fprintf(output, "                         duplicates.\n");
     fprintf(output, "  --set-unused           set unused byts to zero in sll link addr.\n");
     fprintf(output, "\n");
     fprintf(output, "Packet manipulation:\n");
@@ -1565,10 +1710,12 @@ main(int argc, char *argv[])
 #define LONGOPT_COMPRESS                 LONGOPT_BASE_APPLICATION+12
 #define LONGOPT_SCTP_SPLIT               LONGOPT_BASE_APPLICATION+13
 #define LONGOPT_DISCARD_NAME_RESOLUTION  LONGOPT_BASE_APPLICATION+14
+#define LONGOPT_DUP_IGNORE_MUTABLE       LONGOPT_BASE_APPLICATION+15
 
     static const struct ws_option long_options[] = {
         {"novlan", ws_no_argument, NULL, LONGOPT_NO_VLAN},
         {"skip-radiotap-header", ws_no_argument, NULL, LONGOPT_SKIP_RADIOTAP_HEADER},
+        {"dup-ignore-mutable", ws_no_argument, NULL, LONGOPT_DUP_IGNORE_MUTABLE},
         {"seed", ws_required_argument, NULL, LONGOPT_SEED},
         {"inject-secrets", ws_required_argument, NULL, LONGOPT_INJECT_SECRETS},
         {"discard-all-secrets", ws_no_argument, NULL, LONGOPT_DISCARD_ALL_SECRETS},
@@ -1599,7 +1746,11 @@ main(int argc, char *argv[])
     uint64_t      count              = 1;
     uint64_t      duplicate_count    = 0;
     int64_t       data_offset;
+    bool          have_rec;
     uint64_t      read_count         = 0;
+    uint64_t      skip_count         = 0;
+    bool          skip_to_starttime  = false;
+    bool          stop_at_stoptime   = false;
     uint64_t      split_packet_count = 0;
     uint64_t      written_count      = 0;
     char         *filename           = NULL;
@@ -1614,6 +1765,7 @@ main(int argc, char *argv[])
     GArray       *dsb_types          = NULL;
     GPtrArray    *dsb_filenames      = NULL;
     wtap_rec                     read_rec;
+    wtap_packet_index_t         *pkt_index = NULL;
     wtap_dump_params             params = WTAP_DUMP_PARAMS_INIT;
     char                        *shb_user_appl;
     int                          ret = EXIT_SUCCESS;
@@ -1686,6 +1838,12 @@ main(int argc, char *argv[])
             break;
         }
 
+        case LONGOPT_DUP_IGNORE_MUTABLE:
+        {
+            dup_ignore_mutable = true;
+            break;
+        }
+
         case LONGOPT_SEED:
         {
             if (sscanf(ws_optarg, "%u", &seed) != 1) {
@@ -2213,7 +2371,22 @@ main(int argc, char *argv[])
         goto clean_exit;
     }
 
-    wth = wtap_open_offline(argv[ws_optind], WTAP_TYPE_AUTO, &read_err, &read_err_info, false, application_configuration_environment_prefix());
+    /*
+     * If we're only keeping packets after a given time, open the file
+     * for random access too, if we can, so that we can skip the data of
+     * the packets before that time; see below.
+     */
+    if (have_starttime) {
+        wth = wtap_open_offline(argv[ws_optind], WTAP_TYPE_AUTO, &read_err, &read_err_info, true, application_configuration_environment_prefix());
+        if (!wth && read_err != WTAP_ERR_RANDOM_OPEN_PIPE &&
+            read_err != WTAP_ERR_RANDOM_OPEN_STDIN) {
+            report_cfile_open_failure(argv[ws_optind], read_err, read_err_info);
+            ret = WS_EXIT_INVALID_FILE;
+            goto clean_exit;
+        }
+    }
+    if (!wth)
+        wth = wtap_open_offline(argv[ws_optind], WTAP_TYPE_AUTO, &read_err, &read_err_info, false, application_configuration_environment_prefix());
 
     if (!wth) {
         report_cfile_open_failure(argv[ws_optind], read_err, read_err_info);
@@ -2365,6 +2538,10 @@ main(int argc, char *argv[])
     if (snaplen != 0 && snaplen < wtap_snapshot_length(wth))
         params.snaplen = snaplen;
 
+    /* We only ever write records in order; let wiretap batch them up. */
+    params.buffered = true;
+    params.async_flush = true;
+
     /*
      * Now process the arguments following the input and output file
      * names, if any; they specify packets to include/exclude.
@@ -2382,12 +2559,48 @@ main(int argc, char *argv[])
     if (!keep_em)
         max_packet_number = UINT64_MAX;
 
+    /*
+     * Packets before the first one we're keeping, or before the start
+     * of the time range, can't be selected, so we can skip them rather
+     * than read them. A packet index, if there is one, lets us skip
+     * them without reading them at all, and, if it says the packets are
+     * in time order, stop at the end of the time range.
+     *
+     * When splitting by time, the packets we skip would still determine
+     * the boundaries of the output files, so read everything.
+     */
+    if (nstime_is_unset(&secs_per_block)) {
+        if (keep_em) {
+            skip_count = UINT64_MAX;
+            for (unsigned u = 0; u < max_selected; u++) {
+                if (selectfrm[u].first > 0 && selectfrm[u].first - 1 < skip_count)
+                    skip_count = selectfrm[u].first - 1;
+            }
+            if (skip_count == UINT64_MAX)
+                skip_count = 0;
+        }
+        if (skip_count == 0 && have_starttime)
+            skip_to_starttime = true;
+        if ((skip_count != 0 || check_startstop) &&
+            strcmp(argv[ws_optind], "-") != 0) {
+            pkt_index = wtap_packet_index_open(argv[ws_optind]);
+            if (pkt_index != NULL) {
+                if (verbose)
+                    fprintf(stderr, "Using packet index for %s.\n", argv[ws_optind]);
+                stop_at_stoptime = have_stoptime &&
+                    wtap_packet_index_is_time_ordered(pkt_index);
+            }
+        }
+    }
+
     if (dup_detect || dup_detect_by_time) {
         for (unsigned u = 0; u < dup_window; u++) {
             memset(&fd_hash[u].digest, 0, 16);
             fd_hash[u].len = 0;
             nstime_set_unset(&fd_hash[u].frame_time);
+            fd_hash[u].entry = NULL;
         }
+        dup_set = g_hash_table_new_full(dup_entry_hash, dup_entry_equal, g_free, NULL);
     }
 
     /* Set up an array of all IDBs seen */
@@ -2395,7 +2608,22 @@ main(int argc, char *argv[])
 
     /* Read all of the packets in turn */
     wtap_rec_init(&read_rec, DEFAULT_INIT_BUFFER_SIZE_2048);
-    while (wtap_read(wth, &read_rec, &read_err, &read_err_info, &data_offset)) {
+    if (skip_count != 0) {
+        have_rec = wtap_read_from_record(wth, skip_count, pkt_index,
+                                         &read_rec, &read_err, &read_err_info,
+                                         &data_offset);
+        read_count = skip_count;
+        count = read_count + 1;
+    } else if (skip_to_starttime) {
+        have_rec = wtap_read_from_time(wth, &starttime, pkt_index,
+                                       &read_rec, &read_err, &read_err_info,
+                                       &data_offset, &read_count);
+        count = read_count + 1;
+    } else {
+        have_rec = wtap_read(wth, &read_rec, &read_err, &read_err_info, &data_offset);
+    }
+    for (; have_rec;
+         have_rec = wtap_read(wth, &read_rec, &read_err, &read_err_info, &data_offset)) {
         /*
          * XXX - what about non-packet records in the file after this?
          * NRBs, DSBs, and ISBs are now written when wtap_dump_close() calls
@@ -2405,10 +2633,14 @@ main(int argc, char *argv[])
         if (max_packet_number <= read_count)
             break;
 
+        if (stop_at_stoptime && (read_rec.presence_flags & WTAP_HAS_TS) &&
+            nstime_cmp(&read_rec.ts, &stoptime) >= 0)
+            break;
+
         read_count++;
 
         /* Extra actions for the first packet */
-        if (read_count == 1) {
+        if (pdh == NULL) {
             if (split_packet_count != 0 || !nstime_is_unset(&secs_per_block)) {
                 filename = fileset_get_filename_by_pattern(block_cnt++,
                                                            (read_rec.presence_flags & WTAP_HAS_TS) ? &read_rec.ts : NULL,
@@ -2920,6 +3152,10 @@ main(int argc, char *argv[])
 
 clean_exit:
     g_free(fprefix);
+    g_free(dup_scratch);
+    if (dup_set) {
+        g_hash_table_destroy(dup_set);
+    }
     g_free(fsuffix);
 
     if (filename) {
@@ -2944,6 +3180,7 @@ clean_exit:
     }
     g_free(params.idb_inf);
     wtap_dump_params_cleanup(&params);
+    wtap_packet_index_close(pkt_index);
     if (wth != NULL)
         wtap_close(wth);
     wtap_rec_cleanup(&read_rec);
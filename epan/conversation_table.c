@@ -287,6 +287,9 @@ reset_conversation_table_data(conv_hash_t *ch)
 
     ch->conv_array=NULL;
     ch->hashtable=NULL;
+    if (ch->modified_rows != NULL) {
+        g_array_set_size(ch->modified_rows, 0);
+    }
 }
 
 void reset_endpoint_table_data(conv_hash_t *ch)
@@ -311,6 +314,56 @@ void reset_endpoint_table_data(conv_hash_t *ch)
 
     ch->conv_array=NULL;
     ch->hashtable=NULL;
+    if (ch->modified_rows != NULL) {
+        g_array_set_size(ch->modified_rows, 0);
+    }
+}
+
+void
+conversation_table_track_modified(conv_hash_t *ch, bool track)
+{
+    if (track) {
+        if (ch->modified_rows == NULL) {
+            ch->modified_rows = g_array_new(false, false, sizeof(unsigned));
+        }
+    } else if (ch->modified_rows != NULL) {
+        g_array_free(ch->modified_rows, true);
+        ch->modified_rows = NULL;
+    }
+}
+
+GArray *
+conversation_table_take_modified(conv_hash_t *ch)
+{
+    GArray *modified_rows = ch->modified_rows;
+
+    if (modified_rows == NULL) {
+        return NULL;
+    }
+
+    for (unsigned i = 0; i < modified_rows->len; i++) {
+        unsigned idx = g_array_index(modified_rows, unsigned, i);
+        g_array_index(ch->conv_array, conv_item_t, idx).modified = false;
+    }
+    ch->modified_rows = g_array_new(false, false, sizeof(unsigned));
+    return modified_rows;
+}
+
+GArray *
+endpoint_table_take_modified(conv_hash_t *ch)
+{
+    GArray *modified_rows = ch->modified_rows;
+
+    if (modified_rows == NULL) {
+        return NULL;
+    }
+
+    for (unsigned i = 0; i < modified_rows->len; i++) {
+        unsigned idx = g_array_index(modified_rows, unsigned, i);
+        g_array_index(ch->conv_array, endpoint_item_t, idx).modified = false;
+    }
+    ch->modified_rows = g_array_new(false, false, sizeof(unsigned));
+    return modified_rows;
 }
 
 char *get_conversation_address(wmem_allocator_t *allocator, address *addr, bool resolve_names)
@@ -711,6 +764,7 @@ add_conversation_table_data_with_conv_id(
         new_conv_item.tx_frames_total = 0;
         new_conv_item.rx_bytes_total = 0;
         new_conv_item.tx_bytes_total = 0;
+        new_conv_item.modified = false;
 
         if (ts) {
             memcpy(&new_conv_item.start_time, ts, sizeof(new_conv_item.start_time));
@@ -767,6 +821,12 @@ add_conversation_table_data_with_conv_id(
         }
     }
 
+    if (ch->modified_rows != NULL && !conv_item->modified) {
+        unsigned conversation_idx = (unsigned)(conv_item - (conv_item_t *)(void *)ch->conv_array->data);
+        g_array_append_val(ch->modified_rows, conversation_idx);
+        conv_item->modified = true;
+    }
+
     if (ts) {
         if (nstime_cmp(ts, &conv_item->stop_time) > 0) {
             memcpy(&conv_item->stop_time, ts, sizeof(conv_item->stop_time));
@@ -963,7 +1023,7 @@ add_endpoint_table_data(conv_hash_t *ch, const address *addr, uint32_t port, boo
         new_endpoint_item.tx_frames_total=0;
         new_endpoint_item.rx_bytes_total=0;
         new_endpoint_item.tx_bytes_total=0;
-        new_endpoint_item.modified = true;
+        new_endpoint_item.modified = false;
         new_endpoint_item.filtered = true;
 
         g_array_append_val(ch->conv_array, new_endpoint_item);
@@ -977,8 +1037,11 @@ add_endpoint_table_data(conv_hash_t *ch, const address *addr, uint32_t port, boo
         g_hash_table_insert(ch->hashtable, new_key, GUINT_TO_POINTER(endpoint_idx));
     }
 
-    /* if this is a new endpoint we need to initialize the struct */
-    endpoint_item->modified = true;
+    if (ch->modified_rows != NULL && !endpoint_item->modified) {
+        unsigned endpoint_idx = (unsigned)(endpoint_item - (endpoint_item_t *)(void *)ch->conv_array->data);
+        g_array_append_val(ch->modified_rows, endpoint_idx);
+        endpoint_item->modified = true;
+    }
 
     /* update the endpoint struct */
     if (! (ch->flags & TL_DISPLAY_FILTER_IGNORED)) {
@@ -77,6 +77,7 @@ typedef struct _conversation_hash_t {
     GArray      *conv_array;      /**< array of conversation values */
     void        *user_data;       /**< "GUI" specifics (if necessary) */
     unsigned    flags;            /**< flags given to the tap packet */
+    GArray      *modified_rows;   /**< indexes of modified conv_array entries, if tracked */
 } conv_hash_t;
 
 /**
@@ -169,6 +170,7 @@ typedef struct _conversation_item_t {
     nstime_t            stop_time;      /**< relative stop time for the conversation */
     nstime_t            start_abs_time; /**< absolute start time for the conversation */
 
+    bool modified;                  /**< need to redraw the row */
     bool filtered;                  /**< the entry contains only filtered data */
 
     conv_extension_tcp_t ext_tcp;      /**< extension for optional TCP counters */
@@ -298,6 +300,43 @@ WS_DLL_PUBLIC void reset_conversation_table_data(conv_hash_t *ch);
  */
 WS_DLL_PUBLIC void reset_endpoint_table_data(conv_hash_t *ch);
 
+/**
+ * @brief Start or stop recording which rows of a table are modified.
+ *
+ * While tracking, the index of each entry that is added or updated is
+ * appended once to ch->modified_rows, so that a GUI can redraw just those
+ * rows instead of the whole table. Resetting the table clears the list
+ * but keeps tracking.
+ *
+ * @param ch the conversation or endpoint table
+ * @param track true to start tracking, false to stop and free the list
+ */
+WS_DLL_PUBLIC void conversation_table_track_modified(conv_hash_t *ch, bool track);
+
+/**
+ * @brief Take the list of conversations modified since the last call.
+ *
+ * Clears the modified flag of each of the returned entries.
+ *
+ * @param ch the table, on which conversation_table_track_modified() was called
+ * @return a GArray of unsigned conv_array indexes in the order in which the
+ * entries were first modified, or NULL if modified rows aren't tracked.
+ * Free it with g_array_free(array, true).
+ */
+WS_DLL_PUBLIC GArray *conversation_table_take_modified(conv_hash_t *ch);
+
+/**
+ * @brief Take the list of endpoints modified since the last call.
+ *
+ * Clears the modified flag of each of the returned entries.
+ *
+ * @param ch the table, on which conversation_table_track_modified() was called
+ * @return a GArray of unsigned conv_array indexes in the order in which the
+ * entries were first modified, or NULL if modified rows aren't tracked.
+ * Free it with g_array_free(array, true).
+ */
+WS_DLL_PUBLIC GArray *endpoint_table_take_modified(conv_hash_t *ch);
+
 /**
  * @brief Initialize dissector conversation for stats and (possibly) GUI.
  *
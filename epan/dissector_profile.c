@@ -0,0 +1,234 @@
+/* dissector_profile.c
+ * Routines for profiling the time and memory spent in individual
+ * dissectors.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+#define WS_LOG_DOMAIN LOG_DOMAIN_EPAN
+
+#include <glib.h>
+
+#include <wsutil/time_util.h>
+#include <wsutil/wmem/wmem.h>
+
+#include <epan/wmem_scopes.h>
+
+#include "dissector_profile.h"
+
+bool dissector_profiling;
+
+/*
+ * One entry per dissector currently on the call stack.
+ */
+typedef struct {
+    dissector_profile_stat_t *stat;
+    uint64_t start_ns;
+    uint64_t start_alloc;
+    uint64_t child_ns;          /* inclusive time of direct children */
+    uint64_t child_alloc;       /* inclusive allocations of direct children */
+} profile_frame_t;
+
+/* proto_id -> dissector_profile_stat_t */
+static GHashTable *profile_stats;
+
+static GArray *profile_frames;
+
+static inline uint64_t
+profile_alloc_now(packet_info *pinfo)
+{
+    return wmem_bytes_requested(pinfo->pool) +
+           wmem_bytes_requested(wmem_file_scope());
+}
+
+static dissector_profile_stat_t *
+profile_stat_lookup(int proto_id)
+{
+    dissector_profile_stat_t *stat;
+
+    if (profile_stats == NULL) {
+        profile_stats = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+                                              NULL, g_free);
+    }
+
+    stat = (dissector_profile_stat_t *)g_hash_table_lookup(profile_stats, GINT_TO_POINTER(proto_id));
+    if (stat == NULL) {
+        stat = g_new0(dissector_profile_stat_t, 1);
+        stat->proto_id = proto_id;
+        g_hash_table_insert(profile_stats, GINT_TO_POINTER(proto_id), stat);
+    }
+    return stat;
+}
+
+void
+dissector_profile_enable(bool enable)
+{
+    dissector_profiling = enable;
+    wmem_count_bytes_requested(enable);
+}
+
+bool
+dissector_profile_is_enabled(void)
+{
+    return dissector_profiling;
+}
+
+void
+dissector_profile_reset(void)
+{
+    if (profile_stats != NULL) {
+        g_hash_table_remove_all(profile_stats);
+    }
+    /*
+     * Any frames still on the stack point into the table we just emptied.
+     * This is only called between packets, so there shouldn't be any.
+     */
+    if (profile_frames != NULL) {
+        g_array_set_size(profile_frames, 0);
+    }
+}
+
+static int
+profile_stat_compare(const void *a, const void *b)
+{
+    const dissector_profile_stat_t *sa = (const dissector_profile_stat_t *)a;
+    const dissector_profile_stat_t *sb = (const dissector_profile_stat_t *)b;
+
+    if (sa->exclusive_ns != sb->exclusive_ns)
+        return sa->exclusive_ns < sb->exclusive_ns ? 1 : -1;
+    if (sa->calls != sb->calls)
+        return sa->calls < sb->calls ? 1 : -1;
+    return sa->proto_id - sb->proto_id;
+}
+
+GArray *
+dissector_profile_get_stats(void)
+{
+    GArray *stats;
+    GHashTableIter iter;
+    void *value;
+
+    if (profile_stats == NULL)
+        return g_array_new(false, false, sizeof(dissector_profile_stat_t));
+
+    stats = g_array_sized_new(false, false, sizeof(dissector_profile_stat_t),
+                              g_hash_table_size(profile_stats));
+    g_hash_table_iter_init(&iter, profile_stats);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        g_array_append_vals(stats, value, 1);
+    }
+    g_array_sort(stats, profile_stat_compare);
+
+    return stats;
+}
+
+void
+dissector_profile_enter(dissector_profile_call_t *call, packet_info *pinfo, int proto_id)
+{
+    profile_frame_t frame;
+
+    if (profile_frames == NULL) {
+        profile_frames = g_array_sized_new(false, false, sizeof(profile_frame_t), 32);
+    }
+
+    frame.stat = profile_stat_lookup(proto_id);
+    frame.stat->calls++;
+    frame.child_ns = 0;
+    frame.child_alloc = 0;
+    frame.start_alloc = profile_alloc_now(pinfo);
+    /* Read the clock last so that our own bookkeeping isn't counted. */
+    frame.start_ns = ws_clock_get_monotonic_ns();
+
+    call->pinfo = pinfo;
+    call->depth = profile_frames->len;
+    g_array_append_val(profile_frames, frame);
+}
+
+void
+dissector_profile_leave(void *call_ptr)
+{
+    dissector_profile_call_t *call = (dissector_profile_call_t *)call_ptr;
+    uint64_t now_ns = ws_clock_get_monotonic_ns();
+    uint64_t now_alloc;
+
+    if (profile_frames == NULL || call->depth >= profile_frames->len) {
+        /* Profiling was reset while this dissector ran. */
+        return;
+    }
+
+    now_alloc = profile_alloc_now(call->pinfo);
+
+    /*
+     * Close frames from the top down to ours. Callers unwind their frames
+     * when an exception passes through them, so normally there is only
+     * ours; any others were pushed by code that didn't.
+     */
+    while (profile_frames->len > call->depth) {
+        unsigned idx = profile_frames->len - 1;
+        profile_frame_t *frame = &g_array_index(profile_frames, profile_frame_t, idx);
+        uint64_t elapsed = now_ns - frame->start_ns;
+        uint64_t alloc = now_alloc - frame->start_alloc;
+        bool recursive = false;
+
+        for (unsigned i = 0; i < idx; i++) {
+            if (g_array_index(profile_frames, profile_frame_t, i).stat == frame->stat) {
+                recursive = true;
+                break;
+            }
+        }
+        if (!recursive) {
+            frame->stat->inclusive_ns += elapsed;
+        }
+        frame->stat->exclusive_ns += elapsed - MIN(frame->child_ns, elapsed);
+        frame->stat->alloc_bytes += alloc - MIN(frame->child_alloc, alloc);
+
+        if (idx > 0) {
+            profile_frame_t *parent = &g_array_index(profile_frames, profile_frame_t, idx - 1);
+            parent->child_ns += elapsed;
+            parent->child_alloc += alloc;
+        }
+        g_array_set_size(profile_frames, idx);
+    }
+}
+
+void
+dissector_profile_heur_result(int proto_id, bool accepted)
+{
+    dissector_profile_stat_t *stat = profile_stat_lookup(proto_id);
+
+    stat->heur_attempts++;
+    if (accepted)
+        stat->heur_hits++;
+}
+
+void
+dissector_profile_cleanup(void)
+{
+    if (profile_stats != NULL) {
+        g_hash_table_destroy(profile_stats);
+        profile_stats = NULL;
+    }
+    if (profile_frames != NULL) {
+        g_array_free(profile_frames, true);
+        profile_frames = NULL;
+    }
+    dissector_profiling = false;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
@@ -0,0 +1,143 @@
+/** @file
+ * Declarations of routines for profiling the time and memory spent in
+ * individual dissectors.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#include <glib.h>
+
+#include <ws_symbol_export.h>
+
+#include <epan/packet_info.h>
+
+/**
+ * @brief Accumulated profile of a single protocol's dissector(s).
+ *
+ * "Inclusive" figures cover everything that happened while the dissector
+ * was on the stack, including the subdissectors it called. "Exclusive"
+ * figures subtract the subdissectors, which is usually what you want when
+ * looking for the dissector that is slowing things down. Recursive calls
+ * (e.g. tunnels) are only counted once towards the inclusive time.
+ */
+typedef struct {
+    int      proto_id;          /**< Protocol the dissector belongs to. */
+    uint64_t calls;             /**< Number of times a dissector was called, including heuristic attempts. */
+    uint64_t inclusive_ns;      /**< Wall clock time including subdissectors, in nanoseconds. */
+    uint64_t exclusive_ns;      /**< Wall clock time excluding subdissectors, in nanoseconds. */
+    uint64_t heur_attempts;     /**< Number of times a heuristic dissector was tried. */
+    uint64_t heur_hits;         /**< Number of those attempts that accepted the packet. */
+    uint64_t alloc_bytes;       /**< Bytes requested from the packet and file scopes, excluding subdissectors. */
+} dissector_profile_stat_t;
+
+/**
+ * @brief Turn dissector profiling on or off.
+ *
+ * Profiling adds a clock read on every dissector call, so it is off by
+ * default. It can also be turned on by setting the
+ * WIRESHARK_DISSECTOR_PROFILE environment variable before epan_init().
+ * Counters are kept when profiling is turned off; use
+ * dissector_profile_reset() to clear them.
+ *
+ * @param enable true to start collecting, false to stop.
+ */
+WS_DLL_PUBLIC void
+dissector_profile_enable(bool enable);
+
+/**
+ * @brief Check whether dissector profiling is turned on.
+ *
+ * @return true if dissector calls are being profiled.
+ */
+WS_DLL_PUBLIC bool
+dissector_profile_is_enabled(void);
+
+/**
+ * @brief Clear all accumulated profiling counters.
+ */
+WS_DLL_PUBLIC void
+dissector_profile_reset(void);
+
+/**
+ * @brief Get a snapshot of the accumulated profile.
+ *
+ * @return A newly allocated array of dissector_profile_stat_t, one per
+ * protocol that was called at least once, sorted by descending exclusive
+ * time. Free it with g_array_free(array, true).
+ */
+WS_DLL_PUBLIC GArray *
+dissector_profile_get_stats(void);
+
+/*
+ * The rest is used by packet.c to record dissector calls and is not
+ * part of the public API.
+ */
+
+/** Set while profiling is enabled; checked before calling the functions below. */
+extern bool dissector_profiling;
+
+/** A dissector call being profiled. */
+typedef struct {
+    packet_info *pinfo;         /**< The packet being dissected. */
+    unsigned     depth;         /**< Profiler stack depth before the call. */
+} dissector_profile_call_t;
+
+/**
+ * Record that a dissector for proto_id is about to be called.
+ * Fills in call, to be passed to dissector_profile_leave().
+ */
+extern void
+dissector_profile_enter(dissector_profile_call_t *call, packet_info *pinfo, int proto_id);
+
+/**
+ * Record that the dissector call returned or was unwound by an exception.
+ * The argument is a dissector_profile_call_t *, so that this can be used
+ * as a CLEANUP_PUSH() handler:
+ *
+ *     dissector_profile_enter(&call, pinfo, proto_id);
+ *     CLEANUP_PUSH(dissector_profile_leave, &call);
+ *     ...call the dissector...
+ *     CLEANUP_CALL_AND_POP;
+ *
+ * Any frames above the call's that are still open are closed as well.
+ */
+extern void
+dissector_profile_leave(void *call);
+
+/**
+ * Record that a heuristic dissector for proto_id was tried, and whether
+ * it accepted the packet.
+ */
+extern void
+dissector_profile_heur_result(int proto_id, bool accepted);
+
+/**
+ * Free all profiler state. Called from epan_cleanup().
+ */
+extern void
+dissector_profile_cleanup(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
@@ -3748,9 +3748,12 @@ process_header(tvbuff_t *tvb, unsigned offset, unsigned next_offset,
 				}
 
 			} else {
-				hdr_item = proto_tree_add_string_format(tree,
-					*hf_id, tvb, offset, len, value,
-					"%s", format_text(pinfo->pool, (char*)line, len));
+				hdr_item = proto_tree_add_string(tree,
+					*hf_id, tvb, offset, len, value);
+				if (proto_item_wants_repr(hdr_item)) {
+					proto_item_set_text(hdr_item, "%s",
+							format_text(pinfo->pool, (char*)line, len));
+				}
 				if (http_type == MEDIA_CONTAINER_HTTP_REQUEST ||
 					http_type == MEDIA_CONTAINER_HTTP_RESPONSE) {
 					it = proto_tree_add_item(tree,
@@ -3759,8 +3762,10 @@ process_header(tvbuff_t *tvb, unsigned offset, unsigned next_offset,
 						hf_http_request_line,
 						tvb, offset, len,
 						ENC_NA|ENC_ASCII);
-					proto_item_set_text(it, "%s",
-							format_text(pinfo->pool, (char*)line, len));
+					if (proto_item_wants_repr(it)) {
+						proto_item_set_text(it, "%s",
+								format_text(pinfo->pool, (char*)line, len));
+					}
 					proto_item_set_hidden(it);
 				}
 			}
@@ -3802,10 +3807,13 @@ process_header(tvbuff_t *tvb, unsigned offset, unsigned next_offset,
 				}
 				break;
 			default:
-				hdr_item = proto_tree_add_string_format(tree,
+				hdr_item = proto_tree_add_string(tree,
 				    *headers[hf_index].hf, tvb, offset, len,
-				    value,
-				    "%s", format_text(pinfo->pool, (char*)line, len));
+				    value);
+				if (proto_item_wants_repr(hdr_item)) {
+					proto_item_set_text(hdr_item, "%s",
+							format_text(pinfo->pool, (char*)line, len));
+				}
 				if (http_type == MEDIA_CONTAINER_HTTP_REQUEST ||
 					http_type == MEDIA_CONTAINER_HTTP_RESPONSE) {
 					it = proto_tree_add_item(tree,
@@ -3814,8 +3822,10 @@ process_header(tvbuff_t *tvb, unsigned offset, unsigned next_offset,
 						hf_http_request_line,
 						tvb, offset, len,
 						ENC_NA|ENC_ASCII);
-					proto_item_set_text(it, "%s",
-							format_text(pinfo->pool, (char*)line, len));
+					if (proto_item_wants_repr(it)) {
+						proto_item_set_text(it, "%s",
+								format_text(pinfo->pool, (char*)line, len));
+					}
 					proto_item_set_hidden(it);
 				}
 			}
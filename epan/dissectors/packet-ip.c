@@ -2243,7 +2243,7 @@ dissect_ip_v4(tvbuff_t *tvb, packet_info *pinfo, proto_tree *parent_tree, void*
     const char *src_host;
 
     memcpy(&addr, iph->ip_src.data, 4);
-    if (ip_summary_in_tree) {
+    if (ip_summary_in_tree && proto_item_wants_repr(ti)) {
       proto_item_append_text(ti, ", Src: %s", address_with_resolution_to_str(pinfo->pool, &iph->ip_src));
     }
     proto_tree_add_ipv4(ip_tree, hf_ip_src, tvb, offset + 12, 4, addr);
@@ -2318,7 +2318,7 @@ dissect_ip_v4(tvbuff_t *tvb, packet_info *pinfo, proto_tree *parent_tree, void*
     const char *dst_host;
 
     memcpy(&addr, iph->ip_dst.data, 4);
-    if (ip_summary_in_tree) {
+    if (ip_summary_in_tree && proto_item_wants_repr(ti)) {
       proto_item_append_text(ti, ", Dst: %s", address_with_resolution_to_str(pinfo->pool, &iph->ip_dst));
     }
 
@@ -2326,7 +2326,7 @@ dissect_ip_v4(tvbuff_t *tvb, packet_info *pinfo, proto_tree *parent_tree, void*
       uint32_t cur_rt;
 
       cur_rt = tvb_get_ipv4(tvb, offset + 16);
-      if (ip_summary_in_tree) {
+      if (ip_summary_in_tree && proto_item_wants_repr(ti)) {
         proto_item_append_text(ti, ", Via: %s",
             tvb_address_with_resolution_to_str(pinfo->pool, tvb, AT_IPv4, offset + 16));
       }
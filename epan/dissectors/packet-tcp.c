@@ -8888,7 +8888,7 @@ dissect_tcp(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void* data _U_)
 
     if (tree) {
         ti = proto_tree_add_item(tree, proto_tcp, tvb, 0, -1, ENC_NA);
-        if (tcp_summary_in_tree) {
+        if (tcp_summary_in_tree && proto_item_wants_repr(ti)) {
             proto_item_append_text(ti, ", Src Port: %s, Dst Port: %s",
                     port_with_resolution_to_str(pinfo->pool, PT_TCP, tcph->th_sport),
                     port_with_resolution_to_str(pinfo->pool, PT_TCP, tcph->th_dport));
@@ -9281,7 +9281,6 @@ dissect_tcp(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void* data _U_)
                        ((tcpd->had_acc_ecn_setup_syn && tcpd->had_acc_ecn_setup_syn_ack) ||
                         tcpd->had_acc_ecn_option);
     flags_str = tcp_flags_to_str(pinfo->pool, tcph);
-    flags_str_first_letter = tcp_flags_to_str_first_letter(pinfo->pool, tcph);
 
     col_append_lstr(pinfo->cinfo, COL_INFO,
         " [", flags_str, "]",
@@ -9517,8 +9516,12 @@ dissect_tcp(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, void* data _U_)
         tf_syn = proto_tree_add_boolean(field_tree, hf_tcp_flags_syn, tvb, offset + 13, 1, tcph->th_flags);
         tf_fin = proto_tree_add_boolean(field_tree, hf_tcp_flags_fin, tvb, offset + 13, 1, tcph->th_flags);
 
-        tf = proto_tree_add_string(field_tree, hf_tcp_flags_str, tvb, offset + 12, 2, flags_str_first_letter);
-        proto_item_set_generated(tf);
+        /* Don't bother building the string unless someone will see it */
+        if (proto_field_is_referenced(tree, hf_tcp_flags_str)) {
+            flags_str_first_letter = tcp_flags_to_str_first_letter(pinfo->pool, tcph);
+            tf = proto_tree_add_string(field_tree, hf_tcp_flags_str, tvb, offset + 12, 2, flags_str_first_letter);
+            proto_item_set_generated(tf);
+        }
     }
 
     if(tcph->th_flags & TH_SYN) {
@@ -56,6 +56,7 @@
 #include "stat_tap_ui.h"
 #include "follow.h"
 #include "disabled_protos.h"
+#include "dissector_profile.h"
 #include "decode_as.h"
 #include "conversation_filter.h"
 #include "conversation_table.h"
@@ -312,6 +313,13 @@ epan_init(register_cb cb, void *client_data, bool load_plugins, epan_app_data_t*
 		wireshark_abort_on_too_many_items = false;
 	}
 
+	/* If the WIRESHARK_DISSECTOR_PROFILE environment variable is set,
+	 * collect per-dissector timing and allocation statistics.
+	 */
+	if (getenv("WIRESHARK_DISSECTOR_PROFILE") != NULL) {
+		dissector_profile_enable(true);
+	}
+
 	check_stack_limit();
 
 	/* initialize memory allocation subsystem */
@@ -464,6 +472,7 @@ epan_cleanup(void)
 	epan_plugin_register_all_handoffs = NULL;
 
 	dfilter_cleanup();
+	dissector_profile_cleanup();
 	decode_clear_all();
 	decode_cleanup();
 
@@ -751,6 +760,13 @@ epan_dissect_fake_protocols(epan_dissect_t *edt, const bool fake_protocols)
 		proto_tree_set_fake_protocols(edt->tree, fake_protocols);
 }
 
+void
+epan_dissect_set_extraction_only(epan_dissect_t *edt, const bool extraction_only)
+{
+	if (edt)
+		proto_tree_set_extraction_only(edt->tree, extraction_only);
+}
+
 void
 epan_dissect_run(epan_dissect_t *edt, int file_type_subtype,
 	wtap_rec *rec, frame_data *fd, column_info *cinfo)
@@ -593,6 +593,22 @@ WS_DLL_PUBLIC
 void
 epan_dissect_fake_protocols(epan_dissect_t *edt, const bool fake_protocols);
 
+/**
+ * @brief Indicate whether the dissection is only used to extract fields.
+ *
+ * Set this when nothing but the fields the tree was primed with (filters,
+ * field extractors, -e fields) will be looked at, so that items which
+ * would be faked don't cost an allocation each. Has no effect on visible
+ * trees. See proto_tree_set_extraction_only() for what dissectors can
+ * and can't rely on in such a tree.
+ *
+ * @param edt              The dissection context.
+ * @param extraction_only  If true, the faked part of the tree is collapsed.
+ */
+WS_DLL_PUBLIC
+void
+epan_dissect_set_extraction_only(epan_dissect_t *edt, const bool extraction_only);
+
 /**
  * @brief Run a single packet dissection.
  *
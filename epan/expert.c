@@ -14,6 +14,7 @@
 #define WS_LOG_DOMAIN LOG_DOMAIN_EPAN
 
 #include <stdio.h>
+#include <string.h>
 
 #include <epan/packet.h>
 #include "expert.h"
@@ -833,6 +834,174 @@ proto_tree_add_expert_format_remaining(proto_tree* tree, packet_info* pinfo, exp
 
 	return ti;
 }
+
+/*
+ * Aggregation of tapped expert infos into counters, so that listeners
+ * don't have to keep every instance. By summary, items are told apart by
+ * severity, protocol and formatted text. By field, all items raised from
+ * one expert field (severity, group, hf_index) share a counter; items
+ * without a registered field (hf_index <= 0) have no summary template, so
+ * those are still told apart by protocol and text.
+ */
+struct expert_aggregate {
+	expert_aggregate_key_e key;
+	GHashTable   *entries;	/* expert_aggregate_entry_t -> same, for lookup */
+	GPtrArray    *order;	/* expert_aggregate_entry_t, in order of first appearance */
+	GStringChunk *text;	/* protocol and summary strings */
+};
+
+static unsigned
+expert_aggregate_summary_hash(const void *key)
+{
+	const expert_aggregate_entry_t *entry = (const expert_aggregate_entry_t *)key;
+	unsigned hash;
+
+	hash = g_str_hash(entry->summary);
+	hash = hash * 31 + g_str_hash(entry->protocol);
+	hash = hash * 31 + (unsigned)entry->severity;
+	return hash;
+}
+
+static gboolean
+expert_aggregate_summary_equal(const void *a, const void *b)
+{
+	const expert_aggregate_entry_t *ea = (const expert_aggregate_entry_t *)a;
+	const expert_aggregate_entry_t *eb = (const expert_aggregate_entry_t *)b;
+
+	return ea->severity == eb->severity &&
+	       strcmp(ea->protocol, eb->protocol) == 0 &&
+	       strcmp(ea->summary, eb->summary) == 0;
+}
+
+static unsigned
+expert_aggregate_field_hash(const void *key)
+{
+	const expert_aggregate_entry_t *entry = (const expert_aggregate_entry_t *)key;
+	unsigned hash;
+
+	hash = (unsigned)entry->hf_index;
+	hash = hash * 31 + (unsigned)entry->group;
+	hash = hash * 31 + (unsigned)entry->severity;
+	if (entry->hf_index <= 0) {
+		hash = hash * 31 + g_str_hash(entry->summary);
+		hash = hash * 31 + g_str_hash(entry->protocol);
+	}
+	return hash;
+}
+
+static gboolean
+expert_aggregate_field_equal(const void *a, const void *b)
+{
+	const expert_aggregate_entry_t *ea = (const expert_aggregate_entry_t *)a;
+	const expert_aggregate_entry_t *eb = (const expert_aggregate_entry_t *)b;
+
+	if (ea->severity != eb->severity ||
+	    ea->group != eb->group ||
+	    ea->hf_index != eb->hf_index)
+		return false;
+
+	if (ea->hf_index > 0)
+		return true;
+
+	return strcmp(ea->protocol, eb->protocol) == 0 &&
+	       strcmp(ea->summary, eb->summary) == 0;
+}
+
+expert_aggregate_t *
+expert_aggregate_new(expert_aggregate_key_e key)
+{
+	expert_aggregate_t *agg = g_new(expert_aggregate_t, 1);
+
+	agg->key = key;
+	if (key == EXPERT_AGGREGATE_BY_FIELD)
+		agg->entries = g_hash_table_new(expert_aggregate_field_hash, expert_aggregate_field_equal);
+	else
+		agg->entries = g_hash_table_new(expert_aggregate_summary_hash, expert_aggregate_summary_equal);
+	agg->order = g_ptr_array_new_with_free_func(g_free);
+	agg->text = g_string_chunk_new(1024);
+	return agg;
+}
+
+void
+expert_aggregate_reset(expert_aggregate_t *agg)
+{
+	g_hash_table_remove_all(agg->entries);
+	g_ptr_array_set_size(agg->order, 0);
+	g_string_chunk_clear(agg->text);
+}
+
+void
+expert_aggregate_free(expert_aggregate_t *agg)
+{
+	if (agg == NULL)
+		return;
+
+	g_hash_table_destroy(agg->entries);
+	g_ptr_array_free(agg->order, true);
+	g_string_chunk_free(agg->text);
+	g_free(agg);
+}
+
+const expert_aggregate_entry_t *
+expert_aggregate_add(expert_aggregate_t *agg, const expert_info_t *ei)
+{
+	expert_aggregate_entry_t  key;
+	expert_aggregate_entry_t *entry;
+	const char               *formatted = ei->summary ? ei->summary : "";
+
+	key.severity = ei->severity;
+	key.group    = ei->group;
+	key.hf_index = ei->hf_index;
+	key.protocol = ei->protocol ? ei->protocol : "";
+	key.summary  = formatted;
+	if (agg->key == EXPERT_AGGREGATE_BY_FIELD && ei->hf_index > 0) {
+		/* The field's name is the summary it was registered with,
+		 * i.e. what expert_get_summary() returns. */
+		header_field_info *hfinfo = proto_registrar_get_nth(ei->hf_index);
+		if (hfinfo && hfinfo->name)
+			key.summary = hfinfo->name;
+	}
+
+	entry = (expert_aggregate_entry_t *)g_hash_table_lookup(agg->entries, &key);
+	if (entry == NULL) {
+		entry = g_new(expert_aggregate_entry_t, 1);
+		*entry = key;
+		entry->protocol = g_string_chunk_insert_const(agg->text, key.protocol);
+		entry->summary = g_string_chunk_insert_const(agg->text, key.summary);
+		entry->example = g_string_chunk_insert_const(agg->text, formatted);
+		entry->uniform = true;
+		entry->count = 0;
+		entry->num_frames = 0;
+		g_hash_table_add(agg->entries, entry);
+		g_ptr_array_add(agg->order, entry);
+	} else if (entry->uniform && strcmp(entry->example, formatted) != 0) {
+		entry->uniform = false;
+	}
+
+	entry->count++;
+	if (entry->num_frames < EXPERT_AGGREGATE_MAX_FRAMES &&
+	    (entry->num_frames == 0 || entry->frames[entry->num_frames - 1] != ei->packet_num)) {
+		entry->frames[entry->num_frames++] = ei->packet_num;
+	}
+
+	return entry;
+}
+
+unsigned
+expert_aggregate_num_entries(const expert_aggregate_t *agg)
+{
+	return agg->order->len;
+}
+
+const expert_aggregate_entry_t *
+expert_aggregate_get_entry(const expert_aggregate_t *agg, unsigned idx)
+{
+	if (idx >= agg->order->len)
+		return NULL;
+
+	return (const expert_aggregate_entry_t *)g_ptr_array_index(agg->order, idx);
+}
+
 /*
  * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
  *
@@ -284,6 +284,92 @@ WS_DLL_PUBLIC const char* expert_get_summary(expert_field *eiindex);
 WS_DLL_PUBLIC void
 expert_register_field_array(expert_module_t *module, ei_register_info *ei, const int num_records);
 
+/** Number of example frame numbers kept for each aggregated expert info. */
+#define EXPERT_AGGREGATE_MAX_FRAMES 8
+
+/**
+ * @brief How an expert info aggregate tells expert infos apart.
+ */
+typedef enum {
+    EXPERT_AGGREGATE_BY_SUMMARY,  /**< One entry per severity, protocol, and formatted summary text, as "tshark -z expert" lists them. */
+    EXPERT_AGGREGATE_BY_FIELD     /**< One entry per severity, group, and expert field, however the summaries were formatted. Expert infos without a field are counted per protocol and summary text. */
+} expert_aggregate_key_e;
+
+/**
+ * @brief Counter for all expert infos that an aggregate considers the same
+ * (see expert_aggregate_key_e).
+ */
+typedef struct expert_aggregate_entry_s {
+    int         severity;   /**< Severity shared by the aggregated items. */
+    int         group;      /**< Group of the first item; shared by all items with EXPERT_AGGREGATE_BY_FIELD. */
+    int         hf_index;   /**< Header field index of the first item; shared by all items with EXPERT_AGGREGATE_BY_FIELD. */
+    const char *protocol;   /**< Protocol name of the first item; owned by the aggregate. */
+    const char *summary;    /**< Summary text, or with EXPERT_AGGREGATE_BY_FIELD the registered summary of the field (see expert_get_summary()); owned by the aggregate. */
+    const char *example;    /**< Formatted summary of the first item; owned by the aggregate. */
+    bool        uniform;    /**< true if every item had the same formatted summary as the first one. */
+    uint64_t    count;      /**< Number of times the item was seen. */
+    uint32_t    frames[EXPERT_AGGREGATE_MAX_FRAMES]; /**< The first frames the item was seen in. */
+    unsigned    num_frames; /**< Number of valid entries in frames. */
+} expert_aggregate_entry_t;
+
+/**
+ * @brief Set of expert info counters, as built by an "expert" tap listener.
+ *
+ * Memory use depends on the number of distinct expert infos, not on the
+ * number of times they occur, so this is suitable for summarizing large
+ * captures. Individual occurrences beyond the example frames can be found
+ * by filtering on the entry's field.
+ */
+typedef struct expert_aggregate expert_aggregate_t;
+
+/**
+ * @brief Create an empty expert info aggregate.
+ * @param key How to tell expert infos apart.
+ * @return The new aggregate; free it with expert_aggregate_free().
+ */
+WS_DLL_PUBLIC expert_aggregate_t *
+expert_aggregate_new(expert_aggregate_key_e key);
+
+/**
+ * @brief Remove all entries from an expert info aggregate.
+ * @param agg The aggregate.
+ */
+WS_DLL_PUBLIC void
+expert_aggregate_reset(expert_aggregate_t *agg);
+
+/**
+ * @brief Free an expert info aggregate and all of its entries.
+ * @param agg The aggregate, or NULL.
+ */
+WS_DLL_PUBLIC void
+expert_aggregate_free(expert_aggregate_t *agg);
+
+/**
+ * @brief Count an expert info, typically the data passed to an "expert" tap listener.
+ * @param agg The aggregate.
+ * @param ei The expert info.
+ * @return The entry that was updated.
+ */
+WS_DLL_PUBLIC const expert_aggregate_entry_t *
+expert_aggregate_add(expert_aggregate_t *agg, const expert_info_t *ei);
+
+/**
+ * @brief Get the number of distinct entries in an expert info aggregate.
+ * @param agg The aggregate.
+ * @return The number of entries.
+ */
+WS_DLL_PUBLIC unsigned
+expert_aggregate_num_entries(const expert_aggregate_t *agg);
+
+/**
+ * @brief Get an entry of an expert info aggregate.
+ * @param agg The aggregate.
+ * @param idx Index of the entry. Entries are in the order they were first seen.
+ * @return The entry, or NULL if idx is out of range.
+ */
+WS_DLL_PUBLIC const expert_aggregate_entry_t *
+expert_aggregate_get_entry(const expert_aggregate_t *agg, unsigned idx);
+
 #define EXPERT_CHECKSUM_DISABLED    -2
 #define EXPERT_CHECKSUM_UNKNOWN     -1
 #define EXPERT_CHECKSUM_GOOD        0
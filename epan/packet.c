@@ -33,6 +33,8 @@
 #include <epan/wmem_scopes.h>
 
 #include <epan/column-info.h>
+#include <epan/conversation.h>
+#include <epan/dissector_profile.h>
 #include <epan/exceptions.h>
 #include <epan/reassemble.h>
 #include <epan/stream.h>
@@ -194,6 +196,22 @@ static GHashTable *heur_dissector_lists;
 /* Name hashtables for fast detection of duplicate names */
 static GHashTable* heuristic_short_names;
 
+/*
+ * Per-conversation heuristic state, one per heuristic list used in the
+ * conversation. Most conversations only ever use one list, so these are
+ * kept in a short linked list hanging off the conversation.
+ */
+typedef struct heur_conv_state {
+	struct heur_conv_state *next;
+	heur_dissector_list_t   list;
+	heur_dtbl_entry_t      *cached;        /* last heuristic that accepted a packet */
+	unsigned                misses;        /* consecutive packets no heuristic accepted */
+	uint32_t                give_up_frame; /* 0, or the frame at which misses hit the limit */
+} heur_conv_state_t;
+
+/* conversation_t * -> heur_conv_state_t * */
+static wmem_map_t *heur_conv_states;
+
 static void
 destroy_heuristic_dissector_entry(void *data)
 {
@@ -318,6 +336,7 @@ packet_cleanup(void)
 	g_hash_table_destroy(depend_dissector_lists);
 	g_hash_table_destroy(heur_dissector_lists);
 	g_hash_table_destroy(heuristic_short_names);
+	heur_conv_states = NULL;
 	g_slist_foreach(shutdown_routines, &call_routine, NULL);
 	g_slist_free(shutdown_routines);
 	if (postdissectors) {
@@ -929,6 +948,29 @@ remove_last_layer(packet_info *pinfo, bool reduce_count)
 }
 
 
+static inline int
+call_handle_dissector_func(dissector_handle_t handle, tvbuff_t *tvb,
+			   packet_info *pinfo, proto_tree *tree, void *data)
+{
+	int len;
+
+	switch (handle->dissector_type) {
+
+	case DISSECTOR_TYPE_SIMPLE:
+		len = (handle->dissector_func.dissector_type_simple)(tvb, pinfo, tree, data);
+		break;
+
+	case DISSECTOR_TYPE_CALLBACK:
+		len = (handle->dissector_func.dissector_type_callback)(tvb, pinfo, tree, data, handle->dissector_data);
+		break;
+
+	default:
+		ws_assert_not_reached();
+	}
+
+	return len;
+}
+
 /* This function will return
  *   >0  this protocol was successfully dissected and this was this protocol.
  *   0   this packet did not match this protocol.
@@ -954,19 +996,21 @@ call_dissector_through_handle(dissector_handle_t handle, tvbuff_t *tvb,
 			proto_get_protocol_short_name(handle->protocol);
 	}
 
-	switch (handle->dissector_type) {
-
-	case DISSECTOR_TYPE_SIMPLE:
-		len = (handle->dissector_func.dissector_type_simple)(tvb, pinfo, tree, data);
-		break;
+	if (G_UNLIKELY(dissector_profiling) && handle->protocol != NULL) {
+		dissector_profile_call_t profile_call;
 
-	case DISSECTOR_TYPE_CALLBACK:
-		len = (handle->dissector_func.dissector_type_callback)(tvb, pinfo, tree, data, handle->dissector_data);
-		break;
-
-	default:
-		ws_assert_not_reached();
+		/*
+		 * Close the profiler frame even if the dissector throws,
+		 * or it would be left on the profiler's stack.
+		 */
+		dissector_profile_enter(&profile_call, pinfo, proto_get_id(handle->protocol));
+		CLEANUP_PUSH(dissector_profile_leave, &profile_call);
+		len = call_handle_dissector_func(handle, tvb, pinfo, tree, data);
+		CLEANUP_CALL_AND_POP;
+	} else {
+		len = call_handle_dissector_func(handle, tvb, pinfo, tree, data);
 	}
+
 	pinfo->current_proto = saved_proto;
 	pinfo->curr_proto_layer_num = saved_proto_layer_num;
 
@@ -3020,6 +3064,7 @@ heur_dissector_add(const char *name, heur_dissector_t dissector, const char *dis
 	hdtbl_entry->list_name = g_strdup(name);
 	hdtbl_entry->enabled   = (enable == HEURISTIC_ENABLE);
 	hdtbl_entry->enabled_by_default = (enable == HEURISTIC_ENABLE);
+	hdtbl_entry->hits      = 0;
 
 	/* do the table insertion */
 	/* Ensure short_name is unique */
@@ -3043,6 +3088,17 @@ heur_dissector_add(const char *name, heur_dissector_t dissector, const char *dis
 
 
 
+static void
+heur_conv_state_forget_entry(void *key _U_, void *value, void *user_data)
+{
+	heur_conv_state_t *state;
+
+	for (state = (heur_conv_state_t *)value; state != NULL; state = state->next) {
+		if (state->cached == user_data)
+			state->cached = NULL;
+	}
+}
+
 static int
 find_matching_heur_dissector(const void *a, const void *b) {
 	const heur_dtbl_entry_t *hdtbl_entry_a = (const heur_dtbl_entry_t *) a;
@@ -3069,6 +3125,9 @@ heur_dissector_delete(const char *name, heur_dissector_t dissector, const int pr
 
 	if (found_entry) {
 		heur_dtbl_entry_t *found_hdtbl_entry = (heur_dtbl_entry_t *)(found_entry->data);
+		if (heur_conv_states != NULL) {
+			wmem_map_foreach(heur_conv_states, heur_conv_state_forget_entry, found_hdtbl_entry);
+		}
 		proto_add_deregistered_data(found_hdtbl_entry->list_name);
 		g_hash_table_remove(heuristic_short_names, found_hdtbl_entry->short_name);
 		proto_add_deregistered_data(found_hdtbl_entry->short_name);
@@ -3078,6 +3137,114 @@ heur_dissector_delete(const char *name, heur_dissector_t dissector, const int pr
 	}
 }
 
+static heur_conv_state_t *
+heur_conv_state_get(heur_dissector_list_t sub_dissectors, packet_info *pinfo)
+{
+	conversation_t    *conv;
+	heur_conv_state_t *head, *state;
+
+	if (!prefs.heur_conversation_cache && prefs.heur_miss_limit == 0)
+		return NULL;
+
+	conv = find_conversation_pinfo_ro(pinfo, 0);
+	if (conv == NULL)
+		return NULL;
+
+	if (heur_conv_states == NULL) {
+		heur_conv_states = wmem_map_new_autoreset(wmem_epan_scope(), wmem_file_scope(),
+				g_direct_hash, g_direct_equal);
+	}
+
+	head = (heur_conv_state_t *)wmem_map_lookup(heur_conv_states, conv);
+	for (state = head; state != NULL; state = state->next) {
+		if (state->list == sub_dissectors)
+			return state;
+	}
+
+	state = wmem_new0(wmem_file_scope(), heur_conv_state_t);
+	state->list = sub_dissectors;
+	state->next = head;
+	wmem_map_insert(heur_conv_states, conv, state);
+	return state;
+}
+
+static inline bool
+heur_entry_is_enabled(const heur_dtbl_entry_t *hdtbl_entry)
+{
+	return hdtbl_entry->protocol == NULL ||
+		(proto_is_protocol_enabled(hdtbl_entry->protocol) && hdtbl_entry->enabled);
+}
+
+/*
+ * Try a single heuristic dissector. Returns what the dissector returned,
+ * after undoing the protocol layer we added if it didn't take the packet.
+ */
+static int
+try_heur_entry(heur_dtbl_entry_t *hdtbl_entry, tvbuff_t *tvb, packet_info *pinfo,
+		proto_tree *tree, void *data, unsigned saved_layers_len,
+		unsigned saved_tree_count)
+{
+	int       proto_id = -1;
+	int       len;
+	bool      consumed_none;
+	unsigned  saved_desegment_len;
+
+	if (hdtbl_entry->protocol != NULL) {
+		proto_id = proto_get_id(hdtbl_entry->protocol);
+		/* do NOT change this behavior - wslua uses the protocol short name set here in order
+		   to determine which Lua-based heuristic dissector to call */
+		pinfo->current_proto =
+			proto_get_protocol_short_name(hdtbl_entry->protocol);
+
+		/*
+		 * Add the protocol name to the layers; we'll remove it
+		 * if the dissector fails.
+		 */
+		add_layer(pinfo, proto_id);
+	}
+
+	pinfo->heur_list_name = hdtbl_entry->list_name;
+
+	saved_desegment_len = pinfo->desegment_len;
+	if (G_UNLIKELY(dissector_profiling) && hdtbl_entry->protocol != NULL) {
+		dissector_profile_call_t profile_call;
+
+		dissector_profile_enter(&profile_call, pinfo, proto_id);
+		CLEANUP_PUSH(dissector_profile_leave, &profile_call);
+		len = (hdtbl_entry->dissector)(tvb, pinfo, tree, data);
+		CLEANUP_CALL_AND_POP;
+		dissector_profile_heur_result(proto_id, len != 0);
+	} else {
+		len = (hdtbl_entry->dissector)(tvb, pinfo, tree, data);
+	}
+	consumed_none = len == 0 || (pinfo->desegment_len != saved_desegment_len && pinfo->desegment_offset == 0);
+	if (hdtbl_entry->protocol != NULL &&
+		(consumed_none || (tree && saved_tree_count == tree->tree_data->count))) {
+		/*
+		 * We added a protocol layer above. The dissector
+		 * didn't consume any data or it didn't add any
+		 * items to the tree so remove it from the list.
+		 */
+		while (wmem_list_count(pinfo->layers) > saved_layers_len) {
+			/*
+			 * Only reduce the layer number if the dissector
+			 * didn't consume data. Since tree can be NULL on
+			 * the first pass, we cannot check it or it will
+			 * break dissectors that rely on a stable value.
+			 */
+			remove_last_layer(pinfo, consumed_none);
+		}
+	}
+	if (len) {
+		if (ws_log_msg_is_active(WS_LOG_DOMAIN, LOG_LEVEL_DEBUG)) {
+			ws_debug("Frame: %d | Layers: %s | Dissector: %s\n", pinfo->num, proto_list_layers(pinfo), hdtbl_entry->short_name);
+		}
+		if (hdtbl_entry->hits < G_MAXUINT)
+			hdtbl_entry->hits++;
+	}
+	return len;
+}
+
 bool
 dissector_try_heuristic(heur_dissector_list_t sub_dissectors, tvbuff_t *tvb,
 			packet_info *pinfo, proto_tree *tree, heur_dtbl_entry_t **heur_dtbl_entry, void *data)
@@ -3091,10 +3258,8 @@ dissector_try_heuristic(heur_dissector_list_t sub_dissectors, tvbuff_t *tvb,
 	uint16_t           saved_can_desegment;
 	unsigned           saved_layers_len = 0;
 	heur_dtbl_entry_t *hdtbl_entry;
-	int                proto_id;
-	int                len;
-	bool               consumed_none;
-	unsigned           saved_desegment_len;
+	heur_dtbl_entry_t *tried_entry = NULL;
+	heur_conv_state_t *conv_state;
 	unsigned           saved_tree_count = tree ? tree->tree_data->count : 0;
 
 	/* can_desegment is set to 2 by anyone which offers this api/service.
@@ -3120,74 +3285,80 @@ dissector_try_heuristic(heur_dissector_list_t sub_dissectors, tvbuff_t *tvb,
 
 	DISSECTOR_ASSERT(saved_layers_len < prefs.gui_max_tree_depth);
 
+	conv_state = heur_conv_state_get(sub_dissectors, pinfo);
+
+	/*
+	 * If nothing has accepted this conversation's packets for a while,
+	 * stop trying. The limit is applied by frame number so that every
+	 * pass over the file makes the same decision for the same frame.
+	 */
+	if (conv_state && conv_state->give_up_frame != 0 &&
+	    pinfo->num > conv_state->give_up_frame) {
+		goto done;
+	}
+
+	/*
+	 * Try whichever heuristic last accepted a packet in this
+	 * conversation first; it's very likely to accept this one, too.
+	 */
+	if (conv_state && prefs.heur_conversation_cache && conv_state->cached &&
+	    heur_entry_is_enabled(conv_state->cached)) {
+		tried_entry = conv_state->cached;
+		if (try_heur_entry(tried_entry, tvb, pinfo, tree, data,
+				saved_layers_len, saved_tree_count)) {
+			*heur_dtbl_entry = tried_entry;
+			status = true;
+			goto done;
+		}
+	}
+
 	for (entry = sub_dissectors->dissectors; entry != NULL;
 	    entry = g_slist_next(entry)) {
 		/* XXX - why set this now and above? */
 		pinfo->can_desegment = saved_can_desegment-(saved_can_desegment>0);
 		hdtbl_entry = (heur_dtbl_entry_t *)entry->data;
 
-		if (hdtbl_entry->protocol != NULL &&
-			(!proto_is_protocol_enabled(hdtbl_entry->protocol)||(hdtbl_entry->enabled==false))) {
+		if (hdtbl_entry == tried_entry || !heur_entry_is_enabled(hdtbl_entry)) {
 			/*
 			 * No - don't try this dissector.
 			 */
 			continue;
 		}
 
-		if (hdtbl_entry->protocol != NULL) {
-			proto_id = proto_get_id(hdtbl_entry->protocol);
-			/* do NOT change this behavior - wslua uses the protocol short name set here in order
-			   to determine which Lua-based heuristic dissector to call */
-			pinfo->current_proto =
-				proto_get_protocol_short_name(hdtbl_entry->protocol);
-
-			/*
-			 * Add the protocol name to the layers; we'll remove it
-			 * if the dissector fails.
-			 */
-			add_layer(pinfo, proto_id);
-		}
-
-		pinfo->heur_list_name = hdtbl_entry->list_name;
+		if (try_heur_entry(hdtbl_entry, tvb, pinfo, tree, data,
+				saved_layers_len, saved_tree_count)) {
+			*heur_dtbl_entry = hdtbl_entry;
 
-		saved_desegment_len = pinfo->desegment_len;
-		len = (hdtbl_entry->dissector)(tvb, pinfo, tree, data);
-		consumed_none = len == 0 || (pinfo->desegment_len != saved_desegment_len && pinfo->desegment_offset == 0);
-		if (hdtbl_entry->protocol != NULL &&
-			(consumed_none || (tree && saved_tree_count == tree->tree_data->count))) {
 			/*
-			 * We added a protocol layer above. The dissector
-			 * didn't consume any data or it didn't add any
-			 * items to the tree so remove it from the list.
+			 * Keep the list roughly sorted by how often each
+			 * dissector accepts a packet, so that the likely
+			 * ones are tried first. Moving up one place per hit
+			 * doesn't let a single stray match reshuffle the
+			 * list the way moving straight to the front would.
 			 */
-			while (wmem_list_count(pinfo->layers) > saved_layers_len) {
-				/*
-				 * Only reduce the layer number if the dissector
-				 * didn't consume data. Since tree can be NULL on
-				 * the first pass, we cannot check it or it will
-				 * break dissectors that rely on a stable value.
-				 */
-				remove_last_layer(pinfo, consumed_none);
-			}
-		}
-		if (len) {
-			if (ws_log_msg_is_active(WS_LOG_DOMAIN, LOG_LEVEL_DEBUG)) {
-				ws_debug("Frame: %d | Layers: %s | Dissector: %s\n", pinfo->num, proto_list_layers(pinfo), hdtbl_entry->short_name);
-			}
-
-			*heur_dtbl_entry = hdtbl_entry;
-
-			/* Bubble the matched entry to the top for faster search next time. */
-			if (prev_entry != NULL) {
-				sub_dissectors->dissectors = g_slist_remove_link(sub_dissectors->dissectors, entry);
-				sub_dissectors->dissectors = g_slist_concat(entry, sub_dissectors->dissectors);
+			if (prev_entry != NULL &&
+			    hdtbl_entry->hits > ((heur_dtbl_entry_t *)prev_entry->data)->hits) {
+				entry->data = prev_entry->data;
+				prev_entry->data = hdtbl_entry;
 			}
+			if (conv_state)
+				conv_state->cached = hdtbl_entry;
 			status = true;
 			break;
 		}
 		prev_entry = entry;
 	}
 
+done:
+	if (conv_state && prefs.heur_miss_limit != 0 && !pinfo->fd->visited &&
+	    conv_state->give_up_frame == 0) {
+		if (status) {
+			conv_state->misses = 0;
+		} else if (++conv_state->misses >= prefs.heur_miss_limit) {
+			conv_state->give_up_frame = pinfo->num;
+		}
+	}
+
 	pinfo->current_proto = saved_curr_proto;
 	pinfo->curr_proto_layer_num = saved_proto_layer_num;
 	pinfo->heur_list_name = saved_heur_list_name;
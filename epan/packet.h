@@ -676,6 +676,7 @@ typedef struct heur_dtbl_entry {
     char*            short_name;       /**< Internal unique identifier string used to distinguish this heuristic from others. */
     bool             enabled;          /**< Whether this heuristic dissector is currently enabled. */
     bool             enabled_by_default; /**< Whether this heuristic dissector is enabled by default upon registration. */
+    unsigned         hits;             /**< Number of packets this heuristic dissector has accepted; used to order the list. */
 } heur_dtbl_entry_t;
 
 /** A protocol uses this function to register a heuristic sub-dissector list.
@@ -3626,7 +3626,7 @@ prefs_register_modules(void)
 
     prefs_register_uint_preference(gui_module, "packet_list_cached_rows_max",
                                    "Maximum cached rows",
-                                   "Maximum number of rows that can be sorted by columns that require dissection. Increasing this increases memory consumption by caching column text",
+                                   "Maximum number of rows whose column text is kept in memory. Increasing this increases memory consumption but reduces redissection when scrolling",
                                    10,
                                    &prefs.gui_packet_list_cached_rows_max);
 
@@ -3951,6 +3951,22 @@ prefs_register_modules(void)
                                    "Currently ICMP and ICMPv6 use this preference to add VLAN ID to conversation tracking, and IPv4 uses this preference to take VLAN ID into account during reassembly",
                                    &prefs.strict_conversation_tracking_heuristics);
 
+    prefs_register_bool_preference(protocols_module, "heuristic_conversation_cache",
+                                   "Remember the heuristic dissector of each conversation",
+                                   "When a heuristic dissector accepts a packet, try it first for later packets "
+                                   "of the same conversation before walking the rest of the heuristic list. "
+                                   "Which dissector is tried first then depends on the packets seen before, so "
+                                   "a single-pass and a two-pass read of a file can decode a packet differently "
+                                   "if more than one heuristic dissector would accept it.",
+                                   &prefs.heur_conversation_cache);
+
+    prefs_register_uint_preference(protocols_module, "heuristic_miss_limit",
+                                   "Give up on heuristics after this many misses per conversation",
+                                   "Stop trying heuristic dissectors on a conversation once this many consecutive "
+                                   "packets in it were rejected by all of them. 0 means never give up.",
+                                   10,
+                                   &prefs.heur_miss_limit);
+
     prefs_register_bool_preference(protocols_module, "ignore_dup_frames",
                                    "Ignore duplicate frames",
                                    "Ignore frames that are exact duplicates of any previous frame.",
@@ -4292,6 +4308,8 @@ prefs_set_global_defaults(wmem_allocator_t* pref_scope, const char** col_fmt, in
     prefs.display_hidden_proto_items = false;
     prefs.display_byte_fields_with_spaces = false;
     prefs.display_abs_time_ascii = ABS_TIME_ASCII_TREE;
+    prefs.heur_conversation_cache = false;
+    prefs.heur_miss_limit = 0;
     prefs.ignore_dup_frames = false;
     prefs.ignore_dup_frames_cache_entries = 10000;
 
@@ -319,6 +319,8 @@ typedef struct _e_prefs {
     bool          incomplete_dissectors_check_debug;   /**< If true, emit debug output for incomplete dissector checks */
     bool          strict_conversation_tracking_heuristics; /**< If true, apply stricter heuristics for conversation tracking */
     int           conversation_deinterlacing_key;      /**< Key bitmask controlling conversation deinterlacing behavior */
+    bool          heur_conversation_cache;             /**< If true, try the heuristic that last matched a conversation first */
+    unsigned      heur_miss_limit;                     /**< Stop trying heuristics on a conversation after this many misses; 0 for no limit */
 
     /* Duplicate frame detection */
     bool          ignore_dup_frames;                   /**< If true, suppress display of duplicate frames */
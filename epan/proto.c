@@ -439,20 +439,64 @@ static GPtrArray *deregistered_slice;
 /* indexed by prefix, contains initializers */
 static GHashTable* prefixes;
 
+/*
+ * proto_nodes and field_infos are handed out from per-tree slabs carved
+ * out of the packet pool instead of being allocated one at a time.
+ * Dissectors add items in (mostly) depth-first order, so items that are
+ * walked together by the filter engine, the printers and the GUI model
+ * end up next to each other in memory, and adding an item usually costs
+ * a pointer bump rather than a pool allocation.
+ *
+ * The slabs are never freed individually; they go away with the rest of
+ * the packet pool, and proto_tree_reset() simply forgets about them.
+ */
+#define PROTO_TREE_SLAB_ITEMS 128
+
+static inline proto_node *
+proto_tree_slab_new_node(tree_data_t *tree_data)
+{
+	if (G_UNLIKELY(tree_data->node_slab_avail == 0)) {
+		tree_data->node_slab = wmem_alloc_array(tree_data->pinfo->pool,
+		    proto_node, PROTO_TREE_SLAB_ITEMS);
+		tree_data->node_slab_avail = PROTO_TREE_SLAB_ITEMS;
+	}
+	tree_data->node_slab_avail--;
+	return tree_data->node_slab++;
+}
+
+static inline field_info *
+proto_tree_slab_new_finfo(tree_data_t *tree_data)
+{
+	if (G_UNLIKELY(tree_data->finfo_slab_avail == 0)) {
+		tree_data->finfo_slab = wmem_alloc_array(tree_data->pinfo->pool,
+		    field_info, PROTO_TREE_SLAB_ITEMS);
+		tree_data->finfo_slab_avail = PROTO_TREE_SLAB_ITEMS;
+	}
+	tree_data->finfo_slab_avail--;
+	return tree_data->finfo_slab++;
+}
+
+static inline void
+proto_tree_slab_reset(tree_data_t *tree_data)
+{
+	tree_data->node_slab = NULL;
+	tree_data->node_slab_avail = 0;
+	tree_data->finfo_slab = NULL;
+	tree_data->finfo_slab_avail = 0;
+}
+
 /* Contains information about a field when a dissector calls
  * proto_tree_add_item.  */
-#define FIELD_INFO_NEW(pool, fi)  fi = wmem_new(pool, field_info)
-#define FIELD_INFO_FREE(pool, fi) wmem_free(pool, fi)
+#define FIELD_INFO_NEW(tree, fi)  fi = proto_tree_slab_new_finfo(PTREE_DATA(tree))
 
 /* Contains the space for proto_nodes. */
+#define PROTO_NODE_NEW(tree, node)  node = proto_tree_slab_new_node(PTREE_DATA(tree))
+
 #define PROTO_NODE_INIT(node)			\
 	node->first_child = NULL;		\
 	node->last_child = NULL;		\
 	node->next = NULL;
 
-#define PROTO_NODE_FREE(pool, node)			\
-	wmem_free(pool, node)
-
 /* String space for protocol and field items for the GUI */
 #define ITEM_LABEL_NEW(pool, il)			\
 	il = wmem_new(pool, item_label_t);		\
@@ -957,6 +1001,9 @@ proto_tree_reset(proto_tree *tree)
 	tree_data->max_start = 0;
 	tree_data->start_idle_count = 0;
 
+	/* The slabs belong to the packet pool, which is about to be freed */
+	proto_tree_slab_reset(tree_data);
+
 	PROTO_NODE_INIT(tree);
 }
 
@@ -1004,6 +1051,13 @@ proto_tree_set_fake_protocols(proto_tree *tree, bool fake_protocols)
 		PTREE_DATA(tree)->fake_protocols = fake_protocols;
 }
 
+void
+proto_tree_set_extraction_only(proto_tree *tree, bool extraction_only)
+{
+	if (tree)
+		PTREE_DATA(tree)->extraction_only = extraction_only;
+}
+
 /* Assume dissector set only its protocol fields.
    This function is called by dissectors and allows the speeding up of filtering
    in wireshark; if this function returns false it is safe to reset tree to NULL
@@ -6609,6 +6663,23 @@ proto_tree_add_fake_node(proto_tree *tree, const header_field_info *hfinfo)
 
 	ws_assert(tree);
 
+	/*
+	 * If only referenced fields are going to be extracted from this
+	 * tree, nobody cares what the faked part of it looks like. If the
+	 * parent is faked as well, hand it back rather than allocating
+	 * another node; anything added "under" it will end up under the
+	 * nearest real ancestor, which is all the filter engine and field
+	 * extractors look at. (The proto_tree_add_*_format() routines
+	 * already skip the representation when pi == tree.)
+	 *
+	 * Never hand back the root, though: dissectors add fields to
+	 * proto_item_get_parent() of their own items, and that has to be
+	 * a node rather than NULL, or those fields would silently be lost.
+	 */
+	if (PTREE_DATA(tree)->extraction_only && PNODE_FINFO(tree) == NULL &&
+	    tree->parent != NULL)
+		return (proto_item *)tree;
+
 	/*
 	 * Restrict our depth. proto_tree_traverse_pre_order and
 	 * proto_tree_traverse_post_order (and possibly others) are recursive
@@ -6643,7 +6714,7 @@ proto_tree_add_fake_node(proto_tree *tree, const header_field_info *hfinfo)
 		/* XXX - is it safe to continue here? */
 	}
 
-	pnode = wmem_new(PNODE_POOL(tree), proto_node);
+	PROTO_NODE_NEW(tree, pnode);
 	PROTO_NODE_INIT(pnode);
 	pnode->parent = tnode;
 	PNODE_HFINFO(pnode) = hfinfo;
@@ -6723,7 +6794,7 @@ proto_tree_add_node(proto_tree *tree, field_info *fi)
 		/* XXX - is it safe to continue here? */
 	}
 
-	pnode = wmem_new(PNODE_POOL(tree), proto_node);
+	PROTO_NODE_NEW(tree, pnode);
 	PROTO_NODE_INIT(pnode);
 	pnode->parent = tnode;
 	PNODE_HFINFO(pnode) = fi->hfinfo;
@@ -7134,7 +7205,7 @@ new_field_info(proto_tree *tree, header_field_info *hfinfo, tvbuff_t *tvb,
 {
 	field_info *fi;
 
-	FIELD_INFO_NEW(PNODE_POOL(tree), fi);
+	FIELD_INFO_NEW(tree, fi);
 
 	fi->hfinfo     = hfinfo;
 	fi->start      = start;
@@ -8327,6 +8398,9 @@ proto_tree_create_root(packet_info *pinfo)
 	/* Make sure that we fake protocols (if possible) */
 	pnode->tree_data->fake_protocols = true;
 
+	/* Build the faked part of the tree unless asked not to */
+	pnode->tree_data->extraction_only = false;
+
 	/* Keep track of the number of children */
 	pnode->tree_data->count = 0;
 
@@ -8335,6 +8409,9 @@ proto_tree_create_root(packet_info *pinfo)
 	pnode->tree_data->max_start = 0;
 	pnode->tree_data->start_idle_count = 0;
 
+	/* Slabs are allocated from the packet pool on first use */
+	proto_tree_slab_reset(pnode->tree_data);
+
 	return (proto_tree *)pnode;
 }
 
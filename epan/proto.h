@@ -903,11 +903,16 @@ typedef struct {
     GHashTable          *interesting_hfids;
     bool                 visible;
     bool                 fake_protocols;
+    bool                 extraction_only;
     unsigned             count;
     struct _packet_info *pinfo;
     tvbuff_t            *idle_count_ds_tvb;
     unsigned             max_start;
     unsigned             start_idle_count;
+    struct _proto_node  *node_slab;        /**< next free proto_node in the current slab */
+    unsigned             node_slab_avail;  /**< proto_nodes left in node_slab */
+    struct field_info   *finfo_slab;       /**< next free field_info in the current slab */
+    unsigned             finfo_slab_avail; /**< field_infos left in finfo_slab */
 } tree_data_t;
 
 /** Each proto_tree, proto_item is one of these. */
@@ -1047,6 +1052,20 @@ static inline void proto_item_set_visible(proto_item *ti) {
 }
 #define PROTO_ITEM_SET_VISIBLE(ti) proto_item_set_visible((ti))
 
+/** Will text set or appended to this item's representation be kept?
+ * It won't for faked items, or for hidden items in an invisible tree
+ * (see TRY_TO_FAKE_THIS_REPR in proto.c). Dissectors can use this to
+ * avoid formatting (and resolving) strings that would be thrown away.
+ * @param ti The item to check. May be NULL.
+ * @return true if the item's representation is used, false otherwise.
+ */
+static inline bool proto_item_wants_repr(const proto_item *ti) {
+    if (ti && PITEM_FINFO(ti)) {
+        return PTREE_DATA(ti)->visible || !FI_GET_FLAG(PITEM_FINFO(ti), FI_HIDDEN);
+    }
+    return false;
+}
+
 /** Is this protocol field generated by Wireshark (and not read from the packet data)?
  * @param ti The item to check. May be NULL.
  * @return true if the item is generated, false otherwise.
@@ -1365,6 +1384,23 @@ proto_tree_set_visible(proto_tree *tree, bool visible);
 extern void
 proto_tree_set_fake_protocols(proto_tree *tree, bool fake_protocols);
 
+/** Indicate whether the tree is only used to extract referenced fields
+ (default = false). In that case the shape of the faked (not referenced,
+ not visible) part of the tree doesn't matter, so adding an item that
+ would be faked under a node that is itself faked returns that node
+ instead of allocating a new one. Has no effect on visible trees.
+ The root is never handed back, so proto_item_get_parent() of an item
+ is never NULL, but faked items may share a node and their parent chains
+ are shorter than in a normal tree: proto_item_get_parent_nth() can reach
+ NULL sooner, and a dissector that decides what to add from the tree's
+ shape rather than from proto_field_is_referenced() may add less. The
+ dissectors in the tree only use proto_item_get_parent_nth() for text
+ (which is skipped on faked items anyway) or on visible trees.
+ @param tree the tree to be set
+ @param extraction_only true if only referenced fields will be used */
+WS_DLL_PUBLIC void
+proto_tree_set_extraction_only(proto_tree *tree, bool extraction_only);
+
 /** Mark a field/protocol ID as "interesting".
  * That means that we don't fake the item (because we are filtering on it),
  * and we mark its parent protocol (if any) as being indirectly referenced
@@ -11,6 +11,13 @@
 #include "strutil.h"
 #include <wsutil/utf8_entities.h>
 
+#include <epan/epan.h>
+#include <epan/epan_dissect.h>
+#include <epan/expert.h>
+#include <epan/frame_data.h>
+#include <epan/register.h>
+#include <wiretap/wtap.h>
+
 /*
  * FIXME: LABEL_LENGTH includes the nul byte terminator.
  * This is confusing but matches ITEM_LABEL_LENGTH.
@@ -74,6 +81,270 @@ void test_label_escape_control(void)
     g_assert_cmpuint(pos, ==, strlen(dst));
 }
 
+static epan_app_data_t test_app_data;
+static bool test_epan_initialized;
+
+/* Register all protocols, once; epan can't be initialized twice per process. */
+static void
+test_epan_init(void)
+{
+    if (test_epan_initialized)
+        return;
+
+    memset(&test_app_data, 0, sizeof(test_app_data));
+    test_app_data.env_var_prefix = "WIRESHARK";
+    test_app_data.register_func = register_all_protocols;
+    test_app_data.handoff_func = register_all_protocol_handoffs;
+
+    wtap_init(false, test_app_data.env_var_prefix, NULL, 0);
+    g_assert_true(epan_init(NULL, NULL, false, &test_app_data));
+    epan_load_settings();
+    test_epan_initialized = true;
+}
+
+static void
+test_epan_cleanup(void)
+{
+    if (!test_epan_initialized)
+        return;
+
+    epan_cleanup();
+    wtap_cleanup();
+    test_epan_initialized = false;
+}
+
+static const expert_aggregate_entry_t *
+expert_aggregate_add_item(expert_aggregate_t *agg, uint32_t packet_num,
+                          int group, int severity, int hf_index,
+                          const char *protocol, const char *summary)
+{
+    expert_info_t ei;
+
+    memset(&ei, 0, sizeof(ei));
+    ei.packet_num = packet_num;
+    ei.group = group;
+    ei.severity = severity;
+    ei.hf_index = hf_index;
+    ei.protocol = protocol;
+    ei.summary = (char *)summary;
+    return expert_aggregate_add(agg, &ei);
+}
+
+static void
+test_expert_aggregate_by_summary(void)
+{
+    expert_aggregate_t *agg = expert_aggregate_new(EXPERT_AGGREGATE_BY_SUMMARY);
+    const expert_aggregate_entry_t *entry;
+
+    expert_aggregate_add_item(agg, 1, PI_SEQUENCE, PI_WARN, 10, "TCP", "Window is full");
+    expert_aggregate_add_item(agg, 1, PI_SEQUENCE, PI_WARN, 10, "TCP", "Window is full: 3");
+    expert_aggregate_add_item(agg, 2, PI_PROTOCOL, PI_WARN, 11, "TCP", "Window is full");
+    expert_aggregate_add_item(agg, 3, PI_SEQUENCE, PI_WARN, 10, "UDP", "Window is full");
+    expert_aggregate_add_item(agg, 4, PI_SEQUENCE, PI_NOTE, 10, "TCP", "Window is full");
+
+    /* One row per severity, protocol and text, in order of first appearance */
+    g_assert_cmpuint(expert_aggregate_num_entries(agg), ==, 4);
+
+    entry = expert_aggregate_get_entry(agg, 0);
+    g_assert_cmpstr(entry->protocol, ==, "TCP");
+    g_assert_cmpstr(entry->summary, ==, "Window is full");
+    g_assert_cmpint(entry->group, ==, PI_SEQUENCE);
+    g_assert_cmpint(entry->hf_index, ==, 10);
+    g_assert_cmpuint(entry->count, ==, 2);
+    g_assert_cmpuint(entry->num_frames, ==, 2);
+    g_assert_cmpuint(entry->frames[0], ==, 1);
+    g_assert_cmpuint(entry->frames[1], ==, 2);
+    g_assert_true(entry->uniform);
+
+    entry = expert_aggregate_get_entry(agg, 1);
+    g_assert_cmpstr(entry->summary, ==, "Window is full: 3");
+    g_assert_cmpuint(entry->count, ==, 1);
+
+    entry = expert_aggregate_get_entry(agg, 2);
+    g_assert_cmpstr(entry->protocol, ==, "UDP");
+
+    entry = expert_aggregate_get_entry(agg, 3);
+    g_assert_cmpint(entry->severity, ==, PI_NOTE);
+
+    g_assert_null(expert_aggregate_get_entry(agg, 4));
+
+    expert_aggregate_reset(agg);
+    g_assert_cmpuint(expert_aggregate_num_entries(agg), ==, 0);
+    entry = expert_aggregate_add_item(agg, 5, PI_SEQUENCE, PI_WARN, 10, "TCP", "Window is full");
+    g_assert_cmpuint(entry->count, ==, 1);
+    g_assert_cmpuint(expert_aggregate_num_entries(agg), ==, 1);
+
+    expert_aggregate_free(agg);
+}
+
+static void
+test_expert_aggregate_frames(void)
+{
+    expert_aggregate_t *agg = expert_aggregate_new(EXPERT_AGGREGATE_BY_SUMMARY);
+    const expert_aggregate_entry_t *entry = NULL;
+
+    for (uint32_t frame = 1; frame <= EXPERT_AGGREGATE_MAX_FRAMES + 4; frame++) {
+        entry = expert_aggregate_add_item(agg, frame, PI_MALFORMED, PI_ERROR, -1, "IP", "Bad header");
+        /* A second item in the same frame isn't another example */
+        if (frame == 2) {
+            entry = expert_aggregate_add_item(agg, frame, PI_MALFORMED, PI_ERROR, -1, "IP", "Bad header");
+        }
+    }
+
+    g_assert_cmpuint(entry->count, ==, EXPERT_AGGREGATE_MAX_FRAMES + 5);
+    g_assert_cmpuint(entry->num_frames, ==, EXPERT_AGGREGATE_MAX_FRAMES);
+    for (unsigned i = 0; i < EXPERT_AGGREGATE_MAX_FRAMES; i++) {
+        g_assert_cmpuint(entry->frames[i], ==, i + 1);
+    }
+
+    expert_aggregate_free(agg);
+}
+
+static void
+test_expert_aggregate_by_field(void)
+{
+    expert_aggregate_t *agg;
+    const expert_aggregate_entry_t *entry;
+    int hf_len_invalid, hf_ttl_too_small;
+
+    test_epan_init();
+    hf_len_invalid = proto_registrar_get_id_byname("ip.opt.len.invalid");
+    hf_ttl_too_small = proto_registrar_get_id_byname("ip.ttl.too_small");
+    g_assert_cmpint(hf_len_invalid, >, 0);
+    g_assert_cmpint(hf_ttl_too_small, >, 0);
+
+    agg = expert_aggregate_new(EXPERT_AGGREGATE_BY_FIELD);
+
+    /* Differently formatted items of one field share an entry */
+    expert_aggregate_add_item(agg, 1, PI_PROTOCOL, PI_WARN, hf_len_invalid, "IPv4", "Invalid length for option: 3");
+    expert_aggregate_add_item(agg, 2, PI_PROTOCOL, PI_WARN, hf_ttl_too_small, "IPv4", "Time To Live too small");
+    expert_aggregate_add_item(agg, 3, PI_PROTOCOL, PI_WARN, hf_len_invalid, "IPv4", "Invalid length for option: 5");
+    expert_aggregate_add_item(agg, 4, PI_PROTOCOL, PI_WARN, hf_ttl_too_small, "IPv4", "Time To Live too small");
+    /* Items without a field are still told apart by their text */
+    expert_aggregate_add_item(agg, 5, PI_PROTOCOL, PI_WARN, -1, "IPv4", "Something odd: 1");
+    expert_aggregate_add_item(agg, 6, PI_PROTOCOL, PI_WARN, -1, "IPv4", "Something odd: 2");
+
+    g_assert_cmpuint(expert_aggregate_num_entries(agg), ==, 4);
+
+    entry = expert_aggregate_get_entry(agg, 0);
+    g_assert_cmpint(entry->hf_index, ==, hf_len_invalid);
+    g_assert_cmpstr(entry->summary, ==, "Invalid length for option");
+    g_assert_cmpstr(entry->example, ==, "Invalid length for option: 3");
+    g_assert_false(entry->uniform);
+    g_assert_cmpuint(entry->count, ==, 2);
+    g_assert_cmpuint(entry->frames[1], ==, 3);
+
+    entry = expert_aggregate_get_entry(agg, 1);
+    g_assert_cmpint(entry->hf_index, ==, hf_ttl_too_small);
+    g_assert_cmpstr(entry->example, ==, "Time To Live too small");
+    g_assert_true(entry->uniform);
+    g_assert_cmpuint(entry->count, ==, 2);
+
+    entry = expert_aggregate_get_entry(agg, 2);
+    g_assert_cmpstr(entry->summary, ==, "Something odd: 1");
+    entry = expert_aggregate_get_entry(agg, 3);
+    g_assert_cmpstr(entry->summary, ==, "Something odd: 2");
+
+    expert_aggregate_free(agg);
+}
+
+/*
+ * Ethernet / IPv4 / UDP / DNS response with a couple of answers. It isn't
+ * a huge tree, but it exercises the common item types and nested subtrees.
+ */
+static const uint8_t perf_frame[] = {
+    /* Ethernet */
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb,
+    0x08, 0x00,
+    /* IPv4, 20 bytes header, UDP */
+    0x45, 0x00, 0x00, 0x65, 0x12, 0x34, 0x40, 0x00, 0x40, 0x11, 0x00, 0x00,
+    0xc0, 0xa8, 0x00, 0x01, 0xc0, 0xa8, 0x00, 0x02,
+    /* UDP, 53 -> 40000 */
+    0x00, 0x35, 0x9c, 0x40, 0x00, 0x51, 0x00, 0x00,
+    /* DNS header: id, standard response, 1 question, 2 answers */
+    0xab, 0xcd, 0x81, 0x80, 0x00, 0x01, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00,
+    /* www.example.com A IN */
+    0x03, 'w', 'w', 'w', 0x07, 'e', 'x', 'a', 'm', 'p', 'l', 'e',
+    0x03, 'c', 'o', 'm', 0x00, 0x00, 0x01, 0x00, 0x01,
+    /* Answer: CNAME example.com */
+    0xc0, 0x0c, 0x00, 0x05, 0x00, 0x01, 0x00, 0x00, 0x0e, 0x10, 0x00, 0x02,
+    0xc0, 0x10,
+    /* Answer: example.com A 93.184.216.34 */
+    0xc0, 0x10, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x0e, 0x10, 0x00, 0x04,
+    0x5d, 0xb8, 0xd8, 0x22,
+};
+
+static const nstime_t *
+perf_get_frame_ts(struct packet_provider_data *prov _U_, uint32_t frame_num _U_)
+{
+    static nstime_t empty;
+
+    return &empty;
+}
+
+static double
+proto_tree_perf_run(epan_t *session, bool visible, unsigned count)
+{
+    epan_dissect_t *edt;
+    wtap_rec rec;
+    frame_data fd;
+    GTimer *timer;
+    double elapsed;
+
+    edt = epan_dissect_new(session, true, visible);
+    wtap_rec_init(&rec, sizeof(perf_frame));
+    timer = g_timer_new();
+
+    for (unsigned i = 0; i < count; i++) {
+        wtap_setup_packet_rec(&rec, WTAP_ENCAP_ETHERNET);
+        rec.presence_flags = WTAP_HAS_TS | WTAP_HAS_CAP_LEN;
+        rec.rec_header.packet_header.caplen = sizeof(perf_frame);
+        rec.rec_header.packet_header.len = sizeof(perf_frame);
+        ws_buffer_clean(&rec.data);
+        ws_buffer_append(&rec.data, perf_frame, sizeof(perf_frame));
+
+        frame_data_init(&fd, i + 1, &rec, 0, 0);
+        epan_dissect_run(edt, WTAP_FILE_TYPE_SUBTYPE_UNKNOWN, &rec, &fd, NULL);
+        frame_data_destroy(&fd);
+        epan_dissect_reset(edt);
+    }
+
+    elapsed = g_timer_elapsed(timer, NULL);
+    g_timer_destroy(timer);
+    wtap_rec_cleanup(&rec);
+    epan_dissect_free(edt);
+
+    return elapsed;
+}
+
+/* NOTE: You have to run "test_epan -m perf" to run the performance tests. */
+static void
+test_proto_tree_perf(void)
+{
+#define PERF_FRAME_COUNT (200 * 1000)
+    static const struct packet_provider_funcs funcs = {
+        .get_frame_ts = perf_get_frame_ts,
+    };
+    epan_t *session;
+    double elapsed;
+
+    test_epan_init();
+    session = epan_new(NULL, &funcs);
+
+    /* Full, visible trees, as built for the GUI details pane and tshark -V */
+    elapsed = proto_tree_perf_run(session, true, PERF_FRAME_COUNT);
+    g_test_maximized_result(PERF_FRAME_COUNT / elapsed,
+        "epan_dissect_run, visible tree: %.0f frames/s", PERF_FRAME_COUNT / elapsed);
+
+    /* Invisible trees, as built for filtering */
+    elapsed = proto_tree_perf_run(session, false, PERF_FRAME_COUNT);
+    g_test_maximized_result(PERF_FRAME_COUNT / elapsed,
+        "epan_dissect_run, invisible tree: %.0f frames/s", PERF_FRAME_COUNT / elapsed);
+
+    epan_free(session);
+#undef PERF_FRAME_COUNT
+}
+
 int main(int argc, char **argv)
 {
     int ret;
@@ -88,9 +359,18 @@ int main(int argc, char **argv)
     g_test_add_func("/label/strcat", test_label_strcat);
     g_test_add_func("/label/escape_whitespace", test_label_strcat_escape_whitespace);
     g_test_add_func("/label/escape_control", test_label_escape_control);
+    g_test_add_func("/expert/aggregate/by_summary", test_expert_aggregate_by_summary);
+    g_test_add_func("/expert/aggregate/frames", test_expert_aggregate_frames);
+    g_test_add_func("/expert/aggregate/by_field", test_expert_aggregate_by_field);
+
+    if (g_test_perf()) {
+        g_test_add_func("/proto/tree_perf", test_proto_tree_perf);
+    }
 
     ret = g_test_run();
 
+    test_epan_cleanup();
+
     return ret;
 }
 
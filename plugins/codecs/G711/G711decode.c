@@ -15,7 +15,7 @@
 #include "wsutil/codecs.h"
 #include "ws_attributes.h"
 
-static int16_t ulaw_exp_table[256] = {
+static const int16_t ulaw_exp_table[256] = {
    -32124,-31100,-30076,-29052,-28028,-27004,-25980,-24956,
    -23932,-22908,-21884,-20860,-19836,-18812,-17788,-16764,
    -15996,-15484,-14972,-14460,-13948,-13436,-12924,-12412,
@@ -50,7 +50,7 @@ static int16_t ulaw_exp_table[256] = {
        56,    48,    40,    32,    24,    16,     8,     0
 };
 
-static int16_t alaw_exp_table[256] = {
+static const int16_t alaw_exp_table[256] = {
       -5504, -5248, -6016, -5760, -4480, -4224, -4992, -4736,
       -7552, -7296, -8064, -7808, -6528, -6272, -7040, -6784,
       -2752, -2624, -3008, -2880, -2240, -2112, -2496, -2368,
@@ -182,10 +182,12 @@ codec_g711a_decode(codec_context_t *ctx _U_,
 void
 codec_register_g711(void)
 {
-    register_codec("g711U", codec_g711u_init, codec_g711u_release,
-            codec_g711u_get_channels, codec_g711u_get_frequency, codec_g711u_decode);
-    register_codec("g711A", codec_g711a_init, codec_g711a_release,
-            codec_g711a_get_channels, codec_g711a_get_frequency, codec_g711a_decode);
+    register_codec_with_flags("g711U", codec_g711u_init, codec_g711u_release,
+            codec_g711u_get_channels, codec_g711u_get_frequency, codec_g711u_decode,
+            CODEC_DECODE_THREAD_SAFE);
+    register_codec_with_flags("g711A", codec_g711a_init, codec_g711a_release,
+            codec_g711a_get_channels, codec_g711a_get_frequency, codec_g711a_decode,
+            CODEC_DECODE_THREAD_SAFE);
 }
 
 /*
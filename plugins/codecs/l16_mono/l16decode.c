@@ -96,16 +96,16 @@ codec_l16_decode(codec_context_t *ctx _U_,
 void
 codec_register_l16(void)
 {
-    register_codec("16-bit audio, monaural", codec_l16_mono_init,
+    register_codec_with_flags("16-bit audio, monaural", codec_l16_mono_init,
         codec_l16_release, codec_l16_get_channels, codec_l16_get_frequency,
-        codec_l16_decode);
+        codec_l16_decode, CODEC_DECODE_THREAD_SAFE);
 
-    register_codec("16-bit audio, stereo", codec_l16_stereo_init,
+    register_codec_with_flags("16-bit audio, stereo", codec_l16_stereo_init,
         codec_l16_release, codec_l16_get_channels, codec_l16_get_frequency,
-        codec_l16_decode);
+        codec_l16_decode, CODEC_DECODE_THREAD_SAFE);
 
-    register_codec("L16", codec_l16_init, codec_l16_release,
-        codec_l16_get_channels, codec_l16_get_frequency, codec_l16_decode);
+    register_codec_with_flags("L16", codec_l16_init, codec_l16_release,
+        codec_l16_get_channels, codec_l16_get_frequency, codec_l16_decode, CODEC_DECODE_THREAD_SAFE);
 }
 
 /*
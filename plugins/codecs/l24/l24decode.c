@@ -99,16 +99,16 @@ codec_l24_decode(codec_context_t *ctx _U_,
 void
 codec_register_l24(void)
 {
-    register_codec("24-bit audio, monaural", codec_l24_mono_init,
+    register_codec_with_flags("24-bit audio, monaural", codec_l24_mono_init,
         codec_l24_release, codec_l24_get_channels, codec_l24_get_frequency,
-        codec_l24_decode);
+        codec_l24_decode, CODEC_DECODE_THREAD_SAFE);
 
-    register_codec("24-bit audio, stereo", codec_l24_stereo_init,
+    register_codec_with_flags("24-bit audio, stereo", codec_l24_stereo_init,
         codec_l24_release, codec_l24_get_channels, codec_l24_get_frequency,
-        codec_l24_decode);
+        codec_l24_decode, CODEC_DECODE_THREAD_SAFE);
 
-    register_codec("L24", codec_l24_init, codec_l24_release,
-        codec_l24_get_channels, codec_l24_get_frequency, codec_l24_decode);
+    register_codec_with_flags("L24", codec_l24_init, codec_l24_release,
+        codec_l24_get_channels, codec_l24_get_frequency, codec_l24_decode, CODEC_DECODE_THREAD_SAFE);
 }
 
 /*
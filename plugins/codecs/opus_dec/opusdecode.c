@@ -89,8 +89,9 @@ codec_opus_decode(codec_context_t *ctx,
 void
 codec_register_opus(void)
 {
-    register_codec("opus", codec_opus_init, codec_opus_release,
-                   codec_opus_get_channels, codec_opus_get_frequency, codec_opus_decode);
+    register_codec_with_flags("opus", codec_opus_init, codec_opus_release,
+                   codec_opus_get_channels, codec_opus_get_frequency, codec_opus_decode,
+                   CODEC_DECODE_THREAD_SAFE);
 }
 
 /*
@@ -56,6 +56,8 @@
 #include <wsutil/report_message.h>
 
 #ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
 #include <wsutil/unicode-utils.h>
 #include <wsutil/win32-utils.h>
 #endif
@@ -130,11 +132,58 @@ static print_format_e print_format = PR_FMT_TEXT;
 
 static bool want_pcap_pkthdr;
 
+/*
+ * Batch mode (--batch).
+ *
+ * Input is a sequence of batches, each a uint32_t record count followed by
+ * that many records in the usual form.  For each batch we write a uint32_t
+ * row count, a uint32_t heap length, the rows, and the heap.  Every row has
+ * the same size:
+ *
+ *    0  uint32_t frame number
+ *    4  uint32_t flags (BATCH_ROW_VOID for an empty record)
+ *    8  uint64_t read filter results, bit N set if filter N matched
+ *   16  one 16-byte cell per -F field:
+ *         0  uint32_t number of occurrences in the packet
+ *         4  uint32_t length of a string value in the heap
+ *         8  value of the first occurrence, as given by the field's
+ *            batch_value_e: uint64_t, int64_t, double, int64_t
+ *            nanoseconds (saturated at INT64_MIN and INT64_MAX), or
+ *            uint32_t offset of a string in the heap
+ *
+ * Before the first batch we write a stream header: BATCH_MAGIC, then
+ * uint32_t version, field count, filter count and row size, then one
+ * uint32_t batch_value_e per field.  All integers are in host byte order,
+ * as are the record headers we read.
+ */
+typedef enum {
+    BATCH_VALUE_NONE   = 0,   /* No value (FT_NONE, FT_PROTOCOL) */
+    BATCH_VALUE_UINT   = 1,   /* Unsigned integers and booleans */
+    BATCH_VALUE_INT    = 2,   /* Signed integers */
+    BATCH_VALUE_DOUBLE = 3,   /* FT_FLOAT, FT_DOUBLE */
+    BATCH_VALUE_TIME   = 4,   /* FT_ABSOLUTE_TIME, FT_RELATIVE_TIME */
+    BATCH_VALUE_STRING = 5    /* Strings, and the filter syntax of anything else */
+} batch_value_e;
+
+#define BATCH_MAGIC         "RSB\001"
+#define BATCH_VERSION       1
+#define BATCH_ROW_HDR_LEN   16
+#define BATCH_CELL_LEN      16
+#define BATCH_ROW_VOID      0x00000001
+
+static bool batch_mode;
+static GArray *batch_value_types;   /* uint32_t batch_value_e per field */
+static GByteArray *batch_rows;
+static GByteArray *batch_heap;
+static unsigned batch_row_len;
+static unsigned batch_cur_row;      /* Offset of the current row in batch_rows */
+
 cf_status_t raw_cf_open(capture_file *cf, const char *fname);
 static bool load_cap_file(capture_file *cf);
 static bool process_packet(capture_file *cf, epan_dissect_t *edt, int64_t offset,
                                wtap_rec *rec);
 static void show_print_file_io_error(int err);
+static bool batch_write_header(void);
 
 static bool protocolinfo_init(char *field);
 static bool parse_field_string_format(char *format);
@@ -204,6 +253,7 @@ print_usage(FILE *output)
     fprintf(output, "\n");
     fprintf(output, "Output:\n");
     fprintf(output, "  -l                       flush output after each packet\n");
+    fprintf(output, "  --batch                  read and write batches using a binary protocol\n");
     fprintf(output, "  -S                       format string for fields\n");
     fprintf(output, "                           (%%D - name, %%S - stringval, %%N numval)\n");
     fprintf(output, "  -t (a|ad|adoy|d|dd|e|r|rc|u|ud|udoy)[.[N]]|.[N]\n");
@@ -415,9 +465,11 @@ main(int argc, char *argv[])
     unsigned             fc;
     bool                 skip_pcap_header = false;
     int                  ret = EXIT_SUCCESS;
+#define LONGOPT_BATCH LONGOPT_BASE_APPLICATION+1
     static const struct ws_option long_options[] = {
       {"help", ws_no_argument, NULL, 'h'},
       {"version", ws_no_argument, NULL, 'v'},
+      {"batch", ws_no_argument, NULL, LONGOPT_BATCH},
       LONGOPT_DISSECT_COMMON
       LONGOPT_READ_CAPTURE_COMMON
       LONGOPT_WSLOG
@@ -566,6 +618,9 @@ main(int argc, char *argv[])
                 print_usage(stdout);
                 goto clean_exit;
                 break;
+            case LONGOPT_BATCH:   /* Binary batch protocol */
+                batch_mode = true;
+                break;
             case 'l':        /* "Line-buffer" standard output */
                 /* This isn't line-buffering, strictly speaking, it's just
                    flushing the standard output after the information for
@@ -719,14 +774,27 @@ main(int argc, char *argv[])
        like MATE won't work. */
     prefs_apply_all();
 
+    if (batch_mode) {
+        batch_value_types = g_array_new(false, false, sizeof(uint32_t));
+        batch_rows = g_byte_array_new();
+        batch_heap = g_byte_array_new();
+#ifdef _WIN32
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    }
+
     /* Initialize our display fields */
     for (fc = 0; fc < disp_fields->len; fc++) {
         if (!protocolinfo_init((char *)g_ptr_array_index(disp_fields, fc)))
             return WS_EXIT_INVALID_OPTION;
     }
     g_ptr_array_free(disp_fields, TRUE);
-    printf("\n");
-    fflush(stdout);
+    if (batch_mode) {
+        batch_row_len = BATCH_ROW_HDR_LEN + batch_value_types->len * BATCH_CELL_LEN;
+    } else {
+        printf("\n");
+        fflush(stdout);
+    }
 
     /* If no capture filter or read filter has been specified, and there are
        still command-line arguments, treat them as the tokens of a capture
@@ -822,6 +890,11 @@ main(int argc, char *argv[])
             }
         }
 
+        if (batch_mode && !batch_write_header()) {
+            ret = WS_EXIT_OPEN_ERROR;
+            goto clean_exit;
+        }
+
         /* Process the packets in the file */
         if (!load_cap_file(&cfile)) {
             ret = WS_EXIT_OPEN_ERROR;
@@ -950,12 +1023,108 @@ raw_pipe_read(wtap_rec *rec, int *err, char **err_info, int64_t *data_offset) {
     return true;
 }
 
+/**
+ * Read the record count that starts a batch.
+ * @param count [OUT] The number of records in the batch.
+ * @param err [OUT] Error indicator; 0 at the end of the input.
+ * @param data_offset [IN/OUT] data offset in the pipe.
+ * @return true on success, false on failure or at the end of the input.
+ */
+static bool
+raw_pipe_read_batch_count(uint32_t *count, int *err, int64_t *data_offset)
+{
+    unsigned int bytes_needed = (unsigned int) sizeof(*count);
+    unsigned char *ptr = (unsigned char*) count;
+    ssize_t bytes_read;
+
+    while (bytes_needed > 0) {
+        bytes_read = ws_read(fd, ptr, bytes_needed);
+        if (bytes_read == 0) {
+            /* A clean end of input is only allowed between batches. */
+            *err = (bytes_needed == sizeof(*count)) ? 0 : WTAP_ERR_SHORT_READ;
+            return false;
+        } else if (bytes_read < 0) {
+            *err = errno;
+            return false;
+        }
+        bytes_needed -= (unsigned int)bytes_read;
+        *data_offset += bytes_read;
+        ptr += bytes_read;
+    }
+    return true;
+}
+
+static void
+batch_begin_row(uint32_t frame_num, uint32_t flags)
+{
+    batch_cur_row = batch_rows->len;
+    g_byte_array_set_size(batch_rows, batch_cur_row + batch_row_len);
+    memset(batch_rows->data + batch_cur_row, 0, batch_row_len);
+    memcpy(batch_rows->data + batch_cur_row, &frame_num, sizeof frame_num);
+    memcpy(batch_rows->data + batch_cur_row + 4, &flags, sizeof flags);
+}
+
+static void
+batch_set_filter_result(int filter_num, bool passed)
+{
+    uint64_t results;
+
+    if (!passed)
+        return;
+    memcpy(&results, batch_rows->data + batch_cur_row + 8, sizeof results);
+    results |= UINT64_C(1) << filter_num;
+    memcpy(batch_rows->data + batch_cur_row + 8, &results, sizeof results);
+}
+
+static bool
+batch_write_header(void)
+{
+    uint32_t hdr[4];
+
+    hdr[0] = BATCH_VERSION;
+    hdr[1] = batch_value_types->len;
+    hdr[2] = (uint32_t) n_rfcodes;
+    hdr[3] = batch_row_len;
+    fwrite(BATCH_MAGIC, 1, 4, stdout);
+    fwrite(hdr, sizeof hdr[0], array_length(hdr), stdout);
+    fwrite(batch_value_types->data, sizeof(uint32_t), batch_value_types->len, stdout);
+    fflush(stdout);
+    if (ferror(stdout)) {
+        show_print_file_io_error(errno);
+        return false;
+    }
+    return true;
+}
+
+/* Write out the rows and heap for the current batch and start a new one. */
+static bool
+batch_flush(void)
+{
+    uint32_t hdr[2];
+
+    hdr[0] = batch_rows->len / batch_row_len;
+    hdr[1] = batch_heap->len;
+    fwrite(hdr, sizeof hdr[0], array_length(hdr), stdout);
+    fwrite(batch_rows->data, 1, batch_rows->len, stdout);
+    fwrite(batch_heap->data, 1, batch_heap->len, stdout);
+    fflush(stdout);
+    g_byte_array_set_size(batch_rows, 0);
+    g_byte_array_set_size(batch_heap, 0);
+    if (ferror(stdout)) {
+        show_print_file_io_error(errno);
+        return false;
+    }
+    return true;
+}
+
 static bool
 load_cap_file(capture_file *cf)
 {
     int          err;
     char        *err_info = NULL;
     int64_t      data_offset = 0;
+    uint32_t     batch_count, i;
+    bool         write_ok = true;
 
     wtap_rec     rec;
     epan_dissect_t edt;
@@ -964,8 +1133,32 @@ load_cap_file(capture_file *cf)
 
     epan_dissect_init(&edt, cf->epan, true, false);
 
-    while (raw_pipe_read(&rec, &err, &err_info, &data_offset)) {
-        process_packet(cf, &edt, data_offset, &rec);
+    if (batch_mode) {
+        /*
+         * Answer each batch with one write, however many records it
+         * holds; an empty batch just gets an empty answer.
+         */
+        while (raw_pipe_read_batch_count(&batch_count, &err, &data_offset)) {
+            err = 0;
+            for (i = 0; i < batch_count; i++) {
+                if (!raw_pipe_read(&rec, &err, &err_info, &data_offset)) {
+                    if (err == 0)
+                        err = WTAP_ERR_SHORT_READ;
+                    break;
+                }
+                process_packet(cf, &edt, data_offset, &rec);
+            }
+            if (err != 0)
+                break;
+            if (!batch_flush()) {
+                write_ok = false;
+                break;
+            }
+        }
+    } else {
+        while (raw_pipe_read(&rec, &err, &err_info, &data_offset)) {
+            process_packet(cf, &edt, data_offset, &rec);
+        }
     }
 
     epan_dissect_cleanup(&edt);
@@ -977,7 +1170,7 @@ load_cap_file(capture_file *cf)
         return false;
     }
 
-    return true;
+    return write_ok;
 }
 
 static bool
@@ -993,6 +1186,10 @@ process_packet(capture_file *cf, epan_dissect_t *edt, int64_t offset,
         /* The user sends an empty packet when he wants to get output from us even if we don't currently have
            packets to process. We spit out a line with the timestamp and the text "void"
         */
+        if (batch_mode) {
+            batch_begin_row((uint32_t) cf->count, BATCH_ROW_VOID);
+            return false;
+        }
         printf("%lu %" PRIu64 " %d void -\n", (unsigned long int)cf->count,
                (uint64_t)rec->ts.secs, rec->ts.nsecs);
 
@@ -1019,7 +1216,10 @@ process_packet(capture_file *cf, epan_dissect_t *edt, int64_t offset,
         }
     }
 
-    printf("%lu", (unsigned long int) cf->count);
+    if (batch_mode)
+        batch_begin_row((uint32_t) cf->count, 0);
+    else
+        printf("%lu", (unsigned long int) cf->count);
 
     frame_data_set_before_dissect(&fdata, &cf->elapsed_time,
                                   &cf->provider.ref, cf->provider.prev_dis);
@@ -1049,7 +1249,17 @@ process_packet(capture_file *cf, epan_dissect_t *edt, int64_t offset,
             passed = true;
 
         /* Print a one-line summary */
-        printf(" %d", passed ? 1 : 0);
+        if (batch_mode)
+            batch_set_filter_result(i, passed);
+        else
+            printf(" %d", passed ? 1 : 0);
+    }
+
+    if (batch_mode) {
+        /* The whole batch is written at once by load_cap_file(). */
+        epan_dissect_reset(edt);
+        frame_data_destroy(&fdata);
+        return passed;
     }
 
     printf(" -\n");
@@ -1268,6 +1478,87 @@ static bool print_field_value(field_info *finfo, int cmd_line_index)
     return true;
 }
 
+static batch_value_e
+batch_value_type(enum ftenum type)
+{
+    if (FT_IS_UINT(type) || type == FT_BOOLEAN)
+        return BATCH_VALUE_UINT;
+    if (FT_IS_INT(type))
+        return BATCH_VALUE_INT;
+    if (FT_IS_FLOATING(type))
+        return BATCH_VALUE_DOUBLE;
+    if (FT_IS_TIME(type))
+        return BATCH_VALUE_TIME;
+    if (type == FT_NONE || type == FT_PROTOCOL)
+        return BATCH_VALUE_NONE;
+    return BATCH_VALUE_STRING;
+}
+
+/*
+ * Fill in the current row's cell for a field: the number of occurrences
+ * and the value of the first one.
+ */
+static void
+batch_store_field(const pci_t *rs, GPtrArray *gp)
+{
+    uint8_t *cell = batch_rows->data + batch_cur_row + BATCH_ROW_HDR_LEN + rs->cmd_line_index * BATCH_CELL_LEN;
+    field_info *finfo = (field_info *)gp->pdata[0];
+    enum ftenum type = fvalue_type_ftenum(finfo->value);
+    uint32_t count = gp->len;
+    uint32_t len = 0;
+    uint64_t value = 0;
+    int64_t svalue;
+    double dvalue;
+    const nstime_t *ts;
+    const char *str;
+    char *str_buf = NULL;
+
+    switch (g_array_index(batch_value_types, uint32_t, rs->cmd_line_index)) {
+        case BATCH_VALUE_UINT:
+            value = FT_IS_UINT32(type) ? fvalue_get_uinteger(finfo->value) : fvalue_get_uinteger64(finfo->value);
+            break;
+        case BATCH_VALUE_INT:
+            svalue = FT_IS_INT32(type) ? fvalue_get_sinteger(finfo->value) : fvalue_get_sinteger64(finfo->value);
+            memcpy(&value, &svalue, sizeof value);
+            break;
+        case BATCH_VALUE_DOUBLE:
+            dvalue = fvalue_get_floating(finfo->value);
+            memcpy(&value, &dvalue, sizeof value);
+            break;
+        case BATCH_VALUE_TIME:
+            ts = fvalue_get_time(finfo->value);
+            /* Saturate times that don't fit, about 292 years from the epoch. */
+            if ((int64_t)ts->secs >= INT64_MAX / 1000000000)
+                svalue = INT64_MAX;
+            else if ((int64_t)ts->secs <= INT64_MIN / 1000000000)
+                svalue = INT64_MIN;
+            else
+                svalue = (int64_t)ts->secs * 1000000000 + ts->nsecs;
+            memcpy(&value, &svalue, sizeof value);
+            break;
+        case BATCH_VALUE_STRING:
+            if (FT_IS_STRING(type) && type != FT_AX25) {
+                str = fvalue_get_string(finfo->value);
+            } else {
+                str_buf = fvalue_to_string_repr(NULL, finfo->value, FTREPR_DFILTER, finfo->hfinfo->display);
+                str = str_buf;
+            }
+            if (str != NULL) {
+                value = batch_heap->len;
+                len = (uint32_t) strlen(str);
+                g_byte_array_append(batch_heap, (const uint8_t *)str, len);
+            }
+            wmem_free(NULL, str_buf);
+            break;
+        default:
+            break;
+    }
+
+    memcpy(cell, &count, sizeof count);
+    memcpy(cell + 4, &len, sizeof len);
+    memcpy(cell + 8, &value, sizeof value);
+}
+
 static tap_packet_status
 protocolinfo_packet(void *prs, packet_info *pinfo _U_, epan_dissect_t *edt, const void *dummy _U_, tap_flags_t flags _U_)
 {
@@ -1276,6 +1567,12 @@ protocolinfo_packet(void *prs, packet_info *pinfo _U_, epan_dissect_t *edt, cons
     unsigned i;
 
     gp=proto_get_finfo_ptr_array(edt->tree, rs->hf_index);
+    if (batch_mode) {
+        /* A field that isn't there keeps its zeroed cell. */
+        if (gp && gp->len > 0)
+            batch_store_field(rs, gp);
+        return TAP_PACKET_DONT_REDRAW;
+    }
     if(!gp){
         printf(" n.a.");
         return TAP_PACKET_DONT_REDRAW;
@@ -1310,11 +1607,17 @@ protocolinfo_init(char *field)
         return false;
     }
 
-    field_display_to_string(hfi, hfibuf, sizeof(hfibuf));
-    printf("%d %s %s - ",
-            g_cmd_line_index,
-            ftenum_to_string(hfi),
-            hfibuf);
+    if (batch_mode) {
+        /* The types go in the binary stream header instead. */
+        uint32_t value_type = batch_value_type(hfi->type);
+        g_array_append_val(batch_value_types, value_type);
+    } else {
+        field_display_to_string(hfi, hfibuf, sizeof(hfibuf));
+        printf("%d %s %s - ",
+                g_cmd_line_index,
+                ftenum_to_string(hfi),
+                hfibuf);
+    }
 
     rs=g_new(pci_t, 1);
     rs->hf_index=hfi->id;
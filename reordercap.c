@@ -27,6 +27,7 @@
 #include <wsutil/file_util.h>
 #include <wsutil/privileges.h>
 #include <wsutil/report_message.h>
+#include <wsutil/str_util.h>
 #include <wsutil/version_info.h>
 #include <wiretap/wtap_opttypes.h>
 
@@ -51,6 +52,13 @@ print_usage(FILE *output)
     fprintf(output, "\n");
     fprintf(output, "Options:\n");
     fprintf(output, "  -n                don't write to output file if the input file is ordered.\n");
+    fprintf(output, "  -w <frames>       reorder in a single sequential pass, holding at most\n");
+    fprintf(output, "                    <frames> frames in memory.\n");
+    fprintf(output, "  -W <seconds>      reorder in a single sequential pass, holding frames until\n");
+    fprintf(output, "                    they are <seconds> older than the newest frame read.\n");
+    fprintf(output, "                    With -w and/or -W, frames that arrive too late to be\n");
+    fprintf(output, "                    placed in order start a new sorted run in a temporary\n");
+    fprintf(output, "                    file, and the runs are merged at the end.\n");
     fprintf(output, "  -h, --help        display this help and exit.\n");
     fprintf(output, "  -v, --version     print version information and exit.\n");
 }
@@ -134,6 +142,591 @@ frames_compare(const void *a, const void *b)
     return nstime_cmp(time1, time2);
 }
 
+/********************************************************************/
+/* Windowed (streaming) reordering                                  */
+/********************************************************************/
+
+/* A frame held in the reorder window, read straight into its own record */
+typedef struct WindowFrame_t {
+    wtap_rec     rec;
+    unsigned     num;
+    nstime_t     frame_time;
+} WindowFrame_t;
+
+/*
+ * Most runs merged at once. Each one is an open file, so the runs are
+ * merged in passes of at most this many until there are few enough to
+ * merge into the output.
+ */
+#define MAX_MERGE_FAN_IN 64
+
+/* State for writing sorted runs to temporary files */
+typedef struct RunWriter_t {
+    wtap             *wth;
+    const char       *infile;
+    const char       *tmpdir;
+    int               file_type_subtype;
+    wtap_dump_params  params;
+    GArray           *idbs_seen;   /* wtap_block_t, all IDBs read so far */
+    GPtrArray        *run_names;   /* char *, one temporary file per run */
+    wtap_dumper      *pdh;         /* the run being written */
+    nstime_t          last_time;   /* time of the last timed frame in the current run */
+    bool              have_last_time;
+} RunWriter_t;
+
+/* Order by time, and frames with equal times by their position in the file */
+static int
+window_frames_compare(const WindowFrame_t *frame1, const WindowFrame_t *frame2)
+{
+    int cmp = nstime_cmp(&frame1->frame_time, &frame2->frame_time);
+
+    if (cmp != 0)
+        return cmp;
+    return (frame1->num > frame2->num) - (frame1->num < frame2->num);
+}
+
+/* Binary min-heap of WindowFrame_t pointers */
+static void
+window_heap_push(GPtrArray *heap, WindowFrame_t *frame)
+{
+    unsigned i = heap->len;
+
+    g_ptr_array_add(heap, frame);
+    while (i > 0) {
+        unsigned parent = (i - 1) / 2;
+        if (window_frames_compare((WindowFrame_t *)heap->pdata[parent], frame) <= 0)
+            break;
+        heap->pdata[i] = heap->pdata[parent];
+        i = parent;
+    }
+    heap->pdata[i] = frame;
+}
+
+static WindowFrame_t *
+window_heap_pop(GPtrArray *heap)
+{
+    WindowFrame_t *top = (WindowFrame_t *)heap->pdata[0];
+    WindowFrame_t *last = (WindowFrame_t *)heap->pdata[heap->len - 1];
+    unsigned i = 0;
+
+    g_ptr_array_set_size(heap, heap->len - 1);
+    if (heap->len == 0)
+        return top;
+
+    for (;;) {
+        unsigned child = 2 * i + 1;
+        if (child >= heap->len)
+            break;
+        if (child + 1 < heap->len &&
+            window_frames_compare((WindowFrame_t *)heap->pdata[child + 1], (WindowFrame_t *)heap->pdata[child]) < 0)
+            child++;
+        if (window_frames_compare(last, (WindowFrame_t *)heap->pdata[child]) <= 0)
+            break;
+        heap->pdata[i] = heap->pdata[child];
+        i = child;
+    }
+    heap->pdata[i] = last;
+    return top;
+}
+
+/*
+ * Add all the IDBs read so far to a dump file. Every run, and every file
+ * runs are merged into, starts with the same IDBs, in the order they were
+ * read, so the runs' interface IDs mean the same thing in all of them.
+ */
+static bool
+run_add_all_idbs(RunWriter_t *writer, wtap_dumper *pdh, const char *filename)
+{
+    int    err;
+    char  *err_info;
+
+    if (wtap_file_type_subtype_supports_block(writer->file_type_subtype,
+                                              WTAP_BLOCK_IF_ID_AND_INFO) == BLOCK_NOT_SUPPORTED)
+        return true;
+
+    for (unsigned i = 0; i < writer->idbs_seen->len; i++) {
+        if (!wtap_dump_add_idb(pdh, g_array_index(writer->idbs_seen, wtap_block_t, i),
+                               &err, &err_info)) {
+            report_cfile_write_failure(writer->infile, filename, err, err_info, 0,
+                                       writer->file_type_subtype);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool
+run_open(RunWriter_t *writer)
+{
+    char  *run_name;
+    int    err;
+    char  *err_info;
+
+    writer->pdh = wtap_dump_open_tempfile(writer->tmpdir, &run_name, "reordercap",
+                                          writer->file_type_subtype, WS_FILE_UNCOMPRESSED,
+                                          &writer->params, &err, &err_info);
+    if (writer->pdh == NULL) {
+        report_cfile_dump_open_failure(run_name ? run_name : "temporary file",
+                                       err, err_info, writer->file_type_subtype);
+        g_free(run_name);
+        return false;
+    }
+    g_ptr_array_add(writer->run_names, run_name);
+    writer->have_last_time = false;
+
+    return run_add_all_idbs(writer, writer->pdh, run_name);
+}
+
+static bool
+run_close(RunWriter_t *writer)
+{
+    int    err;
+    char  *err_info;
+    bool   ok;
+
+    if (writer->pdh == NULL)
+        return true;
+
+    ok = wtap_dump_close(writer->pdh, NULL, &err, &err_info);
+    if (!ok) {
+        report_cfile_close_failure((const char *)g_ptr_array_index(writer->run_names, writer->run_names->len - 1),
+                                   err, err_info);
+    }
+    writer->pdh = NULL;
+    return ok;
+}
+
+/* Add any IDBs read since the last call to the current run */
+static bool
+run_add_new_idbs(RunWriter_t *writer)
+{
+    wtap_block_t if_data;
+    int          err;
+    char        *err_info;
+
+    while ((if_data = wtap_get_next_interface_description(writer->wth)) != NULL) {
+        if (wtap_file_type_subtype_supports_block(writer->file_type_subtype,
+                                                  WTAP_BLOCK_IF_ID_AND_INFO) == BLOCK_NOT_SUPPORTED)
+            continue;
+
+        /* wtap_dump_add_idb() makes its own copy. */
+        if (writer->pdh != NULL && !wtap_dump_add_idb(writer->pdh, if_data, &err, &err_info)) {
+            report_cfile_write_failure(writer->infile,
+                                       (const char *)g_ptr_array_index(writer->run_names, writer->run_names->len - 1),
+                                       err, err_info, 0, writer->file_type_subtype);
+            return false;
+        }
+        if_data = wtap_block_make_copy(if_data);
+        g_array_append_val(writer->idbs_seen, if_data);
+    }
+    return true;
+}
+
+/*
+ * Write a frame to the current run, starting a new run if it's out of order.
+ * Frames without a time stamp can't be out of order; they stay in the
+ * current run, and the next timed frame is compared with the last timed one.
+ */
+static bool
+run_write(RunWriter_t *writer, WindowFrame_t *frame)
+{
+    int    err;
+    char  *err_info;
+    bool   timed = !nstime_is_unset(&frame->frame_time);
+
+    if (timed && writer->have_last_time && nstime_cmp(&frame->frame_time, &writer->last_time) < 0) {
+        DEBUG_PRINT("Frame %u is outside the window, starting run %u\n",
+                    frame->num, writer->run_names->len + 1);
+        if (!run_close(writer) || !run_open(writer))
+            return false;
+    }
+
+    if (!wtap_dump(writer->pdh, &frame->rec, &err, &err_info)) {
+        report_cfile_write_failure(writer->infile,
+                                   (const char *)g_ptr_array_index(writer->run_names, writer->run_names->len - 1),
+                                   err, err_info, frame->num, writer->file_type_subtype);
+        return false;
+    }
+    if (timed) {
+        writer->last_time = frame->frame_time;
+        writer->have_last_time = true;
+    }
+    return true;
+}
+
+/* Read the next record of a run being merged */
+static bool
+run_read(wtap *run, const char *run_name, wtap_rec *rec, bool *have_rec)
+{
+    int      err;
+    char    *err_info;
+    int64_t  data_offset;
+
+    *have_rec = wtap_read(run, rec, &err, &err_info, &data_offset);
+    if (!*have_rec && err != 0) {
+        report_cfile_read_failure(run_name, err, err_info);
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Merge runs into a dump file opened with the input file's parameters.
+ *
+ * This isn't done with merge_files(), as that writes a new SHB describing
+ * the merge instead of the input file's, and its IDB merging can renumber
+ * interfaces. Only the runs' frames are read; the output gets its SHB,
+ * IDBs, and other blocks from the input file, as each run did.
+ *
+ * Frames without a time stamp are written as soon as they're next in
+ * their run, as the run was written; frames with equal times are taken
+ * from the earliest run.
+ */
+static bool
+runs_merge(RunWriter_t *writer, char *const *run_names, unsigned count,
+           wtap_dumper *pdh, const char *out_name)
+{
+    wtap     **runs = g_new0(wtap *, count);
+    wtap_rec  *recs = g_new(wtap_rec, count);
+    bool      *have_rec = g_new0(bool, count);
+    int        err;
+    char      *err_info;
+    unsigned   i;
+    bool       ok = true;
+
+    for (i = 0; i < count; i++) {
+        wtap_rec_init(&recs[i], DEFAULT_INIT_BUFFER_SIZE_2048);
+    }
+    for (i = 0; i < count && ok; i++) {
+        runs[i] = wtap_open_offline(run_names[i], WTAP_TYPE_AUTO, &err, &err_info, false,
+                                    application_configuration_environment_prefix());
+        if (runs[i] == NULL) {
+            report_cfile_open_failure(run_names[i], err, err_info);
+            ok = false;
+        } else {
+            ok = run_read(runs[i], run_names[i], &recs[i], &have_rec[i]);
+        }
+    }
+
+    while (ok) {
+        unsigned next = count;
+
+        for (i = 0; i < count; i++) {
+            if (!have_rec[i])
+                continue;
+            if (!(recs[i].presence_flags & WTAP_HAS_TS)) {
+                next = i;
+                break;
+            }
+            if (next == count || nstime_cmp(&recs[i].ts, &recs[next].ts) < 0)
+                next = i;
+        }
+        if (next == count)
+            break;
+
+        if (!wtap_dump(pdh, &recs[next], &err, &err_info)) {
+            report_cfile_write_failure(run_names[next], out_name, err, err_info, 0,
+                                       writer->file_type_subtype);
+            ok = false;
+            break;
+        }
+        wtap_rec_reset(&recs[next]);
+        ok = run_read(runs[next], run_names[next], &recs[next], &have_rec[next]);
+    }
+
+    for (i = 0; i < count; i++) {
+        if (runs[i] != NULL)
+            wtap_close(runs[i]);
+        wtap_rec_cleanup(&recs[i]);
+    }
+    g_free(have_rec);
+    g_free(recs);
+    g_free(runs);
+    return ok;
+}
+
+/* Merge runs into a dump file, and close it */
+static bool
+runs_merge_and_close(RunWriter_t *writer, char *const *run_names, unsigned count,
+                     wtap_dumper *pdh, const char *out_name)
+{
+    int    err;
+    char  *err_info;
+    bool   ok;
+
+    ok = run_add_all_idbs(writer, pdh, out_name) &&
+         runs_merge(writer, run_names, count, pdh, out_name);
+    if (!wtap_dump_close(pdh, NULL, &err, &err_info)) {
+        if (ok)
+            report_cfile_close_failure(out_name, err, err_info);
+        else
+            g_free(err_info);
+        ok = false;
+    }
+    return ok;
+}
+
+/*
+ * Merge the runs, MAX_MERGE_FAN_IN at a time, into new temporary files
+ * until no more than MAX_MERGE_FAN_IN are left. The runs merged are
+ * removed, and replaced in run_names by the files they were merged into.
+ */
+static bool
+runs_reduce(RunWriter_t *writer)
+{
+    while (writer->run_names->len > MAX_MERGE_FAN_IN) {
+        GPtrArray *merged = g_ptr_array_new_with_free_func(g_free);
+
+        for (unsigned first = 0; first < writer->run_names->len; first += MAX_MERGE_FAN_IN) {
+            unsigned     count = MIN(MAX_MERGE_FAN_IN, writer->run_names->len - first);
+            char        *merged_name = NULL;
+            wtap_dumper *pdh;
+            int          err;
+            char        *err_info;
+
+            if (count == 1) {
+                /* Nothing to merge it with; carry it over to the next pass. */
+                g_ptr_array_add(merged, g_strdup((const char *)g_ptr_array_index(writer->run_names, first)));
+                continue;
+            }
+            pdh = wtap_dump_open_tempfile(writer->tmpdir, &merged_name, "reordercap",
+                                          writer->file_type_subtype, WS_FILE_UNCOMPRESSED,
+                                          &writer->params, &err, &err_info);
+            if (pdh == NULL) {
+                report_cfile_dump_open_failure(merged_name ? merged_name : "temporary file",
+                                               err, err_info, writer->file_type_subtype);
+            }
+            if (pdh == NULL ||
+                !runs_merge_and_close(writer, (char *const *)&writer->run_names->pdata[first], count,
+                                      pdh, merged_name)) {
+                /* Leave everything in run_names, so that it's all removed. */
+                if (merged_name != NULL) {
+                    g_ptr_array_add(merged, merged_name);
+                }
+                for (unsigned i = 0; i < merged->len; i++) {
+                    g_ptr_array_add(writer->run_names, g_strdup((const char *)g_ptr_array_index(merged, i)));
+                }
+                g_ptr_array_free(merged, true);
+                return false;
+            }
+            g_ptr_array_add(merged, merged_name);
+            for (unsigned i = first; i < first + count; i++) {
+                ws_unlink((const char *)g_ptr_array_index(writer->run_names, i));
+            }
+        }
+
+        g_ptr_array_free(writer->run_names, true);
+        writer->run_names = merged;
+    }
+    return true;
+}
+
+/* Is the oldest frame in the heap due to be written? */
+static bool
+window_is_full(GPtrArray *heap, unsigned window_frames, double window_secs,
+               const nstime_t *newest_time)
+{
+    const WindowFrame_t *oldest;
+    nstime_t             delta;
+
+    if (heap->len == 0)
+        return false;
+    if (window_frames != 0 && heap->len > window_frames)
+        return true;
+    if (window_secs <= 0.0)
+        return false;
+
+    oldest = (const WindowFrame_t *)heap->pdata[0];
+    if (nstime_is_unset(&oldest->frame_time)) {
+        /* Frames without a time stamp sort first; there's no point holding them. */
+        return true;
+    }
+    if (nstime_is_unset(newest_time))
+        return false;
+    nstime_delta(&delta, newest_time, &oldest->frame_time);
+    return nstime_to_sec(&delta) > window_secs;
+}
+
+/*
+ * Reorder the frames in a single sequential pass over the input. Frames
+ * are held in a min-heap until the window is full and then written in time
+ * order, so frames that are out of order by less than the window come out
+ * sorted without seeking in the input. A frame that is older than the last
+ * one written starts a new run; if there's more than one run, the runs are
+ * merged into the output file at the end.
+ */
+static int
+reorder_window(wtap *wth, const char *infile, const char *outfile,
+               unsigned window_frames, double window_secs,
+               bool write_output_regardless)
+{
+    RunWriter_t    writer;
+    GPtrArray     *heap;
+    GPtrArray     *free_frames;
+    WindowFrame_t *frame;
+    nstime_t       newest_time;
+    nstime_t       prev_time;
+    unsigned       num_frames = 0;
+    unsigned       wrong_order_count = 0;
+    int            err;
+    char          *err_info;
+    int64_t        data_offset;
+    char          *outdir = NULL;
+    int            ret = EXIT_SUCCESS;
+
+    memset(&writer, 0, sizeof writer);
+    writer.wth = wth;
+    writer.infile = infile;
+    writer.file_type_subtype = wtap_file_type_subtype(wth);
+    wtap_dump_params_init_no_idbs(&writer.params, wth);
+    writer.idbs_seen = g_array_new(false, false, sizeof(wtap_block_t));
+    writer.run_names = g_ptr_array_new_with_free_func(g_free);
+
+    /* Keep the runs next to the output file, where there's presumably room for it. */
+    if (strcmp(outfile, "-") != 0) {
+        outdir = get_dirname(g_strdup(outfile));
+        writer.tmpdir = outdir;
+    }
+
+    heap = g_ptr_array_new();
+    free_frames = g_ptr_array_new();
+    nstime_set_unset(&newest_time);
+    nstime_set_unset(&prev_time);
+
+    if (!run_add_new_idbs(&writer) || !run_open(&writer)) {
+        ret = OUTPUT_FILE_ERROR;
+        goto cleanup;
+    }
+
+    for (;;) {
+        if (free_frames->len > 0) {
+            frame = (WindowFrame_t *)free_frames->pdata[free_frames->len - 1];
+            g_ptr_array_set_size(free_frames, free_frames->len - 1);
+        } else {
+            frame = g_new(WindowFrame_t, 1);
+            wtap_rec_init(&frame->rec, DEFAULT_INIT_BUFFER_SIZE_2048);
+        }
+
+        if (!wtap_read(wth, &frame->rec, &err, &err_info, &data_offset)) {
+            g_ptr_array_add(free_frames, frame);
+            break;
+        }
+        if (!run_add_new_idbs(&writer)) {
+            ret = OUTPUT_FILE_ERROR;
+            goto cleanup;
+        }
+
+        frame->num = ++num_frames;
+        if (frame->rec.presence_flags & WTAP_HAS_TS) {
+            frame->frame_time = frame->rec.ts;
+        } else {
+            nstime_set_unset(&frame->frame_time);
+        }
+        if (!nstime_is_unset(&frame->frame_time)) {
+            if (!nstime_is_unset(&prev_time) && nstime_cmp(&frame->frame_time, &prev_time) < 0) {
+                wrong_order_count++;
+            }
+            prev_time = frame->frame_time;
+        }
+        if (!nstime_is_unset(&frame->frame_time) &&
+            (nstime_is_unset(&newest_time) || nstime_cmp(&frame->frame_time, &newest_time) > 0)) {
+            newest_time = frame->frame_time;
+        }
+        window_heap_push(heap, frame);
+
+        while (window_is_full(heap, window_frames, window_secs, &newest_time)) {
+            frame = window_heap_pop(heap);
+            if (!run_write(&writer, frame)) {
+                g_ptr_array_add(free_frames, frame);
+                ret = OUTPUT_FILE_ERROR;
+                goto cleanup;
+            }
+            wtap_rec_reset(&frame->rec);
+            g_ptr_array_add(free_frames, frame);
+        }
+    }
+    if (err != 0) {
+        /* Print a message noting that the read failed somewhere along the line. */
+        report_cfile_read_failure(infile, err, err_info);
+    }
+
+    /* Drain the window */
+    while (heap->len > 0) {
+        frame = window_heap_pop(heap);
+        g_ptr_array_add(free_frames, frame);
+        if (!run_write(&writer, frame)) {
+            ret = OUTPUT_FILE_ERROR;
+            goto cleanup;
+        }
+        wtap_rec_reset(&frame->rec);
+    }
+    if (!run_close(&writer)) {
+        ret = OUTPUT_FILE_ERROR;
+        goto cleanup;
+    }
+
+    printf("%u frames, %u out of order, %u sorted run%s\n", num_frames, wrong_order_count,
+           writer.run_names->len, plurality(writer.run_names->len, "", "s"));
+
+    if (!write_output_regardless && wrong_order_count == 0) {
+        printf("Not writing output file because input file is already in order.\n");
+    } else if (!runs_reduce(&writer)) {
+        ret = OUTPUT_FILE_ERROR;
+    } else {
+        /*
+         * Even a single run is copied rather than renamed, so that the
+         * output file is created like any other, not with the temporary
+         * file's permissions.
+         */
+        wtap_dumper *pdh;
+
+        if (strcmp(outfile, "-") == 0) {
+            pdh = wtap_dump_open_stdout(writer.file_type_subtype, WS_FILE_UNCOMPRESSED,
+                                        &writer.params, &err, &err_info);
+        } else {
+            pdh = wtap_dump_open(outfile, writer.file_type_subtype, WS_FILE_UNCOMPRESSED,
+                                 &writer.params, &err, &err_info);
+        }
+        if (pdh == NULL) {
+            report_cfile_dump_open_failure(outfile, err, err_info, writer.file_type_subtype);
+            ret = OUTPUT_FILE_ERROR;
+        } else if (!runs_merge_and_close(&writer, (char *const *)writer.run_names->pdata,
+                                         writer.run_names->len, pdh, outfile)) {
+            ret = OUTPUT_FILE_ERROR;
+        }
+    }
+
+cleanup:
+    if (writer.pdh != NULL) {
+        wtap_dump_close(writer.pdh, NULL, &err, &err_info);
+        g_free(err_info);
+    }
+    for (unsigned i = 0; i < writer.run_names->len; i++) {
+        ws_unlink((const char *)g_ptr_array_index(writer.run_names, i));
+    }
+    g_ptr_array_free(writer.run_names, true);
+
+    for (unsigned i = 0; i < heap->len; i++) {
+        g_ptr_array_add(free_frames, heap->pdata[i]);
+    }
+    g_ptr_array_free(heap, true);
+    for (unsigned i = 0; i < free_frames->len; i++) {
+        frame = (WindowFrame_t *)free_frames->pdata[i];
+        wtap_rec_cleanup(&frame->rec);
+        g_free(frame);
+    }
+    g_ptr_array_free(free_frames, true);
+
+    for (unsigned i = 0; i < writer.idbs_seen->len; i++) {
+        wtap_block_unref(g_array_index(writer.idbs_seen, wtap_block_t, i));
+    }
+    g_array_free(writer.idbs_seen, true);
+    wtap_dump_params_cleanup(&writer.params);
+    g_free(outdir);
+
+    return ret;
+}
+
 /********************************************************************/
 /* Main function.                                                   */
 /********************************************************************/
@@ -152,6 +745,8 @@ main(int argc, char *argv[])
     unsigned i;
     wtap_dump_params params;
     int                          ret = EXIT_SUCCESS;
+    uint32_t window_frames = 0;
+    double window_secs = 0.0;
 
     GPtrArray *frames;
     FrameRecord_t *prevFrame = NULL;
@@ -163,7 +758,7 @@ main(int argc, char *argv[])
         LONGOPT_WSLOG
         {0, 0, 0, 0 }
     };
-#define OPTSTRING "hnv"
+#define OPTSTRING "hnvw:W:"
     static const char optstring[] = OPTSTRING;
     int file_count;
     char *infile;
@@ -215,6 +810,18 @@ main(int argc, char *argv[])
             case 'n':
                 write_output_regardless = false;
                 break;
+            case 'w':
+                if (!get_nonzero_uint32(ws_optarg, "window size", &window_frames)) {
+                    ret = WS_EXIT_INVALID_OPTION;
+                    goto clean_exit;
+                }
+                break;
+            case 'W':
+                if (!get_positive_double(ws_optarg, "window time", &window_secs)) {
+                    ret = WS_EXIT_INVALID_OPTION;
+                    goto clean_exit;
+                }
+                break;
             case 'h':
                 show_help_header("Reorder timestamps of input file frames into output file.");
                 print_usage(stdout);
@@ -257,6 +864,13 @@ main(int argc, char *argv[])
     }
     DEBUG_PRINT("file_type_subtype is %d\n", wtap_file_type_subtype(wth));
 
+    if (window_frames != 0 || window_secs > 0.0) {
+        ret = reorder_window(wth, infile, outfile, window_frames, window_secs,
+                             write_output_regardless);
+        wtap_close(wth);
+        goto clean_exit;
+    }
+
     /* Allocate the array of frame pointers. */
     frames = g_ptr_array_new();
 
@@ -291,6 +905,9 @@ main(int argc, char *argv[])
     printf("%u frames, %u out of order\n", frames->len, wrong_order_count);
 
     wtap_dump_params_init(&params, wth);
+    /* Write while we're seeking around the input file for the next frame. */
+    params.buffered = true;
+    params.async_flush = true;
 
     /* Sort the frames */
     /* XXX - Does this handle multiple SHBs correctly? */
@@ -41,6 +41,7 @@
 #include <epan/stats_tree_priv.h>
 #include <epan/stat_tap_ui.h>
 #include <epan/conversation_table.h>
+#include <epan/dissector_profile.h>
 #include <epan/sequence_analysis.h>
 #include <epan/expert.h>
 #include <epan/export_object.h>
@@ -1398,6 +1399,15 @@ sharkd_session_process_load(const char *buf, const jsmntok_t *tokens, int count)
  *                      'format'   - column format (%x or %Cus:<expr>:<occurrence> if COL_CUSTOM)
  *                      'visible'  - true if column is visible
  *                      'display'  - column display format; 'U', 'R' or 'D'
+ *   (o) dissector_profile - present if dissector profiling is enabled (WIRESHARK_DISSECTOR_PROFILE),
+ *                      array of object with attributes, sorted by exclusive time:
+ *                      'proto'         - protocol filter name
+ *                      'calls'         - number of dissector calls
+ *                      'inclusive_ns'  - time spent, including subdissectors, in nanoseconds
+ *                      'exclusive_ns'  - time spent, excluding subdissectors, in nanoseconds
+ *                      'heur_attempts' - number of heuristic attempts
+ *                      'heur_hits'     - number of heuristic attempts that accepted the packet
+ *                      'alloc_bytes'   - bytes allocated, excluding subdissectors
  */
 static void
 sharkd_session_process_status(void)
@@ -1451,6 +1461,30 @@ sharkd_session_process_status(void)
         sharkd_json_array_close();
     }
 
+    if (dissector_profile_is_enabled())
+    {
+        GArray *stats = dissector_profile_get_stats();
+
+        sharkd_json_array_open("dissector_profile");
+        for (unsigned i = 0; i < stats->len; ++i)
+        {
+            dissector_profile_stat_t *stat = &g_array_index(stats, dissector_profile_stat_t, i);
+
+            sharkd_json_object_open(NULL);
+            sharkd_json_value_string("proto", proto_get_protocol_filter_name(stat->proto_id));
+            sharkd_json_value_anyf("calls", "%" PRIu64, stat->calls);
+            sharkd_json_value_anyf("inclusive_ns", "%" PRIu64, stat->inclusive_ns);
+            sharkd_json_value_anyf("exclusive_ns", "%" PRIu64, stat->exclusive_ns);
+            sharkd_json_value_anyf("heur_attempts", "%" PRIu64, stat->heur_attempts);
+            sharkd_json_value_anyf("heur_hits", "%" PRIu64, stat->heur_hits);
+            sharkd_json_value_anyf("alloc_bytes", "%" PRIu64, stat->alloc_bytes);
+            sharkd_json_object_close();
+        }
+        sharkd_json_array_close();
+
+        g_array_free(stats, true);
+    }
+
     sharkd_json_result_epilogue();
 }
 
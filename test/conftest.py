@@ -164,6 +164,11 @@ def cmd_editcap(program):
     return program('editcap')
 
 
+@pytest.fixture(scope='session')
+def cmd_reordercap(program):
+    return program('reordercap')
+
+
 @pytest.fixture(scope='session')
 def cmd_wireshark(program):
     return program('wireshark')
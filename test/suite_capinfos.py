@@ -0,0 +1,53 @@
+#
+# Wireshark tests
+#
+# SPDX-License-Identifier: GPL-2.0-or-later
+#
+'''Capinfos tests'''
+
+import subprocess
+
+import pytest
+
+capinfos_files = (
+    'dhcp.pcap',
+    'dhcp.pcapng',
+    'dhcp-nanosecond.pcap',
+    'comments.pcapng',
+    'dns-ooo.pcap',
+    'dns+icmp.pcapng.gz',
+    'arp.pcap',
+)
+
+
+def run_capinfos(cmd_capinfos, args, files, env):
+    return subprocess.run([cmd_capinfos] + list(args) + list(files),
+                          capture_output=True, check=True, env=env).stdout
+
+
+class TestCapinfosThreads:
+    @pytest.mark.parametrize('report_args', [[], ['-T']])
+    def test_capinfos_threads_same_output(self, cmd_capinfos, capture_file, test_env, report_args):
+        '''--threads prints exactly what a sequential run does.'''
+        files = [capture_file(f) for f in capinfos_files]
+        sequential = run_capinfos(cmd_capinfos, report_args, files, test_env)
+        threaded = run_capinfos(cmd_capinfos, report_args + ['--threads', '4'], files, test_env)
+        assert threaded == sequential
+
+    def test_capinfos_threads_more_than_files(self, cmd_capinfos, capture_file, test_env):
+        '''More threads than files, with a file repeated.'''
+        files = [capture_file('dhcp.pcap')] * 3
+        sequential = run_capinfos(cmd_capinfos, [], files, test_env)
+        threaded = run_capinfos(cmd_capinfos, ['--threads', '8'], files, test_env)
+        assert threaded == sequential
+
+
+class TestCapinfosFast:
+    @pytest.mark.parametrize('cap_file', capinfos_files)
+    def test_capinfos_fast_counts(self, cmd_capinfos, capture_file, test_env, cap_file):
+        '''--fast reports the same counts, sizes and times as a full read.'''
+        report_args = ['-t', '-E', '-c', '-d', '-s', '-a', '-e', '-u', '-o']
+        files = [capture_file(cap_file)]
+        full = run_capinfos(cmd_capinfos, report_args, files, test_env)
+        fast = run_capinfos(cmd_capinfos, report_args + ['--fast'], files, test_env)
+        assert fast == full
@@ -10,6 +10,7 @@
 
 import json
 import os.path
+import re
 import subprocess
 import sys
 
@@ -321,6 +322,53 @@ class TestTsharkZExpert:
         assert not grep_output(proc.stdout, 'Notes')
         assert not grep_output(proc.stdout, 'Chats')
 
+    def test_tshark_z_expert_rows(self, cmd_tshark, capture_file, test_env):
+        proc = subprocesstest.run((cmd_tshark, '-q', '-z', 'expert',
+            '-o', 'tcp.check_checksum:TRUE',
+            '-r', capture_file('http-ooo-fuzzed.pcapng')), capture_output=True, env=test_env)
+        proc_msgs = subprocesstest.run((cmd_tshark, '-T', 'fields',
+            '-e', '_ws.expert.message', '-E', 'occurrence=a', '-E', 'aggregator=\x1f',
+            '-o', 'tcp.check_checksum:TRUE',
+            '-r', capture_file('http-ooo-fuzzed.pcapng')), capture_output=True, env=test_env)
+        messages = set()
+        for line in proc_msgs.stdout.splitlines():
+            messages.update(m for m in line.split('\x1f') if m)
+
+        # Rows are "%12d %10s %18s  %s": frequency, group, protocol, summary.
+        sections = {}
+        section = None
+        for line in proc.stdout.splitlines():
+            title = re.match(r'^(\w+) \((\d+)\)$', line)
+            if title:
+                section = title.group(1)
+                sections[section] = (int(title.group(2)), [])
+                continue
+            row = re.match(r'^ {0,11}(\d+) ', line)
+            if section and row and len(line) > 44:
+                sections[section][1].append((int(line[:12]), line[24:42].strip(), line[44:]))
+        assert 'Errors' in sections
+
+        for section, (total, rows) in sections.items():
+            # Each row's frequencies add up to the section total.
+            assert sum(freq for freq, _, _ in rows) == total
+            # One row per protocol and summary text...
+            keys = [(protocol, summary) for _, protocol, summary in rows]
+            assert len(keys) == len(set(keys))
+            # ...showing the text that was raised, not an expert field's
+            # registered summary.
+            for _, _, summary in rows:
+                assert summary in messages
+
+
+class TestTsharkZDissectorProfile:
+    def test_tshark_z_dissector_profile(self, cmd_tshark, capture_file, test_env):
+        proc = subprocesstest.run((cmd_tshark, '-q', '-z', 'dissector-profile',
+            '-r', capture_file('http-ooo.pcap')), capture_output=True, env=test_env)
+        assert proc.returncode == 0
+        assert grep_output(proc.stdout, 'Dissector Profile')
+        assert re.search(r'^tcp +[1-9]', proc.stdout, re.MULTILINE)
+        assert re.search(r'^http +[1-9]', proc.stdout, re.MULTILINE)
+
 
 class TestTsharkExtcap:
     # dumpcap dependency has been added to run this test only with capture support
@@ -0,0 +1,295 @@
+#
+# Wireshark tests
+#
+# SPDX-License-Identifier: GPL-2.0-or-later
+#
+'''Editcap tests'''
+
+import hashlib
+import os.path
+import shutil
+import struct
+import subprocess
+
+from subprocesstest import check_packet_count
+
+# dhcp.pcap has four packets, all at 1102274184 seconds past the Epoch:
+#   1: .317453  2: .317748  3: .387484  4: .387798
+dhcp_start_time = '1102274184.317500000'
+dhcp_stop_time = '1102274184.387500000'
+
+
+def copy_capture(capture_file, result_file, name):
+    '''Copy a capture to the result directory, so that an index can be written next to it.'''
+    copied_file = result_file(name)
+    shutil.copy(capture_file(name), copied_file)
+    return copied_file
+
+
+def run_editcap(cmd_editcap, args, infile, outfile, env):
+    subprocess.run([cmd_editcap] + list(args) + [infile, outfile], check=True, env=env)
+    with open(outfile, 'rb') as f:
+        return f.read()
+
+
+def write_pcap(path, frames, linktype=1):
+    '''Write a pcap file from (time in seconds, frame bytes) pairs.'''
+    with open(path, 'wb') as f:
+        f.write(struct.pack('<IHHiIII', 0xa1b2c3d4, 2, 4, 0, 0, 65535, linktype))
+        for frame_time, frame in frames:
+            usecs = round(frame_time * 1000000)
+            f.write(struct.pack('<IIII', usecs // 1000000, usecs % 1000000, len(frame), len(frame)))
+            f.write(frame)
+
+
+def read_pcap_frames(path):
+    '''Return the frame bytes of the records in a pcap file.'''
+    with open(path, 'rb') as f:
+        data = f.read()
+    frames = []
+    offset = 24
+    while offset < len(data):
+        _secs, _usecs, caplen, _len = struct.unpack_from('<IIII', data, offset)
+        frames.append(data[offset + 16:offset + 16 + caplen])
+        offset += 16 + caplen
+    return frames
+
+
+def udp_frame(payload, ttl=64, checksum=0x1234, ipv6=False):
+    '''An Ethernet frame carrying a UDP datagram over IPv4 or IPv6.'''
+    udp = struct.pack('>HHHH', 1000, 2000, 8 + len(payload), 0x4321) + payload
+    if ipv6:
+        ip = struct.pack('>IHBB', 0x60000000, len(udp), 17, ttl) + bytes(range(32))
+        ethertype = 0x86dd
+    else:
+        ip = struct.pack('>BBHHHBBH', 0x45, 0, 20 + len(udp), 1, 0, ttl, 17, checksum) + bytes([10, 0, 0, 1, 10, 0, 0, 2])
+        ethertype = 0x0800
+    return bytes(range(12)) + struct.pack('>H', ethertype) + ip + udp
+
+
+def write_index(cmd_capinfos, cap_file, env):
+    subprocess.run((cmd_capinfos, '--write-index', cap_file), check=True, capture_output=True, env=env)
+    assert os.path.isfile(cap_file + '.wtidx')
+
+
+class TestEditcapSkip:
+    def test_editcap_start_time(self, cmd_editcap, cmd_capinfos, capture_file, result_file, test_env):
+        '''Packets before -A are skipped'''
+        testout_file = result_file('testout.pcap')
+        run_editcap(cmd_editcap, ('-A', dhcp_start_time), capture_file('dhcp.pcap'), testout_file, test_env)
+        check_packet_count(cmd_capinfos, 3, testout_file)
+
+    def test_editcap_time_range(self, cmd_editcap, cmd_capinfos, capture_file, result_file, test_env):
+        '''Only packets between -A and -B are kept'''
+        testout_file = result_file('testout.pcap')
+        run_editcap(cmd_editcap, ('-A', dhcp_start_time, '-B', dhcp_stop_time), capture_file('dhcp.pcap'), testout_file, test_env)
+        check_packet_count(cmd_capinfos, 2, testout_file)
+
+    def test_editcap_start_time_after_end(self, cmd_editcap, cmd_capinfos, capture_file, result_file, test_env):
+        '''A start time after the last packet gives an empty file'''
+        testout_file = result_file('testout.pcap')
+        run_editcap(cmd_editcap, ('-A', '1102274185'), capture_file('dhcp.pcap'), testout_file, test_env)
+        check_packet_count(cmd_capinfos, 0, testout_file)
+
+    def test_editcap_keep_range(self, cmd_editcap, cmd_capinfos, capture_file, result_file, test_env):
+        '''Packets before the first one kept with -r are skipped'''
+        testout_file = result_file('testout.pcap')
+        tail_file = result_file('tail.pcap')
+        subprocess.run((cmd_editcap, '-r', capture_file('dhcp.pcap'), testout_file, '3-4'), check=True, env=test_env)
+        check_packet_count(cmd_capinfos, 2, testout_file)
+        # The packets kept must be the third and fourth, not the first two.
+        run_editcap(cmd_editcap, ('-A', '1102274184.387000000'), capture_file('dhcp.pcap'), tail_file, test_env)
+        with open(testout_file, 'rb') as f1, open(tail_file, 'rb') as f2:
+            assert f1.read() == f2.read()
+
+    def test_editcap_keep_range_comment(self, cmd_editcap, cmd_tshark, capture_file, result_file, test_env):
+        '''Frame numbers still refer to the input file when packets are skipped'''
+        testout_file = result_file('testout.pcapng')
+        subprocess.run((cmd_editcap, '-F', 'pcapng', '-r', '-a', '4:fourth',
+                        capture_file('dhcp.pcap'), testout_file, '3-4'), check=True, env=test_env)
+        comments = subprocess.check_output((cmd_tshark, '-r', testout_file,
+                                            '-Tfields', '-e', 'frame.comment'),
+                                           encoding='utf-8', env=test_env)
+        assert comments.splitlines() == ['', 'fourth']
+
+
+class TestEditcapSkipIndexed:
+    def test_editcap_time_range_indexed(self, cmd_editcap, cmd_capinfos, capture_file, result_file, test_env):
+        '''-A and -B give the same result with and without a packet index'''
+        cap_file = copy_capture(capture_file, result_file, 'dhcp.pcap')
+        args = ('-A', dhcp_start_time, '-B', dhcp_stop_time)
+        unindexed = run_editcap(cmd_editcap, args, cap_file, result_file('unindexed.pcap'), test_env)
+        write_index(cmd_capinfos, cap_file, test_env)
+        indexed = run_editcap(cmd_editcap, args, cap_file, result_file('indexed.pcap'), test_env)
+        assert indexed == unindexed
+        check_packet_count(cmd_capinfos, 2, result_file('indexed.pcap'))
+
+    def test_editcap_start_time_indexed(self, cmd_editcap, cmd_capinfos, capture_file, result_file, test_env):
+        '''-A with a packet index, including a start time after the last packet'''
+        cap_file = copy_capture(capture_file, result_file, 'dhcp.pcap')
+        write_index(cmd_capinfos, cap_file, test_env)
+        run_editcap(cmd_editcap, ('-A', dhcp_start_time), cap_file, result_file('testout.pcap'), test_env)
+        check_packet_count(cmd_capinfos, 3, result_file('testout.pcap'))
+        run_editcap(cmd_editcap, ('-A', '1102274185'), cap_file, result_file('empty.pcap'), test_env)
+        check_packet_count(cmd_capinfos, 0, result_file('empty.pcap'))
+
+    def test_editcap_keep_range_indexed(self, cmd_editcap, cmd_capinfos, capture_file, result_file, test_env):
+        '''-r gives the same result with and without a packet index'''
+        cap_file = copy_capture(capture_file, result_file, 'dhcp.pcap')
+        unindexed_file = result_file('unindexed.pcap')
+        indexed_file = result_file('indexed.pcap')
+        subprocess.run((cmd_editcap, '-r', cap_file, unindexed_file, '2-3'), check=True, env=test_env)
+        write_index(cmd_capinfos, cap_file, test_env)
+        subprocess.run((cmd_editcap, '-r', cap_file, indexed_file, '2-3'), check=True, env=test_env)
+        with open(unindexed_file, 'rb') as f1, open(indexed_file, 'rb') as f2:
+            assert f1.read() == f2.read()
+        check_packet_count(cmd_capinfos, 2, indexed_file)
+
+
+def editcap_uses_index(cmd_editcap, cap_file, outfile, env):
+    '''Run editcap -v with a time range and report whether it used a packet index.'''
+    proc = subprocess.run((cmd_editcap, '-v', '-A', dhcp_start_time, cap_file, outfile),
+                          check=True, capture_output=True, encoding='utf-8', env=env)
+    return 'Using packet index' in proc.stderr
+
+
+class TestPacketIndex:
+    def test_capinfos_write_index(self, cmd_capinfos, capture_file, result_file, test_env):
+        '''capinfos --write-index writes a header and one record per packet'''
+        cap_file = copy_capture(capture_file, result_file, 'dhcp.pcap')
+        write_index(cmd_capinfos, cap_file, test_env)
+        with open(cap_file + '.wtidx', 'rb') as f:
+            index = f.read()
+        assert index[0:8] == b'WTAPIDX\0'
+        version, record_len, file_size = struct.unpack_from('<IIQ', index, 8)
+        count, = struct.unpack_from('<Q', index, 40)
+        assert version == 1
+        assert record_len == 40
+        assert file_size == os.path.getsize(cap_file)
+        assert count == 4
+        assert len(index) == 48 + count * record_len
+        # dhcp.pcap is in time order; the first record is at the end of
+        # the 24-byte file header.
+        flags, = struct.unpack_from('<I', index, 36)
+        assert flags & 1
+        offset, secs, nsecs = struct.unpack_from('<QqI', index, 48)
+        assert (offset, secs, nsecs) == (24, 1102274184, 317453000)
+
+    def test_packet_index_reused(self, cmd_editcap, cmd_capinfos, capture_file, result_file, test_env):
+        '''An index matching the capture file is used'''
+        cap_file = copy_capture(capture_file, result_file, 'dhcp.pcap')
+        assert not editcap_uses_index(cmd_editcap, cap_file, result_file('before.pcap'), test_env)
+        write_index(cmd_capinfos, cap_file, test_env)
+        assert editcap_uses_index(cmd_editcap, cap_file, result_file('after.pcap'), test_env)
+        check_packet_count(cmd_capinfos, 3, result_file('after.pcap'))
+
+    def test_packet_index_stale(self, cmd_editcap, cmd_capinfos, capture_file, result_file, test_env):
+        '''An index is ignored once the capture file changes'''
+        cap_file = copy_capture(capture_file, result_file, 'dhcp.pcap')
+        write_index(cmd_capinfos, cap_file, test_env)
+        # Same size, and quite possibly the same modification time, but
+        # different contents; the checksum has to catch this.
+        shutil.copyfile(capture_file('dhcp-nanosecond.pcap'), cap_file)
+        assert not editcap_uses_index(cmd_editcap, cap_file, result_file('testout.pcap'), test_env)
+        check_packet_count(cmd_capinfos, 3, result_file('testout.pcap'))
+
+    def test_packet_index_truncated(self, cmd_editcap, cmd_capinfos, capture_file, result_file, test_env):
+        '''A damaged index is ignored'''
+        cap_file = copy_capture(capture_file, result_file, 'dhcp.pcap')
+        write_index(cmd_capinfos, cap_file, test_env)
+        with open(cap_file + '.wtidx', 'r+b') as f:
+            f.truncate(48 + 40 + 7)
+        assert not editcap_uses_index(cmd_editcap, cap_file, result_file('testout.pcap'), test_env)
+        check_packet_count(cmd_capinfos, 3, result_file('testout.pcap'))
+
+    def test_packet_index_rewritten(self, cmd_editcap, cmd_capinfos, capture_file, result_file, test_env):
+        '''Writing the index again after a change makes it usable again'''
+        cap_file = copy_capture(capture_file, result_file, 'dhcp.pcap')
+        write_index(cmd_capinfos, cap_file, test_env)
+        shutil.copyfile(capture_file('dhcp-nanosecond.pcap'), cap_file)
+        write_index(cmd_capinfos, cap_file, test_env)
+        assert editcap_uses_index(cmd_editcap, cap_file, result_file('testout.pcap'), test_env)
+        check_packet_count(cmd_capinfos, 3, result_file('testout.pcap'))
+
+
+class TestEditcapDedup:
+    def test_editcap_dedup_default_window(self, cmd_editcap, result_file, test_env):
+        '''-d compares each packet with the previous four'''
+        a, b, c, d, e, f = (udp_frame(bytes([n])) for n in range(6))
+        infile = result_file('in.pcap')
+        outfile = result_file('out.pcap')
+        write_pcap(infile, enumerate([a, b, a, c, d, e, f, a]))
+        run_editcap(cmd_editcap, ('-d',), infile, outfile, test_env)
+        # The second a is skipped; the last one is five packets later.
+        assert read_pcap_frames(outfile) == [a, b, c, d, e, f, a]
+
+    def test_editcap_dedup_window(self, cmd_editcap, result_file, test_env):
+        '''-D N compares each packet with the previous N - 1'''
+        a, b = udp_frame(b'a'), udp_frame(b'b')
+        infile = result_file('in.pcap')
+        outfile = result_file('out.pcap')
+        write_pcap(infile, enumerate([a, a, b, a, b, b]))
+        run_editcap(cmd_editcap, ('-D', '2'), infile, outfile, test_env)
+        assert read_pcap_frames(outfile) == [a, b, a, b]
+
+    def test_editcap_dedup_verbose_md5(self, cmd_editcap, result_file, test_env):
+        '''-V prints each packet's length and MD5 hash'''
+        frames = [udp_frame(b'a'), udp_frame(b'b')]
+        infile = result_file('in.pcap')
+        outfile = result_file('out.pcap')
+        write_pcap(infile, enumerate(frames))
+        proc = subprocess.run((cmd_editcap, '-V', '-D', '0', infile, outfile),
+                              check=True, capture_output=True, encoding='utf-8', env=test_env)
+        for num, frame in enumerate(frames, start=1):
+            line = 'Packet: {}, Len: {}, MD5 Hash: {}'.format(num, len(frame), hashlib.md5(frame).hexdigest())
+            assert line in proc.stderr.splitlines()
+
+    def test_editcap_dedup_time_window(self, cmd_editcap, result_file, test_env):
+        '''-w skips packets seen again within the time window'''
+        a, b = udp_frame(b'a'), udp_frame(b'b')
+        infile = result_file('in.pcap')
+        outfile = result_file('out.pcap')
+        write_pcap(infile, [(0.0, a), (0.1, b), (0.9, a), (1.5, a), (3.0, a), (3.2, b)])
+        run_editcap(cmd_editcap, ('-w', '1'), infile, outfile, test_env)
+        # a at 1.5 is compared with a at 0.9, which was skipped, not with
+        # a at 0.0.
+        assert read_pcap_frames(outfile) == [a, b, a, b]
+
+    def test_editcap_dedup_time_window_most_recent(self, cmd_editcap, result_file, test_env):
+        '''-w only compares with the most recent packet with the same hash'''
+        a = udp_frame(b'a')
+        infile = result_file('in.pcap')
+        outfile = result_file('out.pcap')
+        write_pcap(infile, [(5.0, a), (1.0, a), (1.5, a)])
+        run_editcap(cmd_editcap, ('-w', '1'), infile, outfile, test_env)
+        # The packets at 1.0 and 1.5 are earlier than the one at 5.0, so
+        # neither is a duplicate of it, and the one at 1.5 isn't compared
+        # with the one at 1.0.
+        assert read_pcap_frames(outfile) == [a, a, a]
+
+    def test_editcap_dedup_ipv4_mutable(self, cmd_editcap, result_file, test_env):
+        '''--dup-ignore-mutable ignores the IPv4 TTL and header checksum'''
+        first = udp_frame(b'a', ttl=64, checksum=0x1111)
+        routed = udp_frame(b'a', ttl=63, checksum=0x1211)
+        other = udp_frame(b'b', ttl=63, checksum=0x1211)
+        infile = result_file('in.pcap')
+        outfile = result_file('out.pcap')
+        write_pcap(infile, enumerate([first, routed, other]))
+        run_editcap(cmd_editcap, ('-d',), infile, outfile, test_env)
+        assert read_pcap_frames(outfile) == [first, routed, other]
+        run_editcap(cmd_editcap, ('-d', '--dup-ignore-mutable'), infile, outfile, test_env)
+        # The packets that are written aren't modified.
+        assert read_pcap_frames(outfile) == [first, other]
+
+    def test_editcap_dedup_ipv6_mutable(self, cmd_editcap, result_file, test_env):
+        '''--dup-ignore-mutable ignores the IPv6 hop limit'''
+        first = udp_frame(b'a', ttl=64, ipv6=True)
+        routed = udp_frame(b'a', ttl=63, ipv6=True)
+        other = udp_frame(b'b', ttl=63, ipv6=True)
+        infile = result_file('in.pcap')
+        outfile = result_file('out.pcap')
+        write_pcap(infile, enumerate([first, routed, other]))
+        run_editcap(cmd_editcap, ('-d',), infile, outfile, test_env)
+        assert read_pcap_frames(outfile) == [first, routed, other]
+        run_editcap(cmd_editcap, ('-d', '--dup-ignore-mutable'), infile, outfile, test_env)
+        assert read_pcap_frames(outfile) == [first, other]
@@ -9,6 +9,7 @@
 '''File format conversion tests'''
 
 import os.path
+import re
 import subprocess
 from pathlib import PurePath
 
@@ -277,3 +278,38 @@ class TestFileFormatCllog:
             ), encoding='utf-8', env=test_env)
         assert ' '.join(proc_stdout.strip().splitlines()) == \
             '2015 2024 2015 2024 2015 2024 2015 2024'
+
+
+class TestFileFormatMagicHints:
+    '''Files whose first bytes identify their format are opened by the
+    matching reader, whatever their extension.'''
+    @pytest.mark.parametrize('out_format,description,name', [
+        ('pcap', 'Wireshark/tcpdump/... - pcap', 'pcap-named.pcapng'),
+        ('pcapng', 'Wireshark/... - pcapng', 'pcapng-named.pcap'),
+        ('snoop', 'Sun snoop', 'snoop-named.pcap'),
+        ('netmon2', 'Microsoft NetMon 2.x', 'netmon-named.pcap'),
+        ('ngsniffer', 'Sniffer (DOS)', 'ngsniffer-named.pcapng'),
+    ])
+    def test_magic_hint_file_type(self, cmd_editcap, cmd_capinfos, capture_file, result_file, test_env,
+                                  out_format, description, name):
+        cap_file = result_file(name)
+        subprocess.run((cmd_editcap, '-F', out_format, capture_file('dhcp.pcap'), cap_file),
+                       check=True, env=test_env)
+        capinfos_out = subprocess.check_output((cmd_capinfos, '-t', '-c', cap_file),
+                                               encoding='utf-8', env=test_env)
+        assert 'File type:           {}\n'.format(description) in capinfos_out
+        assert re.search(r'Number of packets:\s+4\n', capinfos_out)
+
+    def test_magic_hint_heuristic(self, cmd_capinfos, result_file, test_env):
+        '''A journal export named like a PEAK CAN trace is still read as a journal'''
+        cap_file = result_file('journal-named.trc')
+        with open(cap_file, 'w') as f:
+            for n in range(2):
+                f.write('__CURSOR=s=0;i={}\n'.format(n + 1))
+                f.write('__REALTIME_TIMESTAMP={}\n'.format(1500000000000000 + n))
+                f.write('__MONOTONIC_TIMESTAMP={}\n'.format(1000 + n))
+                f.write('MESSAGE=entry {}\n\n'.format(n + 1))
+        capinfos_out = subprocess.check_output((cmd_capinfos, '-t', '-c', cap_file),
+                                               encoding='utf-8', env=test_env)
+        assert 'File type:           systemd journal export\n' in capinfos_out
+        assert re.search(r'Number of packets:\s+2\n', capinfos_out)
@@ -9,6 +9,7 @@
 '''File I/O tests'''
 
 import os.path
+import struct
 import subprocess
 import sys
 
@@ -81,3 +82,73 @@ class TestRawsharkIO:
         rawshark_cmd = f'{raw_dhcp_cmd} | "{cmd_rawshark}" --log-fatal=warning -r - -n -dencap:1 -R "udp.port==68"'
         rawshark_stdout = subprocess.check_output(rawshark_cmd, shell=True, encoding='utf-8', env=test_env)
         assert rawshark_stdout == io_baseline_str
+
+    def test_rawshark_io_batch(self, cmd_rawshark, capture_file, test_env):
+        '''Round-trip two batches through Rawshark's --batch protocol'''
+        with open(capture_file('dhcp.pcap'), 'rb') as f:
+            contents = f.read()
+        records = []
+        offset = 24
+        while offset < len(contents):
+            caplen = struct.unpack_from('<I', contents, offset + 8)[0]
+            records.append(contents[offset:offset + 16 + caplen])
+            offset += 16 + caplen
+        assert len(records) == 4
+        void_record = struct.pack('<IIII', 0, 0, 0, 0)
+        batch_in = struct.pack('<I', 2) + records[0] + records[1]
+        batch_in += struct.pack('<I', 3) + void_record + records[2] + records[3]
+
+        rawshark_out = subprocess.run((cmd_rawshark, '--log-fatal=warning', '--batch',
+                                       '-r', '-', '-n', '-dencap:1',
+                                       '-R', 'udp.port==68', '-R', 'dhcp.option.dhcp == 1',
+                                       '-F', 'udp.srcport', '-F', 'eth.src', '-F', 'tcp.port'),
+                                      input=batch_in, capture_output=True, check=True, env=test_env).stdout
+
+        # Stream header
+        assert rawshark_out[:4] == b'RSB\x01'
+        version, n_fields, n_filters, row_len = struct.unpack_from('<IIII', rawshark_out, 4)
+        assert (version, n_fields, n_filters) == (1, 3, 2)
+        assert row_len == 16 + n_fields * 16
+        value_types = struct.unpack_from('<III', rawshark_out, 20)
+        assert value_types == (1, 5, 1) # UINT, STRING, UINT
+        offset = 32
+
+        def read_batch(offset):
+            n_rows, heap_len = struct.unpack_from('<II', rawshark_out, offset)
+            offset += 8
+            rows = []
+            for _ in range(n_rows):
+                frame_num, flags, filter_mask = struct.unpack_from('<IIQ', rawshark_out, offset)
+                cells = [struct.unpack_from('<IIQ', rawshark_out, offset + 16 + n * 16) for n in range(n_fields)]
+                rows.append((frame_num, flags, filter_mask, cells))
+                offset += row_len
+            heap = rawshark_out[offset:offset + heap_len]
+            return rows, heap, offset + heap_len
+
+        def eth_src(record):
+            return ':'.join('{:02x}'.format(b) for b in record[16 + 6:16 + 12]).encode('ascii')
+
+        def udp_srcport(record):
+            ip_hdr_len = (record[16 + 14] & 0x0f) * 4
+            return struct.unpack_from('>H', record, 16 + 14 + ip_hdr_len)[0]
+
+        rows, heap, offset = read_batch(offset)
+        assert [row[:3] for row in rows] == [(1, 0, 0b11), (2, 0, 0b01)]
+        srcport_cell, eth_src_cell, tcp_port_cell = rows[0][3]
+        assert srcport_cell == (1, 0, udp_srcport(records[0]))
+        assert eth_src_cell[:2] == (1, 17)
+        assert eth_src_cell[2] == 0
+        assert heap[eth_src_cell[2]:eth_src_cell[2] + eth_src_cell[1]] == eth_src(records[0])
+        assert tcp_port_cell == (0, 0, 0)
+        eth_src_cell = rows[1][3][1]
+        assert eth_src_cell[:2] == (1, 17)
+        assert eth_src_cell[2] == 17
+        assert heap[eth_src_cell[2]:eth_src_cell[2] + eth_src_cell[1]] == eth_src(records[1])
+
+        rows, heap, offset = read_batch(offset)
+        assert [row[:3] for row in rows] == [(2, 1, 0), (3, 0, 0b01), (4, 0, 0b01)]
+        assert rows[0][3] == [(0, 0, 0)] * n_fields
+        assert rows[1][3][0] == (1, 0, udp_srcport(records[2]))
+        assert rows[1][3][1][2] == 0
+        assert rows[1][3][2] == (0, 0, 0)
+        assert offset == len(rawshark_out)
@@ -0,0 +1,176 @@
+#
+# Wireshark tests
+#
+# SPDX-License-Identifier: GPL-2.0-or-later
+#
+'''Reordercap tests'''
+
+import os
+import stat
+import struct
+import subprocess
+import sys
+
+import pytest
+
+from subprocesstest import check_packet_count
+
+frame_data = bytes(14) + b'reordercap'
+
+
+def write_pcap(path, times):
+    '''Write a pcap file with one Ethernet frame per time stamp (in seconds).'''
+    with open(path, 'wb') as f:
+        f.write(struct.pack('<IHHiIII', 0xa1b2c3d4, 2, 4, 0, 0, 65535, 1))
+        for secs in times:
+            f.write(struct.pack('<IIII', secs, 0, len(frame_data), len(frame_data)))
+            f.write(frame_data)
+
+
+def read_pcap_times(path):
+    '''Return the time stamps (in seconds) of the records in a pcap file.'''
+    with open(path, 'rb') as f:
+        data = f.read()
+    times = []
+    offset = 24
+    while offset < len(data):
+        secs, _usecs, caplen, _len = struct.unpack_from('<IIII', data, offset)
+        times.append(secs)
+        offset += 16 + caplen
+    return times
+
+
+def pcapng_block(block_type, body):
+    body += bytes(-len(body) % 4)
+    block_len = 12 + len(body)
+    return struct.pack('<II', block_type, block_len) + body + struct.pack('<I', block_len)
+
+
+def pcapng_options(options):
+    '''Encode (code, bytes) pairs as pcapng options, with an end of options.'''
+    data = b''
+    for code, value in options:
+        data += struct.pack('<HH', code, len(value)) + value + bytes(-len(value) % 4)
+    return data + struct.pack('<HH', 0, 0)
+
+
+def read_pcapng_shb_options(path):
+    '''Return the options of the first SHB in a pcapng file as (code, bytes) pairs.'''
+    with open(path, 'rb') as f:
+        data = f.read()
+    block_type, block_len = struct.unpack_from('<II', data, 0)
+    assert block_type == 0x0a0d0d0a
+    options = []
+    offset = 24
+    while offset < block_len - 4:
+        code, length = struct.unpack_from('<HH', data, offset)
+        if code == 0:
+            break
+        options.append((code, data[offset + 4:offset + 4 + length]))
+        offset += 4 + length + (-length % 4)
+    return options
+
+
+def write_pcapng(path, times, shb_options=()):
+    '''Write a pcapng file with an Enhanced Packet Block per time stamp, or a
+    Simple Packet Block, which has no time stamp, for None.'''
+    shb_body = struct.pack('<IHHq', 0x1a2b3c4d, 1, 0, -1)
+    if shb_options:
+        shb_body += pcapng_options(shb_options)
+    with open(path, 'wb') as f:
+        f.write(pcapng_block(0x0a0d0d0a, shb_body))
+        f.write(pcapng_block(0x00000001, struct.pack('<HHI', 1, 0, 65535)))
+        for secs in times:
+            if secs is None:
+                f.write(pcapng_block(0x00000003, struct.pack('<I', len(frame_data)) + frame_data))
+            else:
+                usecs = secs * 1000000
+                f.write(pcapng_block(0x00000006, struct.pack('<IIIII', 0, usecs >> 32, usecs & 0xffffffff,
+                                                             len(frame_data), len(frame_data)) + frame_data))
+
+
+def run_reordercap(cmd_reordercap, args, infile, outfile, env):
+    return subprocess.check_output([cmd_reordercap] + list(args) + [infile, outfile],
+                                   encoding='utf-8', env=env)
+
+
+class TestReordercapWindow:
+    def test_reordercap_window_in_window(self, cmd_reordercap, result_file, test_env):
+        '''Frames out of order by less than the window are sorted in one run'''
+        infile = result_file('in.pcap')
+        outfile = result_file('out.pcap')
+        write_pcap(infile, [1, 3, 2, 5, 4, 6])
+        stdout = run_reordercap(cmd_reordercap, ('-w', '4'), infile, outfile, test_env)
+        assert '6 frames, 2 out of order, 1 sorted run\n' in stdout
+        assert read_pcap_times(outfile) == [1, 2, 3, 4, 5, 6]
+
+    def test_reordercap_window_runs(self, cmd_reordercap, result_file, test_env):
+        '''Frames that arrive too late start new runs, which are merged'''
+        infile = result_file('in.pcap')
+        outfile = result_file('out.pcap')
+        write_pcap(infile, [6, 5, 4, 3, 2, 1])
+        stdout = run_reordercap(cmd_reordercap, ('-w', '1'), infile, outfile, test_env)
+        assert 'sorted runs\n' in stdout
+        assert read_pcap_times(outfile) == [1, 2, 3, 4, 5, 6]
+
+    def test_reordercap_window_many_runs(self, cmd_reordercap, cmd_capinfos, result_file, test_env):
+        '''More runs than are merged at once still give a sorted file'''
+        infile = result_file('in.pcap')
+        outfile = result_file('out.pcap')
+        times = list(range(300, 0, -1))
+        write_pcap(infile, times)
+        run_reordercap(cmd_reordercap, ('-w', '1'), infile, outfile, test_env)
+        assert read_pcap_times(outfile) == sorted(times)
+        check_packet_count(cmd_capinfos, 300, outfile)
+        # The runs are removed once they've been merged.
+        assert [name for name in os.listdir(os.path.dirname(outfile)) if name.startswith('reordercap')] == []
+
+    def test_reordercap_window_untimed(self, cmd_reordercap, cmd_capinfos, result_file, test_env):
+        '''Frames without a time stamp don't start a new run'''
+        infile = result_file('in.pcapng')
+        outfile = result_file('out.pcapng')
+        write_pcapng(infile, [1, 2, None, 3])
+        stdout = run_reordercap(cmd_reordercap, ('-w', '1'), infile, outfile, test_env)
+        assert '4 frames, 0 out of order, 1 sorted run\n' in stdout
+        check_packet_count(cmd_capinfos, 4, outfile)
+
+    def test_reordercap_window_seconds(self, cmd_reordercap, result_file, test_env):
+        '''-W holds frames for a time rather than a number of frames'''
+        infile = result_file('in.pcap')
+        outfile = result_file('out.pcap')
+        write_pcap(infile, [10, 12, 11, 20, 8, 30])
+        stdout = run_reordercap(cmd_reordercap, ('-W', '5'), infile, outfile, test_env)
+        assert read_pcap_times(outfile) == [8, 10, 11, 12, 20, 30]
+        assert 'sorted runs\n' in stdout
+
+    @pytest.mark.skipif(sys.platform.startswith('win32'), reason='POSIX file permissions')
+    def test_reordercap_window_permissions(self, cmd_reordercap, result_file, test_env):
+        '''The output file is created like any other file, even with a single run'''
+        infile = result_file('in.pcap')
+        outfile = result_file('out.pcap')
+        reference_file = result_file('reference')
+        write_pcap(infile, [1, 3, 2])
+        stdout = run_reordercap(cmd_reordercap, ('-w', '10'), infile, outfile, test_env)
+        assert '1 sorted run\n' in stdout
+        with open(reference_file, 'w'):
+            pass
+        assert stat.S_IMODE(os.stat(outfile).st_mode) == stat.S_IMODE(os.stat(reference_file).st_mode)
+
+    @pytest.mark.parametrize('times,runs', [
+        ([1, 3, 2, 4], '1 sorted run\n'),
+        ([4, 3, 2, 1], '3 sorted runs\n'),
+    ])
+    def test_reordercap_window_shb(self, cmd_reordercap, result_file, test_env, times, runs):
+        '''The input file's SHB options are written unchanged'''
+        infile = result_file('in.pcapng')
+        outfile = result_file('out.pcapng')
+        shb_options = [
+            (1, b'input comment'),          # opt_comment
+            (2, b'reordercap hardware'),    # shb_hardware
+            (3, b'reordercap OS'),          # shb_os
+            (4, b'capturing application'),  # shb_userappl
+        ]
+        write_pcapng(infile, times, shb_options)
+        stdout = run_reordercap(cmd_reordercap, ('-w', '1'), infile, outfile, test_env)
+        assert runs in stdout
+        assert read_pcapng_shb_options(outfile) == shb_options
@@ -276,6 +276,21 @@ static bool write_finale(void);
 
 static GHashTable *output_only_tables;
 
+/*
+ * With "-T fields" (and no taps that look at the tree), the only thing
+ * we'll look at in the protocol tree is the fields the tree was primed
+ * with, so let epan collapse the faked part of the tree instead of
+ * allocating a node for every item that isn't referenced.
+ */
+static void
+set_extraction_only(epan_dissect_t *edt, bool visible, unsigned tap_flags)
+{
+    if (output_action == WRITE_FIELDS && !visible &&
+        !(tap_flags & (TL_REQUIRES_PROTO_TREE|TL_REQUIRES_PROTOCOLS))) {
+        epan_dissect_set_extraction_only(edt, true);
+    }
+}
+
 static bool opt_print_timers;
 struct elapsed_pass_s {
     int64_t dissect;
@@ -3297,6 +3312,7 @@ capture_input_new_packets(capture_session *cap_session, int to_read)
            "-e", we'll prime those directly later. */
         bool visible = print_packet_info && print_details && output_fields_num_fields(output_fields) == 0;
         edt = epan_dissect_new(cf->epan, create_proto_tree, visible);
+        set_extraction_only(edt, visible, tap_flags);
 
         wtap_rec_init(&rec, DEFAULT_INIT_BUFFER_SIZE_2048);
 
@@ -3943,6 +3959,7 @@ process_cap_file_second_pass(capture_file *cf, wtap_dumper *pdh,
            "-e", we'll prime those directly later. */
         bool visible = print_packet_info && print_details && output_fields_num_fields(output_fields) == 0;
         edt = epan_dissect_new(cf->epan, create_proto_tree, visible);
+        set_extraction_only(edt, visible, tap_flags);
     }
 
     /*
@@ -4081,6 +4098,7 @@ process_cap_file_single_pass(capture_file *cf, wtap_dumper *pdh,
            "-e", we'll prime those directly later. */
         visible = print_packet_info && print_details && output_fields_num_fields(output_fields) == 0;
         edt = epan_dissect_new(cf->epan, create_proto_tree, visible);
+        set_extraction_only(edt, visible, tap_flags);
     }
 
     /*
@@ -0,0 +1,126 @@
+/* tap-dissector-profile.c
+ * Per-dissector CPU time and allocation statistics for tshark
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+/* This module provides the "-z dissector-profile" statistics for tshark */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <epan/packet.h>
+#include <epan/tap.h>
+#include <epan/stat_tap_ui.h>
+#include <epan/dissector_profile.h>
+
+#include <wsutil/cmdarg_err.h>
+
+void register_tap_listener_dissector_profile(void);
+
+/* There's no per-listener state; the profile lives in libwireshark. */
+static int dissector_profile_tapdata;
+
+static void
+dissector_profile_draw(void *tapdata _U_)
+{
+	GArray *stats = dissector_profile_get_stats();
+	uint64_t total_ns = 0;
+	unsigned i;
+
+	for (i = 0; i < stats->len; i++) {
+		total_ns += g_array_index(stats, dissector_profile_stat_t, i).exclusive_ns;
+	}
+
+	printf("\n");
+	printf("===================================================================================================\n");
+	printf("Dissector Profile\n");
+	printf("Total dissection time: %.3f ms\n\n", total_ns / 1000000.0);
+	printf("%-24s %10s %12s %12s %7s %10s %10s %14s\n",
+	       "Protocol", "Calls", "Incl (ms)", "Excl (ms)", "Excl %",
+	       "Heur tries", "Heur hits", "Alloc (bytes)");
+	for (i = 0; i < stats->len; i++) {
+		dissector_profile_stat_t *stat = &g_array_index(stats, dissector_profile_stat_t, i);
+
+		printf("%-24s %10" PRIu64 " %12.3f %12.3f %6.2f%% %10" PRIu64 " %10" PRIu64 " %14" PRIu64 "\n",
+		       proto_get_protocol_filter_name(stat->proto_id),
+		       stat->calls,
+		       stat->inclusive_ns / 1000000.0,
+		       stat->exclusive_ns / 1000000.0,
+		       total_ns ? 100.0 * stat->exclusive_ns / total_ns : 0.0,
+		       stat->heur_attempts,
+		       stat->heur_hits,
+		       stat->alloc_bytes);
+	}
+	printf("===================================================================================================\n");
+
+	g_array_free(stats, true);
+}
+
+static void
+dissector_profile_finish(void *tapdata _U_)
+{
+	dissector_profile_enable(false);
+}
+
+static bool
+dissector_profile_init(const char *opt_arg, void *userdata _U_)
+{
+	GString *error_string;
+
+	if (strcmp("dissector-profile", opt_arg) != 0) {
+		cmdarg_err("invalid \"-z dissector-profile\" argument");
+		return false;
+	}
+
+	/*
+	 * We don't look at the packets ourselves; the listener is only
+	 * here so that we get our draw callback at the end of the run.
+	 */
+	error_string = register_tap_listener("frame", &dissector_profile_tapdata, NULL, TL_REQUIRES_NOTHING, NULL, NULL, dissector_profile_draw, dissector_profile_finish);
+	if (error_string) {
+		cmdarg_err("Couldn't register dissector-profile tap: %s",
+			error_string->str);
+		g_string_free(error_string, TRUE);
+		return false;
+	}
+
+	dissector_profile_reset();
+	dissector_profile_enable(true);
+
+	return true;
+}
+
+static stat_tap_ui dissector_profile_ui = {
+	REGISTER_STAT_GROUP_GENERIC,
+	NULL,
+	"dissector-profile",
+	dissector_profile_init,
+	0,
+	NULL
+};
+
+void
+register_tap_listener_dissector_profile(void)
+{
+	register_stat_tap_ui(&dissector_profile_ui, NULL);
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
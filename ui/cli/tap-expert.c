@@ -34,20 +34,10 @@ typedef enum severity_level_t {
     max_level
 } severity_level_t;
 
-typedef struct expert_entry
-{
-    uint32_t     group;
-    int          frequency;
-    const char *protocol;
-    char        *summary;
-} expert_entry;
-
-
 /* Overall struct for storing all data seen */
 typedef struct expert_tapdata_t {
     severity_level_t lowest_report_level; /* the lowest level that will be displayed */
-    GArray       *ei_array[max_level]; /* expert info items */
-    GStringChunk *text;         /* for efficient storage of summary strings */
+    expert_aggregate_t *ei_aggregate[max_level]; /* expert info counters */
 } expert_tapdata_t;
 
 
@@ -58,13 +48,9 @@ expert_stat_reset(void *tapdata)
     int               n;
     expert_tapdata_t *etd = (expert_tapdata_t *)tapdata;
 
-    /* Free & reallocate chunk of strings */
-    g_string_chunk_free(etd->text);
-    etd->text = g_string_chunk_new(100);
-
-    /* Empty each of the arrays */
+    /* Empty each of the aggregates */
     for (n=0; n < max_level; n++) {
-        g_array_set_size(etd->ei_array[n], 0);
+        expert_aggregate_reset(etd->ei_aggregate[n]);
     }
 }
 
@@ -76,9 +62,6 @@ expert_stat_packet(void *tapdata, packet_info *pinfo _U_, epan_dissect_t *edt _U
     const expert_info_t *ei   = (const expert_info_t *)pointer;
     expert_tapdata_t    *data = (expert_tapdata_t *)tapdata;
     severity_level_t     severity_level;
-    expert_entry         tmp_entry;
-    expert_entry        *entry;
-    unsigned             n;
 
     switch (ei->severity) {
         case PI_COMMENT:
@@ -106,62 +89,45 @@ expert_stat_packet(void *tapdata, packet_info *pinfo _U_, epan_dissect_t *edt _U
         return TAP_PACKET_REDRAW; /* XXX - TAP_PACKET_DONT_REDRAW? */
     }
 
-    /* If a duplicate just bump up frequency.
-       TODO: could make more efficient by avoiding linear search...*/
-    for (n=0; n < data->ei_array[severity_level]->len; n++) {
-        entry = &g_array_index(data->ei_array[severity_level], expert_entry, n);
-        if ((strcmp(ei->protocol, entry->protocol) == 0) &&
-            (strcmp(ei->summary, entry->summary) == 0)) {
-            entry->frequency++;
-            return TAP_PACKET_REDRAW;
-        }
-    }
-
-    /* Else Add new item to end of list for severity level */
-    entry = &tmp_entry;
-    /* Copy/Store protocol and summary strings efficiently using GStringChunk */
-    entry->protocol = g_string_chunk_insert_const(data->text, ei->protocol);
-    entry->summary = g_string_chunk_insert_const(data->text, ei->summary);
-    entry->group = ei->group;
-    entry->frequency = 1;
-    /* Store a copy of the expert entry */
-    g_array_append_val(data->ei_array[severity_level], tmp_entry);
+    /* Bump up the frequency of a duplicate, or add a new entry */
+    expert_aggregate_add(data->ei_aggregate[severity_level], ei);
 
     return TAP_PACKET_REDRAW;
 }
 
 /* Output for all of the items of one severity */
-static void draw_items_for_severity(GArray *items, const char *label)
+static void draw_items_for_severity(expert_aggregate_t *items, const char *label)
 {
-    unsigned      n;
-    expert_entry *ei;
-    int           total = 0;
-    char         *tmp_str;
+    unsigned        n;
+    unsigned        num_items = expert_aggregate_num_entries(items);
+    const expert_aggregate_entry_t *ei;
+    uint64_t        total = 0;
+    char           *tmp_str;
 
     /* Don't print title if no items */
-    if (items->len == 0) {
+    if (num_items == 0) {
         return;
     }
 
     /* Add frequencies together to get total */
-    for (n=0; n < items->len; n++) {
-        ei = &g_array_index(items, expert_entry, n);
-        total += ei->frequency;
+    for (n=0; n < num_items; n++) {
+        ei = expert_aggregate_get_entry(items, n);
+        total += ei->count;
     }
 
     /* Title */
-    printf("\n%s (%d)\n", label, total);
+    printf("\n%s (%" PRIu64 ")\n", label, total);
     printf("=============\n");
 
     /* Column headings */
     printf("   Frequency      Group           Protocol  Summary\n");
 
     /* Items */
-    for (n=0; n < items->len; n++) {
-        ei = &g_array_index(items, expert_entry, n);
+    for (n=0; n < num_items; n++) {
+        ei = expert_aggregate_get_entry(items, n);
         tmp_str = val_to_str(NULL, ei->group, expert_group_vals, "Unknown (%d)");
-        printf("%12d %10s %18s  %s\n",
-              ei->frequency,
+        printf("%12" PRIu64 " %10s %18s  %s\n",
+              ei->count,
               tmp_str,
               ei->protocol, ei->summary);
         wmem_free(NULL, tmp_str);
@@ -175,20 +141,19 @@ expert_stat_draw(void *phs _U_)
     /* Look up the statistics struct */
     expert_tapdata_t *hs = (expert_tapdata_t *)phs;
 
-    draw_items_for_severity(hs->ei_array[error_level], "Errors");
-    draw_items_for_severity(hs->ei_array[warn_level],  "Warns");
-    draw_items_for_severity(hs->ei_array[note_level],  "Notes");
-    draw_items_for_severity(hs->ei_array[chat_level],  "Chats");
-    draw_items_for_severity(hs->ei_array[comment_level],  "Comments");
+    draw_items_for_severity(hs->ei_aggregate[error_level], "Errors");
+    draw_items_for_severity(hs->ei_aggregate[warn_level],  "Warns");
+    draw_items_for_severity(hs->ei_aggregate[note_level],  "Notes");
+    draw_items_for_severity(hs->ei_aggregate[chat_level],  "Chats");
+    draw_items_for_severity(hs->ei_aggregate[comment_level],  "Comments");
 }
 
 static void
 expert_tapdata_free(expert_tapdata_t* hs)
 {
     for (int n = 0; n < max_level; n++) {
-        g_array_free(hs->ei_array[n], true);
+        expert_aggregate_free(hs->ei_aggregate[n]);
     }
-    g_string_chunk_free(hs->text);
     g_free(hs);
 }
 
@@ -245,12 +210,9 @@ static bool expert_stat_init(const char *opt_arg, void *userdata _U_)
     hs = g_new0(expert_tapdata_t, 1);
     hs->lowest_report_level = lowest_report_level;
 
-    /* Allocate chunk of strings */
-    hs->text = g_string_chunk_new(100);
-
-    /* Allocate GArray for each severity level */
+    /* Allocate an aggregate for each severity level */
     for (n=0; n < max_level; n++) {
-        hs->ei_array[n] = g_array_sized_new(false, false, sizeof(expert_entry), 1000);
+        hs->ei_aggregate[n] = expert_aggregate_new(EXPERT_AGGREGATE_BY_SUMMARY);
     }
 
     /**********************************************/
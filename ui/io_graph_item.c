@@ -310,3 +310,103 @@ double get_io_graph_item(const io_graph_item_t *items_, io_graph_item_unit_t val
     }
     return value;
 }
+
+static void
+merge_io_graph_item(io_graph_item_t *dst, const io_graph_item_t *src, enum ftenum ftype)
+{
+    if (src->first_frame_in_invl != 0 && dst->first_frame_in_invl == 0) {
+        dst->first_frame_in_invl = src->first_frame_in_invl;
+    }
+    if (src->last_frame_in_invl != 0) {
+        dst->last_frame_in_invl = src->last_frame_in_invl;
+    }
+    dst->frames += src->frames;
+    dst->bytes += src->bytes;
+
+    if (src->fields == 0) {
+        /* LOAD can add to time_tot without a field in this interval. */
+        if (ftype == FT_RELATIVE_TIME) {
+            nstime_add(&dst->time_tot, &src->time_tot);
+        }
+        return;
+    }
+
+    switch (ftype) {
+    case FT_UINT8:
+    case FT_UINT16:
+    case FT_UINT24:
+    case FT_UINT32:
+    case FT_UINT40:
+    case FT_UINT48:
+    case FT_UINT56:
+    case FT_UINT64:
+        if (dst->fields == 0 || src->uint_max > dst->uint_max) {
+            dst->uint_max = src->uint_max;
+            dst->max_frame_in_invl = src->max_frame_in_invl;
+        }
+        if (dst->fields == 0 || src->uint_min < dst->uint_min) {
+            dst->uint_min = src->uint_min;
+            dst->min_frame_in_invl = src->min_frame_in_invl;
+        }
+        dst->double_tot += src->double_tot;
+        break;
+    case FT_INT8:
+    case FT_INT16:
+    case FT_INT24:
+    case FT_INT32:
+    case FT_INT40:
+    case FT_INT48:
+    case FT_INT56:
+    case FT_INT64:
+        if (dst->fields == 0 || src->int_max > dst->int_max) {
+            dst->int_max = src->int_max;
+            dst->max_frame_in_invl = src->max_frame_in_invl;
+        }
+        if (dst->fields == 0 || src->int_min < dst->int_min) {
+            dst->int_min = src->int_min;
+            dst->min_frame_in_invl = src->min_frame_in_invl;
+        }
+        dst->double_tot += src->double_tot;
+        break;
+    case FT_FLOAT:
+    case FT_DOUBLE:
+        if (dst->fields == 0 || src->double_max > dst->double_max) {
+            dst->double_max = src->double_max;
+            dst->max_frame_in_invl = src->max_frame_in_invl;
+        }
+        if (dst->fields == 0 || src->double_min < dst->double_min) {
+            dst->double_min = src->double_min;
+            dst->min_frame_in_invl = src->min_frame_in_invl;
+        }
+        dst->double_tot += src->double_tot;
+        break;
+    case FT_RELATIVE_TIME:
+        if (dst->fields == 0 || nstime_cmp(&src->time_max, &dst->time_max) > 0) {
+            dst->time_max = src->time_max;
+            dst->max_frame_in_invl = src->max_frame_in_invl;
+        }
+        if (dst->fields == 0 || nstime_cmp(&src->time_min, &dst->time_min) < 0) {
+            dst->time_min = src->time_min;
+            dst->min_frame_in_invl = src->min_frame_in_invl;
+        }
+        nstime_add(&dst->time_tot, &src->time_tot);
+        break;
+    default:
+        /* Only COUNT FRAMES and COUNT FIELDS are supported for these. */
+        break;
+    }
+    dst->fields += src->fields;
+}
+
+void merge_io_graph_items(const io_graph_item_t *src, size_t src_count, unsigned factor, io_graph_item_t *dst, int hf_index)
+{
+    enum ftenum ftype = hf_index >= 0 ? proto_registrar_get_ftype(hf_index) : FT_NONE;
+
+    if (factor == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < src_count; i++) {
+        merge_io_graph_item(&dst[i / factor], &src[i], ftype);
+    }
+}
@@ -207,6 +207,24 @@ GString *check_field_unit(const char *field_name, int *hf_index, io_graph_item_u
  */
 double get_io_graph_item(const io_graph_item_t *items, io_graph_item_unit_t val_units, int idx, int hf_index, const capture_file *cap_file, int interval, int cur_idx, bool asAOT);
 
+/** Merge consecutive items into coarser intervals.
+ *
+ * Each destination item combines @p factor consecutive source items, so
+ * items tapped at interval I can be turned into items at interval I *
+ * factor without retapping. Counts, totals, minimums, maximums and the
+ * frame numbers that go with them are all exact, because interval
+ * boundaries at the coarser interval are also boundaries at the finer one.
+ *
+ * @param src [in] Array containing the items to merge.
+ * @param src_count [in] The number of items in src.
+ * @param factor [in] The number of source items per destination item.
+ * @param dst [out] Array receiving the merged items. It must have room for
+ *                  (src_count + factor - 1) / factor items, which must have
+ *                  been reset with reset_io_graph_items().
+ * @param hf_index [in] Header field index for advanced statistics.
+ */
+void merge_io_graph_items(const io_graph_item_t *src, size_t src_count, unsigned factor, io_graph_item_t *dst, int hf_index);
+
 /** Update the values of an io_graph_item_t.
  *
  * Frame and byte counts are always calculated. If edt is non-NULL advanced
@@ -35,6 +35,7 @@
 
 #include "ui/qt/widgets/wireshark_file_dialog.h"
 
+#include <QDir>
 #include <QElapsedTimer>
 #include <QKeyEvent>
 #include <QMenu>
@@ -60,6 +61,11 @@ static QMutex loop_break_mutex;
 // Indicates that a Follow Stream is currently running
 static bool isReadRunning;
 
+// Payload bytes formatted into the text display at a time. The formats
+// take up to about five characters per byte, which keeps each page well
+// below FollowStreamText's limit and quick to lay out.
+static const qint64 page_payload_len_ = 1024 * 1024;
+
 Q_DECLARE_METATYPE(bytes_show_type)
 
 FollowStreamDialog::FollowStreamDialog(QWidget &parent, CaptureFile &cf, int proto_id, const QString& previous_filter) :
@@ -76,9 +82,14 @@ FollowStreamDialog::FollowStreamDialog(QWidget &parent, CaptureFile &cf, int pro
     last_packet_(0),
     last_from_server_(0),
     turns_(0),
+    save_device_(nullptr),
     use_regex_find_(false),
     terminating_(false),
-    previous_sub_stream_num_(0)
+    previous_sub_stream_num_(0),
+    stream_log_(nullptr),
+    stream_log_map_(nullptr),
+    stream_log_len_(0),
+    cur_page_(0)
 {
     ui->setupUi(this);
     loadGeometry(parent.width() * 2 / 3, parent.height());
@@ -96,6 +107,16 @@ FollowStreamDialog::FollowStreamDialog(QWidget &parent, CaptureFile &cf, int pro
     memset(&follow_info_, 0, sizeof(follow_info_));
     follow_info_.show_stream = BOTH_HOSTS;
     follow_info_.substream_id = SUBSTREAM_UNUSED;
+    follow_info_.gui_data = this;
+
+    // The follow taps collect every record in memory. We move each record
+    // to this file as soon as it is tapped, and only format the page being
+    // shown, so memory use doesn't grow with the size of the stream.
+    QString tempname = QStringLiteral("%1/wireshark_follow").arg(QDir::tempPath());
+    stream_log_ = new QTemporaryFile(tempname, this);
+    if (!stream_log_->open()) {
+        stream_log_error_ = stream_log_->errorString();
+    }
 
     nstime_set_zero(&last_ts_);
 
@@ -161,6 +182,8 @@ FollowStreamDialog::FollowStreamDialog(QWidget &parent, CaptureFile &cf, int pro
             this, &FollowStreamDialog::goToPacketForTextPos);
 
     connect(ui->bFind, &QPushButton::clicked, this, &FollowStreamDialog::bFindClicked);
+    connect(ui->bPreviousPage, &QToolButton::clicked, this, &FollowStreamDialog::bPreviousPageClicked);
+    connect(ui->bNextPage, &QToolButton::clicked, this, &FollowStreamDialog::bNextPageClicked);
     connect(ui->leFind, &FindLineEdit::returnPressed, this, &FollowStreamDialog::leFindReturnPressed);
 
     connect(ui->buttonBox, &QDialogButtonBox::rejected, this, &FollowStreamDialog::buttonBoxRejected);
@@ -175,6 +198,7 @@ FollowStreamDialog::FollowStreamDialog(QWidget &parent, CaptureFile &cf, int pro
         fillHintLabel();
     });
 
+    updatePageWidgets();
     fillHintLabel();
 }
 
@@ -278,6 +302,11 @@ void FollowStreamDialog::updateWidgets(bool follow_in_progress)
     }
     ui->leFind->setEnabled(enable);
     ui->bFind->setEnabled(enable);
+    updatePageWidgets();
+    if (!enable) {
+        ui->bPreviousPage->setEnabled(false);
+        ui->bNextPage->setEnabled(false);
+    }
     b_filter_prepare_->setEnabled(enable);
     b_filter_apply_->setEnabled(enable);
     b_print_->setEnabled(enable);
@@ -301,6 +330,30 @@ void FollowStreamDialog::findText(bool go_back)
 {
     if (ui->leFind->text().isEmpty()) return;
 
+    if (findTextInPage()) {
+        ui->teStreamContent->setFocus();
+    } else if (stream_pages_.size() > 1) {
+        // Search the following pages, wrapping around to the start of
+        // this one. Matches that span two pages aren't found.
+        int start_page = cur_page_;
+        for (int i = 1; i <= stream_pages_.size(); i++) {
+            showPage((start_page + i) % stream_pages_.size());
+            if (dialogClosed()) {
+                return;
+            }
+            if (findTextInPage()) {
+                ui->teStreamContent->setFocus();
+                return;
+            }
+        }
+    } else if (go_back) {
+        ui->teStreamContent->moveCursor(QTextCursor::Start);
+        findText(false);
+    }
+}
+
+bool FollowStreamDialog::findTextInPage()
+{
     bool found;
 
     QTextDocument::FindFlags options;
@@ -323,12 +376,7 @@ void FollowStreamDialog::findText(bool go_back)
         found = ui->teStreamContent->find(ui->leFind->text(), options);
     }
 
-    if (found) {
-        ui->teStreamContent->setFocus();
-    } else if (go_back) {
-        ui->teStreamContent->moveCursor(QTextCursor::Start);
-        findText(false);
-    }
+    return found;
 }
 
 void FollowStreamDialog::saveAs()
@@ -340,22 +388,16 @@ void FollowStreamDialog::saveAs()
 
     QFile file(file_name);
     if (!file.open(QIODevice::WriteOnly)) {
-        report_open_failure(file_name.toUtf8().constData(), errno, true);
+        QMessageBox::warning(this, tr("Warning"), tr("Unable to save %1: %2").arg(file_name, file.errorString()));
         return;
     }
 
-    // XXX: What if truncated_ is true? We should save the entire stream.
-    // Unconditionally save data as UTF-8 (even if data is decoded otherwise).
-    QByteArray bytes = ui->teStreamContent->toPlainText().toUtf8();
-    if (recent.gui_follow_show == SHOW_RAW) {
-        // The "Raw" format is currently displayed as hex data and needs to be
-        // converted to binary data. fromHex() skips over non hex characters
-        // including line breaks, which is what we want.
-        bytes = QByteArray::fromHex(bytes);
+    // Write from the stream log rather than the text display, which only
+    // holds the page being shown.
+    if (!writeFollowStream(&file) || !file.flush()) {
+        QString error = file.error() != QFileDevice::NoError ? file.errorString() : stream_log_->errorString();
+        QMessageBox::warning(this, tr("Warning"), tr("Unable to save %1: %2").arg(file_name, error));
     }
-
-    QDataStream out(&file);
-    out.writeRawData(bytes.constData(), static_cast<int>(bytes.size()));
 }
 
 void FollowStreamDialog::helpButton()
@@ -543,6 +585,20 @@ void FollowStreamDialog::buttonBoxRejected()
     WiresharkDialog::reject();
 }
 
+void FollowStreamDialog::bPreviousPageClicked()
+{
+    if (cur_page_ > 0) {
+        showPage(cur_page_ - 1);
+    }
+}
+
+void FollowStreamDialog::bNextPageClicked()
+{
+    if (cur_page_ < stream_pages_.size() - 1) {
+        showPage(cur_page_ + 1);
+    }
+}
+
 void FollowStreamDialog::removeStreamControls()
 {
     ui->horizontalLayout->removeItem(ui->streamNumberSpacer);
@@ -556,15 +612,185 @@ void FollowStreamDialog::resetStream(void *tap_data)
 {
     follow_info_t *follow_info = static_cast<follow_info_t*>(tap_data);
     follow_reset_stream(follow_info);
+    static_cast<FollowStreamDialog *>(follow_info->gui_data)->resetStreamLog();
     // If we ever draw the text while tapping (instead of only after
     // the tap finishes), reset the GUI here too.
 }
 
+tap_packet_status FollowStreamDialog::tapPacket(void *tapdata, packet_info *pinfo, epan_dissect_t *edt, const void *data, tap_flags_t flags)
+{
+    follow_info_t *follow_info = static_cast<follow_info_t*>(tapdata);
+    FollowStreamDialog *follow_dialog = static_cast<FollowStreamDialog *>(follow_info->gui_data);
+
+    tap_packet_status status = get_follow_tap_handler(follow_dialog->follower_)(tapdata, pinfo, edt, data, flags);
+    follow_dialog->spoolStreamRecords();
+    return status;
+}
+
 void FollowStreamDialog::resetStream()
 {
     FollowStreamDialog::resetStream(&follow_info_);
 }
 
+void FollowStreamDialog::resetStreamLog()
+{
+    // interrupt any reading of the old log
+    loop_break_mutex.lock();
+    isReadRunning = false;
+    loop_break_mutex.unlock();
+
+    if (stream_log_map_) {
+        stream_log_->unmap(stream_log_map_);
+        stream_log_map_ = nullptr;
+    }
+    stream_log_len_ = 0;
+    stream_log_records_.clear();
+    stream_pages_.clear();
+    cur_page_ = 0;
+
+    if (!stream_log_->isOpen()) {
+        // The constructor couldn't create it.
+        return;
+    }
+    stream_log_error_.clear();
+    if (!stream_log_->resize(0) || !stream_log_->seek(0)) {
+        stream_log_error_ = stream_log_->errorString();
+    }
+}
+
+// The follow taps prepend their records to follow_info_.payload. This runs
+// after each packet, so the list only holds the records of that packet.
+void FollowStreamDialog::spoolStreamRecords()
+{
+    GList *cur;
+    follow_record_t *follow_record;
+
+    for (cur = g_list_last(follow_info_.payload); cur; cur = g_list_previous(cur)) {
+        follow_record = (follow_record_t *)cur->data;
+
+        if (follow_record->data && stream_log_error_.isEmpty()) {
+            StreamLogRecord record;
+            record.offset = stream_log_len_;
+            record.len = follow_record->data->len;
+            record.packet_num = follow_record->packet_num;
+            record.abs_ts = follow_record->abs_ts;
+            record.is_server = follow_record->is_server;
+
+            if (stream_log_->write((const char *)follow_record->data->data, record.len) == record.len) {
+                stream_log_len_ += record.len;
+                stream_log_records_.append(record);
+            } else {
+                stream_log_error_ = stream_log_->errorString();
+            }
+        }
+
+        if (follow_record->data) {
+            g_byte_array_free(follow_record->data, true);
+        }
+        g_free(follow_record);
+    }
+    g_list_free(follow_info_.payload);
+    follow_info_.payload = NULL;
+}
+
+void FollowStreamDialog::mapStreamLog()
+{
+    if (stream_log_map_ || stream_log_len_ == 0 || !stream_log_->flush()) {
+        return;
+    }
+
+    // If this fails (e.g. a large stream on a 32-bit system),
+    // readStreamLogRecord reads from the file instead.
+    stream_log_map_ = stream_log_->map(0, stream_log_len_, QFileDevice::MapPrivateOption);
+}
+
+bool FollowStreamDialog::readStreamLogRecord(const StreamLogRecord &record, QByteArray &buffer)
+{
+    if (stream_log_map_) {
+        // This will only detach / deep copy if the buffer data is
+        // modified. Try to avoid doing that as much as possible
+        // (and avoid new memory allocations that have to be freed).
+        buffer.setRawData((const char *)stream_log_map_ + record.offset, record.len);
+        return true;
+    }
+
+    if (!stream_log_->seek(record.offset)) {
+        return false;
+    }
+    buffer = stream_log_->read(record.len);
+    return buffer.size() == static_cast<qsizetype>(record.len);
+}
+
+bool FollowStreamDialog::isRecordShown(const StreamLogRecord &record) const
+{
+    if (record.is_server) {
+        return follow_info_.show_stream != FROM_CLIENT;
+    }
+    return follow_info_.show_stream != FROM_SERVER;
+}
+
+void FollowStreamDialog::paginateStream()
+{
+    uint32_t global_client_pos = 0, global_server_pos = 0;
+    qint64 page_len = 0;
+
+    stream_pages_.clear();
+    for (int i = 0; i < stream_log_records_.size(); i++) {
+        const StreamLogRecord &record = stream_log_records_.at(i);
+        if (!isRecordShown(record)) {
+            continue;
+        }
+
+        if (stream_pages_.isEmpty() || page_len >= page_payload_len_) {
+            StreamPage page;
+            page.first_record = i;
+            page.global_client_pos = global_client_pos;
+            page.global_server_pos = global_server_pos;
+            page.client_buffer_count = client_buffer_count_;
+            page.server_buffer_count = server_buffer_count_;
+            page.last_packet = last_packet_;
+            page.last_from_server = last_from_server_;
+            page.last_ts = last_ts_;
+            stream_pages_.append(page);
+            page_len = 0;
+        }
+
+        skipBuffer(record.len, record.is_server, record.packet_num, record.abs_ts,
+                   record.is_server ? &global_server_pos : &global_client_pos);
+        page_len += record.len;
+    }
+}
+
+void FollowStreamDialog::showPage(int page)
+{
+    // interrupt any reading already running
+    loop_break_mutex.lock();
+    isReadRunning = false;
+    loop_break_mutex.unlock();
+
+    cur_page_ = page;
+    ui->teStreamContent->clear();
+    readFollowStream();
+    ui->teStreamContent->moveCursor(QTextCursor::Start);
+    updatePageWidgets();
+}
+
+void FollowStreamDialog::updatePageWidgets()
+{
+    bool paged = stream_pages_.size() > 1;
+
+    ui->bPreviousPage->setVisible(paged);
+    ui->lPage->setVisible(paged);
+    ui->bNextPage->setVisible(paged);
+    if (!paged) {
+        return;
+    }
+
+    ui->lPage->setText(tr("Part %1 of %2").arg(cur_page_ + 1).arg(stream_pages_.size()));
+    ui->bPreviousPage->setEnabled(cur_page_ > 0);
+    ui->bNextPage->setEnabled(cur_page_ < stream_pages_.size() - 1);
+}
+
 void FollowStreamDialog::readStream()
 {
 
@@ -602,13 +828,21 @@ void FollowStreamDialog::readStream()
     client_packet_count_ = 0;
     server_packet_count_ = 0;
     last_packet_ = 0;
+    nstime_set_zero(&last_ts_);
     turns_ = 0;
 
     if (!follower_) {
         ws_assert_not_reached();
     }
 
+    // Changing the direction changes the pages; stay as close as we can.
+    paginateStream();
+    if (cur_page_ >= stream_pages_.size()) {
+        cur_page_ = stream_pages_.isEmpty() ? 0 : static_cast<int>(stream_pages_.size()) - 1;
+    }
+
     readFollowStream();
+    updatePageWidgets();
 
     ui->teStreamContent->moveCursor(QTextCursor::Start);
 
@@ -624,6 +858,12 @@ FollowStreamDialog::followStream()
 
 void FollowStreamDialog::addText(QString text, bool is_from_server, uint32_t packet_num, bool colorize)
 {
+    if (save_device_) {
+        // Unconditionally save data as UTF-8 (even if data is decoded otherwise).
+        save_device_->write(text.toUtf8());
+        return;
+    }
+
     bool marked = false;
     frame_data *fdata = frame_data_sequence_find(cap_file_.capFile()->provider.frames, packet_num);
     if (fdata) {
@@ -634,6 +874,15 @@ void FollowStreamDialog::addText(QString text, bool is_from_server, uint32_t pac
     ui->teStreamContent->addText(std::move(text), is_from_server, packet_num, colorize, marked);
 }
 
+void FollowStreamDialog::addDeltaTime(double delta)
+{
+    if (save_device_) {
+        save_device_->write(QStringLiteral("\n%1s").arg(QString::number(delta, 'f', 6)).toUtf8());
+        return;
+    }
+    ui->teStreamContent->addDeltaTime(delta);
+}
+
 // The following keyboard shortcuts should work (although
 // they may not work consistently depending on focus):
 // / (slash), Ctrl-F - Focus and highlight the search box
@@ -729,7 +978,7 @@ void FollowStreamDialog::showBuffer(QByteArray &buffer, size_t nchars, bool is_f
         /* If our native arch is ASCII, call: */
         EBCDIC_to_ASCII((uint8_t*)buffer.data(), (unsigned) nchars);
         if (show_delta) {
-            ui->teStreamContent->addDeltaTime(delta);
+            addDeltaTime(delta);
         }
         if (show_delta || last_from_server_ != is_from_server) {
             addText("\n", is_from_server, packet_num);
@@ -745,7 +994,7 @@ void FollowStreamDialog::showBuffer(QByteArray &buffer, size_t nchars, bool is_f
          * ASCII_TO_EBCDIC(buffer, nchars);
          */
         if (show_delta) {
-            ui->teStreamContent->addDeltaTime(delta);
+            addDeltaTime(delta);
         }
         if (show_delta || last_from_server_ != is_from_server) {
             addText("\n", is_from_server, packet_num);
@@ -758,7 +1007,7 @@ void FollowStreamDialog::showBuffer(QByteArray &buffer, size_t nchars, bool is_f
     case SHOW_CODEC:
     {
         if (show_delta) {
-            ui->teStreamContent->addDeltaTime(delta);
+            addDeltaTime(delta);
         }
         if (show_delta || last_from_server_ != is_from_server) {
             addText("\n", is_from_server, packet_num);
@@ -942,6 +1191,11 @@ DIAG_ON(stringop-overread)
 
     case SHOW_RAW:
     {
+        if (save_device_) {
+            // The "Raw" format is displayed as hex, but saved as binary.
+            save_device_->write(buffer.constData(), static_cast<qint64>(nchars));
+            break;
+        }
         addText(buffer.toHex() + '\n', is_from_server, packet_num);
         break;
     }
@@ -953,6 +1207,57 @@ DIAG_ON(stringop-overread)
         ws_assert_not_reached();
     }
 
+    countPacket(is_from_server, packet_num);
+}
+
+// This has to make the same changes to the formatting state as showBuffer,
+// so that a page can be formatted without formatting the ones before it.
+void FollowStreamDialog::skipBuffer(size_t nchars, bool is_from_server, uint32_t packet_num,
+                                nstime_t abs_ts, uint32_t *global_pos)
+{
+    if (last_packet_ == 0) {
+        last_from_server_ = is_from_server;
+    }
+
+    if (!nstime_is_zero(&abs_ts)) {
+        last_ts_ = abs_ts;
+    }
+
+    switch (recent.gui_follow_show) {
+
+    case SHOW_HEXDUMP:
+        (*global_pos) += static_cast<uint32_t>(nchars);
+        break;
+
+    case SHOW_CARRAY:
+        if (is_from_server) {
+            server_buffer_count_++;
+        } else {
+            client_buffer_count_++;
+        }
+        (*global_pos) += static_cast<uint32_t>(nchars);
+        break;
+
+    case SHOW_YAML:
+        if (packet_num != last_packet_) {
+            if (is_from_server) {
+                server_buffer_count_++;
+            } else {
+                client_buffer_count_++;
+            }
+        }
+        (*global_pos) += static_cast<uint32_t>(nchars);
+        break;
+
+    default:
+        break;
+    }
+
+    countPacket(is_from_server, packet_num);
+}
+
+void FollowStreamDialog::countPacket(bool is_from_server, uint32_t packet_num)
+{
     if (packet_num != last_packet_) {
         last_packet_ = packet_num;
         if (is_from_server) {
@@ -1078,7 +1383,7 @@ bool FollowStreamDialog::follow(bool use_stream_index, unsigned stream_num, unsi
     if (!registerTapListener(get_follow_tap_string(follower_), &follow_info_,
                                 follow_filter_.toUtf8().constData(),
                                 0, FollowStreamDialog::resetStream,
-                                get_follow_tap_handler(follower_), NULL)) {
+                                FollowStreamDialog::tapPacket, NULL)) {
         return false;
     }
 
@@ -1137,6 +1442,7 @@ void FollowStreamDialog::endRetapPackets()
 {
     if (listening()) {
         removeTapListeners();
+        mapStreamLog();
 
         ui->cbDirections->blockSignals(true);
         ui->cbDirections->clear();
@@ -1149,6 +1455,11 @@ void FollowStreamDialog::endRetapPackets()
         fillHintLabel();
 
         updateWidgets(false);
+
+        if (!stream_log_error_.isEmpty()) {
+            QMessageBox::warning(this, tr("Error following stream."),
+                                 tr("Unable to store the stream in a temporary file: %1. Only the part stored before the error is shown.").arg(stream_log_error_));
+        }
     }
 
     WiresharkDialog::endRetapPackets();
@@ -1164,59 +1475,132 @@ void FollowStreamDialog::captureFileClosed()
 
 void FollowStreamDialog::readFollowStream()
 {
-    uint32_t global_client_pos = 0, global_server_pos = 0;
-    uint32_t *global_pos;
-    bool skip;
-    GList* cur;
-    follow_record_t *follow_record;
     QElapsedTimer elapsed_timer;
     QByteArray buffer;
 
+    if (cur_page_ >= stream_pages_.size()) {
+        return;
+    }
+
     elapsed_timer.start();
 
     loop_break_mutex.lock();
     isReadRunning = true;
     loop_break_mutex.unlock();
 
-    for (cur = g_list_last(follow_info_.payload); cur; cur = g_list_previous(cur)) {
+    // The packet and turn counts are for the whole stream (see
+    // paginateStream); the rest of the formatting state starts where
+    // the page does.
+    int client_packet_count = client_packet_count_;
+    int server_packet_count = server_packet_count_;
+    int turns = turns_;
+
+    StreamPage page = stream_pages_.at(cur_page_);
+    int end_record = cur_page_ + 1 < stream_pages_.size() ? stream_pages_.at(cur_page_ + 1).first_record : static_cast<int>(stream_log_records_.size());
+    uint32_t global_client_pos = page.global_client_pos;
+    uint32_t global_server_pos = page.global_server_pos;
+    client_buffer_count_ = page.client_buffer_count;
+    server_buffer_count_ = page.server_buffer_count;
+    last_packet_ = page.last_packet;
+    last_from_server_ = page.last_from_server;
+    last_ts_ = page.last_ts;
+
+    for (int i = page.first_record; i < end_record; i++) {
         if (dialogClosed() || !isReadRunning) break;
 
-        follow_record = (follow_record_t *)cur->data;
-        skip = false;
-        if (!follow_record->is_server) {
-            global_pos = &global_client_pos;
-            if (follow_info_.show_stream == FROM_SERVER) {
-                skip = true;
-            }
-        } else {
-            global_pos = &global_server_pos;
-            if (follow_info_.show_stream == FROM_CLIENT) {
-                skip = true;
-            }
+        StreamLogRecord record = stream_log_records_.at(i);
+        if (!isRecordShown(record)) {
+            continue;
         }
 
-        if (!skip) {
-            // This will only detach / deep copy if the buffer data is
-            // modified. Try to avoid doing that as much as possible
-            // (and avoid new memory allocations that have to be freed).
-            buffer.setRawData((char*)follow_record->data->data, follow_record->data->len);
-            showBuffer(
-                    buffer,
-                    follow_record->data->len,
-                    follow_record->is_server,
-                    follow_record->packet_num,
-                    follow_record->abs_ts,
-                    global_pos);
-            if (elapsed_timer.elapsed() > info_update_freq_) {
-                fillHintLabel(ui->teStreamContent->currentPacket());
-                mainApp->processEvents();
-                elapsed_timer.start();
-            }
+        if (!readStreamLogRecord(record, buffer)) {
+            break;
+        }
+        showBuffer(
+                buffer,
+                record.len,
+                record.is_server,
+                record.packet_num,
+                record.abs_ts,
+                record.is_server ? &global_server_pos : &global_client_pos);
+        if (elapsed_timer.elapsed() > info_update_freq_) {
+            fillHintLabel(ui->teStreamContent->currentPacket());
+            mainApp->processEvents();
+            elapsed_timer.start();
         }
     }
 
+    if (!isReadRunning) {
+        // Interrupted by a newer pass, which has set up its own state.
+        return;
+    }
+
+    client_packet_count_ = client_packet_count;
+    server_packet_count_ = server_packet_count;
+    turns_ = turns;
+
     loop_break_mutex.lock();
     isReadRunning = false;
     loop_break_mutex.unlock();
 }
 
+bool FollowStreamDialog::writeFollowStream(QFile *file)
+{
+    uint32_t global_client_pos = 0, global_server_pos = 0;
+    QByteArray buffer;
+    bool read_ok = true;
+
+    // showBuffer() keeps per-pass state for the display; start a fresh
+    // pass and put the display's state back afterwards.
+    int client_buffer_count = client_buffer_count_;
+    int server_buffer_count = server_buffer_count_;
+    int client_packet_count = client_packet_count_;
+    int server_packet_count = server_packet_count_;
+    uint32_t last_packet = last_packet_;
+    bool last_from_server = last_from_server_;
+    nstime_t last_ts = last_ts_;
+    int turns = turns_;
+
+    client_buffer_count_ = 0;
+    server_buffer_count_ = 0;
+    client_packet_count_ = 0;
+    server_packet_count_ = 0;
+    last_packet_ = 0;
+    nstime_set_zero(&last_ts_);
+    turns_ = 0;
+
+    save_device_ = file;
+    for (int i = 0; i < stream_log_records_.size(); i++) {
+        const StreamLogRecord &record = stream_log_records_.at(i);
+        if (!isRecordShown(record)) {
+            continue;
+        }
+
+        if (!readStreamLogRecord(record, buffer)) {
+            read_ok = false;
+            break;
+        }
+        showBuffer(
+                buffer,
+                record.len,
+                record.is_server,
+                record.packet_num,
+                record.abs_ts,
+                record.is_server ? &global_server_pos : &global_client_pos);
+        if (file->error() != QFileDevice::NoError) {
+            break;
+        }
+    }
+    save_device_ = nullptr;
+
+    client_buffer_count_ = client_buffer_count;
+    server_buffer_count_ = server_buffer_count;
+    client_packet_count_ = client_packet_count;
+    server_packet_count_ = server_packet_count;
+    last_packet_ = last_packet;
+    last_from_server_ = last_from_server;
+    last_ts_ = last_ts;
+    turns_ = turns;
+
+    return read_ok && file->error() == QFileDevice::NoError;
+}
@@ -27,6 +27,8 @@
 #include <QFile>
 #include <QMap>
 #include <QPushButton>
+#include <QTemporaryFile>
+#include <QVector>
 
 namespace Ui {
 class FollowStreamDialog;
@@ -240,6 +242,16 @@ private slots:
      */
     void buttonBoxRejected();
 
+    /**
+     * @brief Slot triggered when the previous page button is clicked.
+     */
+    void bPreviousPageClicked();
+
+    /**
+     * @brief Slot triggered when the next page button is clicked.
+     */
+    void bNextPageClicked();
+
 signals:
     /**
      * @brief Signal emitted to update the main display filter.
@@ -255,12 +267,46 @@ signals:
     void goToPacket(int packet_num);
 
 private:
+    /**
+     * @brief Where one followed record's payload is stored in the stream log.
+     */
+    struct StreamLogRecord {
+        qint64      offset;         /**< Offset of the payload in the log. */
+        uint32_t    len;            /**< Length of the payload. */
+        uint32_t    packet_num;     /**< Packet the payload came from. */
+        nstime_t    abs_ts;         /**< Timestamp of that packet. */
+        bool        is_server;      /**< True if the payload came from the server. */
+    };
+
+    /**
+     * @brief The first record of a page and the formatting state before it.
+     */
+    struct StreamPage {
+        int         first_record;           /**< Index of the first record in the log. */
+        uint32_t    global_client_pos;      /**< Client byte offset. */
+        uint32_t    global_server_pos;      /**< Server byte offset. */
+        int         client_buffer_count;    /**< Client buffers formatted so far. */
+        int         server_buffer_count;    /**< Server buffers formatted so far. */
+        uint32_t    last_packet;            /**< Packet of the previous record. */
+        bool        last_from_server;       /**< Direction of the previous record. */
+        nstime_t    last_ts;                /**< Timestamp of the previous record. */
+    };
+
     /**
      * @brief Callback used by register_tap_listener to reset the stream state.
      * @param tapData Pointer to the tap data.
      */
     static void resetStream(void *tapData);
 
+    /**
+     * @brief Callback used by register_tap_listener for each packet.
+     *
+     * Runs the follower's tap handler, then moves the records it added
+     * to the stream log.
+     * @return The status returned by the follower's tap handler.
+     */
+    static tap_packet_status tapPacket(void *tapdata, packet_info *pinfo, epan_dissect_t *edt, const void *data, tap_flags_t flags);
+
     /**
      * @brief Hides or removes UI controls related to stream selection if not applicable.
      */
@@ -271,6 +317,60 @@ private:
      */
     void resetStream(void);
 
+    /**
+     * @brief Empties the stream log and forgets its records and pages.
+     */
+    void resetStreamLog();
+
+    /**
+     * @brief Moves the records in follow_info_ to the end of the stream log.
+     */
+    void spoolStreamRecords();
+
+    /**
+     * @brief Maps the stream log into memory once the tap has finished.
+     */
+    void mapStreamLog();
+
+    /**
+     * @brief Gets the payload of a record from the stream log.
+     * @param record The record to read.
+     * @param buffer Set to the payload; it might refer to the mapped log.
+     * @return True on success, false if the log couldn't be read.
+     */
+    bool readStreamLogRecord(const StreamLogRecord &record, QByteArray &buffer);
+
+    /**
+     * @brief Checks if a record is in the direction(s) being shown.
+     * @param record The record to check.
+     * @return True if the record is shown.
+     */
+    bool isRecordShown(const StreamLogRecord &record) const;
+
+    /**
+     * @brief Splits the shown records into pages.
+     *
+     * Also counts the packets and turns of the whole stream.
+     */
+    void paginateStream();
+
+    /**
+     * @brief Replaces the text display with a page of the stream.
+     * @param page The page to show.
+     */
+    void showPage(int page);
+
+    /**
+     * @brief Updates the page buttons and label.
+     */
+    void updatePageWidgets();
+
+    /**
+     * @brief Finds the next match in the page that is shown.
+     * @return True if a match was found.
+     */
+    bool findTextInPage();
+
     /**
      * @brief Updates the states of the dialog widgets based on processing status.
      * @param follow_in_progress True if the stream is currently being analyzed.
@@ -294,16 +394,44 @@ private:
     void showBuffer(QByteArray &buffer, size_t nchars, bool is_from_server,
                 uint32_t packet_num, nstime_t abs_ts, uint32_t *global_pos);
 
+    /**
+     * @brief Updates the formatting state as showBuffer() would, without formatting.
+     * @param nchars The number of bytes in the buffer.
+     * @param is_from_server True if the data originated from the server.
+     * @param packet_num The packet number containing this data.
+     * @param abs_ts The absolute timestamp of the packet.
+     * @param global_pos Pointer to the global character position tracker.
+     */
+    void skipBuffer(size_t nchars, bool is_from_server,
+                uint32_t packet_num, nstime_t abs_ts, uint32_t *global_pos);
+
+    /**
+     * @brief Counts the packet and turn a buffer belongs to, if it starts a new one.
+     * @param is_from_server True if the data originated from the server.
+     * @param packet_num The packet number containing this data.
+     */
+    void countPacket(bool is_from_server, uint32_t packet_num);
+
     /**
      * @brief Triggers reading of the stream data.
      */
     void readStream();
 
     /**
-     * @brief Reads the stream data utilizing the specific registered follower.
+     * @brief Formats the current page of the stream into the text display.
      */
     void readFollowStream();
 
+    /**
+     * @brief Writes the entire stream to a device in the current format.
+     *
+     * Formats the records in the stream log directly instead of copying
+     * the text display, which only holds one page.
+     * @param file The open file to write to.
+     * @return True on success, false if reading the log or writing failed.
+     */
+    bool writeFollowStream(QFile *file);
+
     /**
      * @brief Orchestrates the entire follow stream extraction and display process.
      */
@@ -318,6 +446,12 @@ private:
      */
     void addText(QString text, bool is_from_server, uint32_t packet_num, bool colorize = true);
 
+    /**
+     * @brief Adds a time delta line to the display window.
+     * @param delta The time since the previous segment, in seconds.
+     */
+    void addDeltaTime(double delta);
+
     void filterMenuAboutToShow(QMenu *, bool);
 
     /** Pointer to the generated UI elements. */
@@ -380,6 +514,9 @@ private:
     /** Counter for how many times the stream changes direction. */
     int                     turns_;
 
+    /** If set, formatted stream data is written here instead of the text display. */
+    QIODevice               *save_device_;
+
     /** Flag indicating if the find operation uses regular expressions. */
     bool                    use_regex_find_;
 
@@ -388,6 +525,27 @@ private:
 
     /** The previously selected sub-stream number. */
     int                     previous_sub_stream_num_;
+
+    /** Temporary file holding the payload of every followed record. */
+    QTemporaryFile          *stream_log_;
+
+    /** The stream log mapped into memory, or NULL to read it instead. */
+    uchar                   *stream_log_map_;
+
+    /** Number of bytes written to the stream log. */
+    qint64                  stream_log_len_;
+
+    /** The records in the stream log, in stream order. */
+    QVector<StreamLogRecord> stream_log_records_;
+
+    /** Set if the stream log couldn't be written; later records are dropped. */
+    QString                 stream_log_error_;
+
+    /** The pages of the shown records. */
+    QVector<StreamPage>     stream_pages_;
+
+    /** The page shown in the text display. */
+    int                     cur_page_;
 };
 
 #endif // FOLLOW_STREAM_DIALOG_H
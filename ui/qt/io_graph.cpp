@@ -30,6 +30,12 @@
 // 2^25 = 16777216
 const int max_io_items_ = 1 << 25;
 
+// When the capture duration is known we tap at an interval finer than the
+// one displayed, so that the user can switch to any coarser interval that
+// is a multiple of it without a retap. This is the number of items we're
+// willing to keep per graph to make that possible (about 22 MiB).
+const int max_tap_items_ = 1 << 18;
+
 IOGraph::IOGraph(QCustomPlot* parent, const char* type_unit_name) :
     Graph(parent),
     moving_avg_period_(0),
@@ -39,9 +45,12 @@ IOGraph::IOGraph(QCustomPlot* parent, const char* type_unit_name) :
     start_time_(NSTIME_INIT_ZERO),
     hf_index_(-1),
     interval_(0),
+    tap_interval_(0),
     asAOT_(false),
     type_unit_name_(type_unit_name),
-    cur_idx_(-1)
+    cur_idx_(-1),
+    merged_cur_idx_(-1),
+    merged_stale_(false)
 {
     GString* error_string;
     error_string = register_tap_listener("frame",
@@ -303,15 +312,16 @@ nstime_t IOGraph::startTime() const
 
 int IOGraph::packetFromTime(double ts) const
 {
+    const std::vector<io_graph_item_t>& items = displayItems();
     int idx = ts * SCALE_F / interval_;
-    if (idx >= 0 && idx <= cur_idx_) {
+    if (idx >= 0 && idx <= displayCurIdx()) {
         switch (val_units_) {
         case IOG_ITEM_UNIT_CALC_MAX:
-            return items_[idx].max_frame_in_invl;
+            return items[idx].max_frame_in_invl;
         case IOG_ITEM_UNIT_CALC_MIN:
-            return items_[idx].min_frame_in_invl;
+            return items[idx].min_frame_in_invl;
         default:
-            return items_[idx].last_frame_in_invl;
+            return items[idx].last_frame_in_invl;
         }
     }
     return -1;
@@ -323,6 +333,9 @@ void IOGraph::clearAllData()
     if (items_.size()) {
         reset_io_graph_items(&items_[0], items_.size(), hf_index_);
     }
+    merged_items_.clear();
+    merged_cur_idx_ = -1;
+    merged_stale_ = false;
     nstime_set_zero(&start_time_);
     Graph::clearAllData();
 }
@@ -341,7 +354,10 @@ void IOGraph::recalcGraphData(capture_file* cap_file)
         bars_->data()->clear();
     }
 
-    if (moving_avg_period_ > 0 && cur_idx_ >= 0) {
+    updateMergedItems();
+    const int cur_idx = displayCurIdx();
+
+    if (moving_avg_period_ > 0 && cur_idx >= 0) {
         /* "Warm-up phase" - calculate average on some data not displayed;
          * just to make sure average on leftmost and rightmost displayed
          * values is as reliable as possible
@@ -352,7 +368,7 @@ void IOGraph::recalcGraphData(capture_file* cap_file)
         mavg_in_average_count++;
         for (warmup_interval = 1;
             (warmup_interval < moving_avg_period_ / 2) &&
-            (warmup_interval <= (unsigned)cur_idx_);
+            (warmup_interval <= (unsigned)cur_idx);
             warmup_interval += 1) {
 
             mavg_cumulated += getItemValue((int)warmup_interval, cap_file);
@@ -362,7 +378,7 @@ void IOGraph::recalcGraphData(capture_file* cap_file)
     }
 
     double ts_offset = startOffset();
-    for (int i = 0; i <= cur_idx_; i++) {
+    for (int i = 0; i <= cur_idx; i++) {
         double ts = (double)i * interval_ / SCALE_F + ts_offset;
         double val = getItemValue(i, cap_file);
 
@@ -375,7 +391,7 @@ void IOGraph::recalcGraphData(capture_file* cap_file)
                     mavg_cumulated -= getItemValue(mavg_to_remove, cap_file);
                     mavg_to_remove += 1;
                 }
-                if (mavg_to_add <= (unsigned int)cur_idx_) {
+                if (mavg_to_add <= (unsigned int)cur_idx) {
                     mavg_in_average_count++;
                     mavg_cumulated += getItemValue(mavg_to_add, cap_file);
                     mavg_to_add += 1;
@@ -519,7 +535,7 @@ bool IOGraph::hasItemToShow(int idx, double value) const
 
     bool result = false;
 
-    const io_graph_item_t* item = &items_[idx];
+    const io_graph_item_t* item = &displayItems()[idx];
 
     switch (val_units_) {
     case IOG_ITEM_UNIT_PACKETS:
@@ -554,12 +570,122 @@ bool IOGraph::hasItemToShow(int idx, double value) const
     return result;
 }
 
-void IOGraph::setInterval(int interval)
+bool IOGraph::setInterval(int interval, const capture_file* cap_file)
 {
     interval_ = interval;
     if (bars_) {
         bars_->setWidth(interval_ / SCALE_F);
     }
+
+    if (tap_interval_ > 0 && interval_ % tap_interval_ == 0) {
+        // We can get there from the items we have.
+        merged_stale_ = true;
+        return false;
+    }
+
+    // Pick the finest 1-2-5 divisor of the interval that keeps the whole
+    // capture within max_tap_items_. Without a duration (e.g. a live
+    // capture that's just started) we tap at the interval itself.
+    // If the capture grows past what we picked, tapPacket coarsens it.
+    tap_interval_ = interval_;
+    double duration = cap_file ? nstime_to_sec(&cap_file->elapsed_time) * SCALE_F : 0;
+    if (duration > 0 && interval_ > 0) {
+        static const int steps[] = { 2, 5, 10 };
+        bool fits = true;
+        for (int64_t decade = 1; fits && decade * 2 <= interval_; decade *= 10) {
+            for (int step : steps) {
+                int64_t divisor = decade * step;
+                if (divisor > interval_ || interval_ % divisor != 0) {
+                    continue;
+                }
+                int candidate = (int)(interval_ / divisor);
+                if (duration / candidate >= max_tap_items_) {
+                    fits = false;
+                    break;
+                }
+                tap_interval_ = candidate;
+            }
+        }
+    }
+    merged_stale_ = true;
+    return true;
+}
+
+void IOGraph::coarsenTapInterval(int64_t idx)
+{
+    // Find the finest multiple of the tap interval, in 1-2-5 steps, that
+    // still divides the display interval and leaves room to grow.
+    int64_t elapsed = idx * tap_interval_;
+    int new_interval = interval_;
+    static const int steps[] = { 2, 5, 10 };
+    for (int64_t decade = 1; tap_interval_ * decade < interval_; decade *= 10) {
+        for (int step : steps) {
+            int64_t candidate = tap_interval_ * decade * step;
+            if (candidate >= new_interval || interval_ % candidate != 0) {
+                continue;
+            }
+            if (elapsed / candidate < max_tap_items_ / 2) {
+                new_interval = (int)candidate;
+                break;
+            }
+        }
+        if (new_interval < interval_) {
+            break;
+        }
+    }
+
+    unsigned factor = new_interval / tap_interval_;
+    std::vector<io_graph_item_t> coarse;
+    if (cur_idx_ >= 0) {
+        try {
+            coarse.assign(((size_t)cur_idx_ + factor) / factor, io_graph_item_t());
+        }
+        catch (std::bad_alloc&) {
+            ws_warning("Failed memory allocation.");
+            return;
+        }
+        reset_io_graph_items(&coarse[0], coarse.size(), hf_index_);
+        merge_io_graph_items(&items_[0], (size_t)cur_idx_ + 1, factor, &coarse[0], hf_index_);
+    }
+    items_.swap(coarse);
+    cur_idx_ = (int)items_.size() - 1;
+    tap_interval_ = new_interval;
+    merged_stale_ = true;
+}
+
+void IOGraph::updateMergedItems()
+{
+    if (!merged_stale_) {
+        return;
+    }
+    merged_stale_ = false;
+
+    if (interval_ == tap_interval_ || tap_interval_ <= 0) {
+        merged_items_.clear();
+        merged_cur_idx_ = -1;
+        return;
+    }
+
+    unsigned factor = interval_ / tap_interval_;
+    if (cur_idx_ < 0) {
+        merged_items_.clear();
+        merged_cur_idx_ = -1;
+        return;
+    }
+
+    size_t merged_count = ((size_t)cur_idx_ + factor) / factor;
+    try {
+        merged_items_.assign(merged_count, io_graph_item_t());
+    }
+    catch (std::bad_alloc&) {
+        ws_warning("Failed memory allocation.");
+        merged_items_.clear();
+        merged_cur_idx_ = -1;
+        return;
+    }
+    reset_io_graph_items(&merged_items_[0], merged_items_.size(), hf_index_);
+    merge_io_graph_items(&items_[0], (size_t)cur_idx_ + 1, factor, &merged_items_[0], hf_index_);
+    merged_cur_idx_ = (int)merged_count - 1;
 }
 
 // Get the value at the given interval (idx) for the current value unit.
@@ -567,7 +693,7 @@ double IOGraph::getItemValue(int idx, const capture_file* cap_file) const
 {
     ws_assert(idx < max_io_items_);
 
-    return get_io_graph_item(&items_[0], val_units_, idx, hf_index_, cap_file, interval_, cur_idx_, asAOT_);
+    return get_io_graph_item(&displayItems()[0], val_units_, idx, hf_index_, cap_file, interval_, displayCurIdx(), asAOT_);
 }
 
 // "tap_reset" callback for register_tap_listener
@@ -588,9 +714,16 @@ tap_packet_status IOGraph::tapPacket(void* iog_ptr, packet_info* pinfo, epan_dis
         return TAP_PACKET_DONT_REDRAW;
     }
 
-    int64_t tmp_idx = get_io_graph_index(pinfo, iog->interval_);
+    int64_t tmp_idx = get_io_graph_index(pinfo, iog->tap_interval_);
     bool recalc = false;
 
+    /* The capture has grown past the tap interval we picked; fall back
+     * toward the display interval rather than dropping packets. */
+    if (tmp_idx >= max_tap_items_ && iog->tap_interval_ < iog->interval_) {
+        iog->coarsenTapInterval(tmp_idx);
+        tmp_idx = get_io_graph_index(pinfo, iog->tap_interval_);
+    }
+
     /* some sanity checks */
     if ((tmp_idx < 0) || (tmp_idx >= max_io_items_)) {
         iog->cur_idx_ = (int)iog->items_.size() - 1;
@@ -652,9 +785,10 @@ tap_packet_status IOGraph::tapPacket(void* iog_ptr, packet_info* pinfo, epan_dis
         adv_edt = edt;
     }
 
-    if (!update_io_graph_item(&iog->items_[0], idx, pinfo, adv_edt, iog->hf_index_, iog->val_units_, iog->interval_)) {
+    if (!update_io_graph_item(&iog->items_[0], idx, pinfo, adv_edt, iog->hf_index_, iog->val_units_, iog->tap_interval_)) {
         return TAP_PACKET_DONT_REDRAW;
     }
+    iog->merged_stale_ = true;
 
     //    qDebug() << "=tapPacket" << iog->name_ << idx << iog->hf_index_ << iog->val_units_ << iog->num_items_;
 
@@ -183,9 +183,15 @@ public:
 
     /**
      * @brief Sets the time interval for data bucketing.
-     * @param interval The interval in milliseconds.
+     *
+     * Packets are tapped at an interval that may be finer than the one
+     * displayed, so that switching to a coarser interval can be done by
+     * merging the items we already have instead of retapping.
+     * @param interval The interval in microseconds.
+     * @param cap_file The capture file context, used to size the tap interval.
+     * @return True if the graph must be retapped to show the new interval.
      */
-    void setInterval(int interval);
+    bool setInterval(int interval, const capture_file* cap_file = nullptr);
 
     /**
      * @brief Determines the packet number closest to a specific timestamp.
@@ -214,7 +220,7 @@ public:
      * @brief Retrieves the maximum populated interval index.
      * @return The maximum interval index.
      */
-    int maxInterval() const { return cur_idx_; }
+    int maxInterval() const { return displayCurIdx(); }
 
     /**
      * @brief Clears all cached plotting and tap data.
@@ -314,6 +320,35 @@ private:
      */
     template<class DataMap> void scaleGraphData(DataMap& map, int scalar);
 
+    /**
+     * @brief Rebuilds merged_items_ from items_ if the display interval
+     * differs from the tap interval.
+     */
+    void updateMergedItems();
+
+    /**
+     * @brief Merges items_ to a coarser tap interval when the capture has
+     * outgrown the one picked by setInterval(), e.g. during a live capture.
+     * @param idx The index at the current tap interval that doesn't fit.
+     */
+    void coarsenTapInterval(int64_t idx);
+
+    /**
+     * @brief Returns the items at the display interval.
+     * @return Either the tapped items or the merged items.
+     */
+    const std::vector<io_graph_item_t>& displayItems() const {
+        return interval_ == tap_interval_ ? items_ : merged_items_;
+    }
+
+    /**
+     * @brief Returns the highest populated index at the display interval.
+     * @return The maximum display interval index.
+     */
+    int displayCurIdx() const {
+        return interval_ == tap_interval_ ? cur_idx_ : merged_cur_idx_;
+    }
+
     /** Configuration error string. */
     QString config_err_;
 
@@ -344,6 +379,9 @@ private:
     /** The data bucketing interval. */
     int interval_;
 
+    /** The interval packets are tapped at. interval_ is always a multiple of it. */
+    int tap_interval_;
+
     /** Flag indicating if values are interpreted as an average over time. */
     bool asAOT_; // Average Over Time interpretation
 
@@ -358,6 +396,15 @@ private:
 
     /** The highest interval index currently populated with data. */
     int cur_idx_;
+
+    /** items_ merged to interval_ when it is coarser than tap_interval_. */
+    std::vector<io_graph_item_t> merged_items_;
+
+    /** The highest index populated in merged_items_. */
+    int merged_cur_idx_;
+
+    /** Flag indicating that items_ changed since merged_items_ was built. */
+    bool merged_stale_;
 };
 
 #endif // IO_GRAPH_H
@@ -659,7 +659,7 @@ void IOGraphDialog::syncGraphSettings(int row)
 
     iog->setYAxisFactor(uat_model_->data(uat_model_->index(row, colYAxisFactor)).toDouble());
 
-    iog->setInterval(ui->intervalComboBox->itemData(ui->intervalComboBox->currentIndex()).toInt());
+    iog->setInterval(ui->intervalComboBox->itemData(ui->intervalComboBox->currentIndex()).toInt(), cap_file_.capFile());
 
     if (!iog->configError().isEmpty()) {
         hint_err_ = iog->configError();
@@ -1532,6 +1532,7 @@ void IOGraphDialog::on_intervalComboBox_currentIndexChanged(int)
 {
     int interval = ui->intervalComboBox->itemData(ui->intervalComboBox->currentIndex()).toInt();
     bool need_retap = false;
+    bool need_recalc = false;
 
     precision_ = ceil(log10(SCALE_F / interval));
     if (precision_ < 0) {
@@ -1553,8 +1554,11 @@ void IOGraphDialog::on_intervalComboBox_currentIndexChanged(int)
         for (int row = 0; row < uat_model_->rowCount(); row++) {
             IOGraph *iog = ioGraphs_.value(row, NULL);
             if (iog) {
-                iog->setInterval(interval);
-                if (iog->visible()) {
+                // Coarser multiples of the tapped interval are merged from
+                // the items we already have.
+                if (!iog->setInterval(interval, cap_file_.capFile())) {
+                    need_recalc = true;
+                } else if (iog->visible()) {
                     need_retap = true;
                 } else {
                     iog->setNeedRetap(true);
@@ -1565,6 +1569,8 @@ void IOGraphDialog::on_intervalComboBox_currentIndexChanged(int)
 
     if (need_retap) {
         scheduleRetap(true);
+    } else if (need_recalc) {
+        scheduleRecalc(true);
     }
 }
 
@@ -28,6 +28,8 @@
 #include <QWidget>
 #include <QDateTime>
 
+#include <algorithm>
+
 static QString formatString(qlonglong value, bool machineReadable)
 {
     return machineReadable ?
@@ -41,8 +43,12 @@ ATapDataModel::ATapDataModel(dataModelType type, int protoId, QString filter, QO
     hash_.conv_array = nullptr;
     hash_.hashtable = nullptr;
     hash_.user_data = this;
+    hash_.flags = 0;
+    hash_.modified_rows = nullptr;
+    conversation_table_track_modified(&hash_, true);
 
     storage_ = nullptr;
+    _rowCount = 0;
     _resolveNames = false;
     _absoluteTime = false;
     _nanoseconds = false;
@@ -72,6 +78,7 @@ ATapDataModel::~ATapDataModel()
         reset_endpoint_table_data(&hash_);
     else if (_type == ATapDataModel::DATAMODEL_CONVERSATION)
         reset_conversation_table_data(&hash_);
+    conversation_table_track_modified(&hash_, false);
 }
 
 int ATapDataModel::protoId() const
@@ -181,7 +188,7 @@ void ATapDataModel::limitToDisplayFilter(bool limit)
 
 int ATapDataModel::rowCount(const QModelIndex &parent) const
 {
-    return (storage_ && !parent.isValid()) ? (int) storage_->len : 0;
+    return (storage_ && !parent.isValid()) ? _rowCount : 0;
 }
 
 void ATapDataModel::tapReset(void *tapdata) {
@@ -238,6 +245,7 @@ void ATapDataModel::resetData()
 
     beginResetModel();
     storage_ = nullptr;
+    _rowCount = 0;
     if (_type == ATapDataModel::DATAMODEL_ENDPOINT)
         reset_endpoint_table_data(&hash_);
     else if (_type == ATapDataModel::DATAMODEL_CONVERSATION)
@@ -254,12 +262,82 @@ void ATapDataModel::updateData(GArray * newData)
     if (_disableTap)
         return;
 
-    emit layoutAboutToBeChanged();
-    storage_ = newData;
-    emit layoutChanged();
+    GArray *modified = nullptr;
+    if (_type == ATapDataModel::DATAMODEL_ENDPOINT)
+        modified = endpoint_table_take_modified(&hash_);
+    else if (_type == ATapDataModel::DATAMODEL_CONVERSATION)
+        modified = conversation_table_take_modified(&hash_);
+
+    if (!newData && !storage_) {
+        /* Still nothing to show. */
+    } else if (!newData || newData != storage_ || !modified) {
+        /* A new table (e.g. after a reset); start over. */
+        beginResetModel();
+        storage_ = newData;
+        _rowCount = newData ? (int) newData->len : 0;
+        endResetModel();
+
+        if (_type == ATapDataModel::DATAMODEL_CONVERSATION)
+            ((ConversationDataModel *)(this))->doDataUpdate();
+    } else {
+        /*
+         * Entries are only ever appended to the table, so we can tell the
+         * views about new rows and changed rows instead of resetting the
+         * layout. That lets a sorting proxy place just those rows instead
+         * of re-sorting the whole table on every tap draw.
+         */
+        int oldRowCount = _rowCount;
+        QList<int> changedRows;
+        changedRows.reserve(modified->len);
+        for (unsigned i = 0; i < modified->len; i++) {
+            int row = (int) g_array_index(modified, unsigned, i);
+            changedRows << row;
+        }
+        std::sort(changedRows.begin(), changedRows.end());
+
+        if ((int) newData->len > oldRowCount) {
+            beginInsertRows(QModelIndex(), oldRowCount, (int) newData->len - 1);
+            _rowCount = (int) newData->len;
+            endInsertRows();
+        }
+
+        if (_type == ATapDataModel::DATAMODEL_CONVERSATION)
+            ((ConversationDataModel *)(this))->doDataUpdate(&changedRows);
+
+        auto firstNew = std::lower_bound(changedRows.begin(), changedRows.end(), oldRowCount);
+        changedRows.erase(firstNew, changedRows.end());
+        emitRowsChanged(changedRows);
+    }
+
+    if (modified)
+        g_array_free(modified, true);
+}
+
+void ATapDataModel::emitRowsChanged(const QList<int> &rows)
+{
+    if (rows.isEmpty())
+        return;
+
+    int lastColumn = columnCount() - 1;
+    QList<QPair<int, int>> runs;
+
+    for (int row : rows) {
+        if (!runs.isEmpty() && runs.last().second + 1 == row) {
+            runs.last().second = row;
+        } else {
+            runs << qMakePair(row, row);
+        }
+    }
+
+    /* Lots of scattered rows; a single signal is cheaper than many. */
+    if (runs.size() > 64) {
+        emit dataChanged(index(rows.constFirst(), 0), index(rows.constLast(), lastColumn));
+        return;
+    }
 
-    if (_type == ATapDataModel::DATAMODEL_CONVERSATION)
-        ((ConversationDataModel *)(this))->doDataUpdate();
+    for (const QPair<int, int> &run : runs) {
+        emit dataChanged(index(run.first, 0), index(run.second, lastColumn));
+    }
 }
 
 bool ATapDataModel::resolveNames() const
@@ -625,18 +703,38 @@ ConversationDataModel::ConversationDataModel(int protoId, QString filter, QObjec
     ATapDataModel(ATapDataModel::DATAMODEL_CONVERSATION, protoId, filter, parent)
 {}
 
-void ConversationDataModel::doDataUpdate()
+void ConversationDataModel::doDataUpdate(const QList<int> *rows)
 {
-    _minRelStartTime = 0;
-    _maxRelStopTime = 0;
+    double oldMin = _minRelStartTime;
+    double oldMax = _maxRelStopTime;
 
-    for (int row = 0; row < rowCount(); row ++) {
-        conv_item_t *conv_item = &g_array_index(storage_, conv_item_t, row);
+    if (!rows || (oldMin == 0 && oldMax == 0)) {
+        _minRelStartTime = 0;
+        _maxRelStopTime = 0;
+
+        for (int row = 0; row < rowCount(); row ++) {
+            conv_item_t *conv_item = &g_array_index(storage_, conv_item_t, row);
+
+            if (row == 0) {
+                _minRelStartTime = nstime_to_sec(&(conv_item->start_time));
+                _maxRelStopTime = nstime_to_sec(&(conv_item->stop_time));
+            } else {
+                double item_rel_start = nstime_to_sec(&(conv_item->start_time));
+                if (item_rel_start < _minRelStartTime) {
+                    _minRelStartTime = item_rel_start;
+                }
+
+                double item_rel_stop = nstime_to_sec(&(conv_item->stop_time));
+                if (item_rel_stop > _maxRelStopTime) {
+                    _maxRelStopTime = item_rel_stop;
+                }
+            }
+        }
+    } else {
+        /* Start and stop times only ever widen, so the changed rows are enough. */
+        for (int row : *rows) {
+            conv_item_t *conv_item = &g_array_index(storage_, conv_item_t, row);
 
-        if (row == 0) {
-            _minRelStartTime = nstime_to_sec(&(conv_item->start_time));
-            _maxRelStopTime = nstime_to_sec(&(conv_item->stop_time));
-        } else {
             double item_rel_start = nstime_to_sec(&(conv_item->start_time));
             if (item_rel_start < _minRelStartTime) {
                 _minRelStartTime = item_rel_start;
@@ -648,6 +746,12 @@ void ConversationDataModel::doDataUpdate()
             }
         }
     }
+
+    /* Every timeline bar is drawn relative to the overall span. */
+    if (rows && rowCount() > 0 && (oldMin != _minRelStartTime || oldMax != _maxRelStopTime)) {
+        emit dataChanged(index(0, CONV_COLUMN_START), index(rowCount() - 1, CONV_COLUMN_DURATION),
+                         QList<int>() << ATapDataModel::TIMELINE_DATA);
+    }
 }
 
 int ConversationDataModel::columnCount(const QModelIndex &) const
@@ -962,7 +1066,7 @@ conv_item_t * ConversationDataModel::itemForRow(int row)
 
 bool ConversationDataModel::showConversationId(int row) const
 {
-    if (!storage_ || row < 0 || row >= (int) storage_->len)
+    if (!storage_ || row < 0 || row >= _rowCount)
         return false;
 
     conv_item_t *conv_item = (conv_item_t *)&g_array_index(storage_, conv_item_t, row);
@@ -17,6 +17,7 @@
 #include <epan/conversation_table.h>
 
 #include <QAbstractListModel>
+#include <QList>
 
 /**
  * @brief DataModel for tap user data
@@ -302,12 +303,22 @@ protected:
 
     /**
      * @brief Updates the model with new data.
+     *
+     * If @p data is the array we already show, only the rows that were
+     * added or modified since the last update are announced to the views.
      * @param data Pointer to a GArray containing the new data.
      */
     void updateData(GArray * data);
 
+    /**
+     * @brief Announces the given modified rows to the views.
+     * @param rows Sorted indexes of modified rows below _rowCount.
+     */
+    void emitRowsChanged(const QList<int> &rows);
+
     dataModelType _type; /**< The specific type of the data model. */
     GArray * storage_; /**< Internal storage for the tap data records. */
+    int _rowCount; /**< The number of rows of storage_ the views know about. */
     QString _filter; /**< The display filter applied to the tap. */
 
     bool _absoluteTime; /**< Flag indicating whether to use absolute time formats. */
@@ -516,8 +527,9 @@ public:
      * Called after the tap has finished processing a batch of packets to
      * update computed columns such as @c CONV_COLUMN_BPS_AB and
      * @c CONV_COLUMN_DURATION.
+     * @param rows The rows that changed, or nullptr to look at all rows.
      */
-    void doDataUpdate();
+    void doDataUpdate(const QList<int> *rows = nullptr);
 
     /**
      * @brief Return the raw @c conv_item_t for a given table row.
@@ -10,6 +10,7 @@
 #include <algorithm>
 #include <cmath>
 #include <stdexcept>
+#include <vector>
 
 #include "packet_list_model.h"
 
@@ -40,6 +41,8 @@
 #include <QModelIndex>
 #include <QElapsedTimer>
 #include <QPalette>
+#include <QThread>
+#include <QtConcurrent>
 
 // Print timing information
 //#define DEBUG_PACKET_LIST_MODEL 1
@@ -550,29 +553,8 @@ void PacketListModel::sort(int column, Qt::SortOrder order)
      * has no way of knowing that sorting failed, so in these cases
      * the sort indicator have the value that the user requested
      * regardless.
-     */
-    if (PacketListRecord::textColumn(column) >= 0 && (unsigned)visible_rows_.count() > prefs.gui_packet_list_cached_rows_max) {
-        /* Column not based on frame data but by column text that requires
-         * dissection, so to sort in a reasonable amount of time the column
-         * text needs to be cached.
-         */
-        /* If the sort is being triggered because the columns were already
-         * sorted and the filter is being cleared (or changed to something
-         * else with more rows than fit in the cache), then the temporary
-         * message will be immediately overwritten with the standard capture
-         * statistics by the packets_bar_update() call after thawing the rows.
-         * It will still blink yellow, and the user will get the message if
-         * they then click on the header file (wondering why it didn't sort.)
-         */
-        if (col_title.isEmpty()) {
-            col_title = tr("Column");
-        }
-        QString temp_msg = tr("%1 can only be sorted with %2 or fewer visible rows; increase cache size in Layout preferences").arg(col_title).arg(prefs.gui_packet_list_cached_rows_max);
-        mainApp->pushStatus(MainApplication::TemporaryStatus, temp_msg);
-        return;
-    }
-
-    /* If we are currently in the middle of reading the capture file, don't
+     *
+     * If we are currently in the middle of reading the capture file, don't
      * sort. PacketList::captureFileReadFinished invalidates all the cached
      * column strings and then tries to sort again.
      * Similarly, claim the read lock because we don't want the file to
@@ -611,11 +593,15 @@ void PacketListModel::sort(int column, Qt::SortOrder order)
     comps_ = 0;
     /* XXX: The expected number of comparisons is O(N log N), but this could
      * be a pretty significant overestimate of the amount of time it takes,
-     * if there are lots of identical entries. (Especially with string
-     * comparisons, some comparisons are faster than others.) Better to
-     * overestimate?
+     * if there are lots of identical entries. Better to overestimate?
+     * Columns that need dissection report progress per extracted row
+     * instead; the sort of the extracted keys is quick in comparison.
      */
-    exp_comps_ = log2(visible_rows_.count()) * visible_rows_.count();
+    if (text_sort_column_ < 0) {
+        exp_comps_ = log2(visible_rows_.count()) * visible_rows_.count();
+    } else {
+        exp_comps_ = visible_rows_.count();
+    }
     progress_frame_ = nullptr;
     if (MainWindow *mw = mainApp->mainWindow()) {
         progress_frame_ = mw->findChild<ProgressFrame *>();
@@ -636,7 +622,15 @@ void PacketListModel::sort(int column, Qt::SortOrder order)
                 sorted_visible_rows_[it.value()]->frameData()->aggregation_key = g_strdup(it.key().toUtf8());
             }
         }
-        std::sort(sorted_visible_rows_.begin(), sorted_visible_rows_.end(), recordLessThan);
+        if (text_sort_column_ < 0) {
+            std::sort(sorted_visible_rows_.begin(), sorted_visible_rows_.end(), recordLessThan);
+        } else {
+            QVector<SortKey> keys = extractSortKeys(sorted_visible_rows_);
+            parallelSortKeys(keys);
+            for (qsizetype i = 0; i < keys.count(); i++) {
+                sorted_visible_rows_[i] = keys[i].record;
+            }
+        }
 
         beginResetModel();
         visible_rows_.resize(0);
@@ -808,41 +802,75 @@ bool PacketListModel::recordLessThan(PacketListRecord *r1, PacketListRecord *r2)
     if (sort_column_ < 0) {
         // No column.
         cmp_val = frame_data_compare(sort_cap_file_->epan, r1->frameData(), r2->frameData(), COL_NUMBER);
-    } else if (text_sort_column_ < 0) {
+    } else {
         // Column comes directly from frame data
         cmp_val = frame_data_compare(sort_cap_file_->epan, r1->frameData(), r2->frameData(), sort_cap_file_->cinfo.columns[sort_column_].col_fmt);
-    } else  {
-        QString r1String = r1->columnString(sort_cap_file_, sort_column_);
-        QString r2String = r2->columnString(sort_cap_file_, sort_column_);
-        // XXX: The naive string comparison compares Unicode code points.
-        // Proper collation is more expensive
-        cmp_val = r1String.compare(r2String);
-        if (cmp_val != 0 && sort_column_is_numeric_) {
-            // Custom column with numeric data (or something like a port number).
-            // Attempt to convert to numbers.
-            // XXX This is slow. Can we avoid doing this? Perhaps the actual
-            // values used for sorting should be cached too as QVariant[List].
-            // If so, we could consider using QCollatorSortKeys or similar
-            // for strings as well.
-            bool ok_r1, ok_r2;
-            double num_r1 = parseNumericColumn(r1String, &ok_r1);
-            double num_r2 = parseNumericColumn(r2String, &ok_r2);
-
-            if (!ok_r1 && !ok_r2) {
-                cmp_val = 0;
-            } else if (!ok_r1 || (ok_r2 && num_r1 < num_r2)) {
-                // either r1 is invalid (and sort it before others) or both
-                // r1 and r2 are valid (sort normally)
-                cmp_val = -1;
-            } else if (!ok_r2 || (num_r1 > num_r2)) {
-                cmp_val = 1;
+    }
+
+    if (sort_order_ == Qt::AscendingOrder) {
+        return cmp_val < 0;
+    } else {
+        return cmp_val > 0;
+    }
+}
+
+QVector<PacketListModel::SortKey> PacketListModel::extractSortKeys(const QVector<PacketListRecord *> &rows)
+{
+    QVector<SortKey> keys;
+    keys.reserve(rows.count());
+
+    // Dissection isn't thread safe, so this part has to run here. Reading
+    // each column string immediately after it's produced means we never
+    // depend on it staying in col_text_cache_, however small that is.
+    for (PacketListRecord *record : rows) {
+        if (busy_timer_.elapsed() > busy_timeout_) {
+            if (progress_frame_) {
+                progress_frame_->setValue(static_cast<int>(keys.count() / exp_comps_ * 100));
+            }
+            mainApp->processEvents(QEventLoop::ExcludeSocketNotifiers, 1);
+            if (stop_flag_) {
+                throw SortAbort("Sorting aborted");
             }
+            busy_timer_.restart();
         }
 
-        if (cmp_val == 0) {
-            // All else being equal, compare column numbers.
-            cmp_val = frame_data_compare(sort_cap_file_->epan, r1->frameData(), r2->frameData(), COL_NUMBER);
+        SortKey key;
+        key.text = record->columnString(sort_cap_file_, sort_column_);
+        key.num = 0;
+        key.num_ok = false;
+        if (sort_column_is_numeric_) {
+            // Custom column with numeric data (or something like a port
+            // number). Parse it once here instead of in every comparison.
+            key.num = parseNumericColumn(key.text, &key.num_ok);
         }
+        key.frame_num = record->frameData()->num;
+        key.record = record;
+        keys << key;
+    }
+
+    return keys;
+}
+
+bool PacketListModel::sortKeyLessThan(const SortKey &k1, const SortKey &k2)
+{
+    // XXX: The naive string comparison compares Unicode code points.
+    // Proper collation is more expensive
+    int cmp_val = k1.text.compare(k2.text);
+    if (cmp_val != 0 && sort_column_is_numeric_) {
+        if (!k1.num_ok && !k2.num_ok) {
+            cmp_val = 0;
+        } else if (!k1.num_ok || (k2.num_ok && k1.num < k2.num)) {
+            // either k1 is invalid (and sort it before others) or both
+            // k1 and k2 are valid (sort normally)
+            cmp_val = -1;
+        } else if (!k2.num_ok || (k1.num > k2.num)) {
+            cmp_val = 1;
+        }
+    }
+
+    if (cmp_val == 0) {
+        // All else being equal, compare frame numbers.
+        cmp_val = k1.frame_num < k2.frame_num ? -1 : (k1.frame_num > k2.frame_num ? 1 : 0);
     }
 
     if (sort_order_ == Qt::AscendingOrder) {
@@ -852,6 +880,47 @@ bool PacketListModel::recordLessThan(PacketListRecord *r1, PacketListRecord *r2)
     }
 }
 
+void PacketListModel::parallelSortKeys(QVector<SortKey> &keys)
+{
+    // Below this, splitting the work costs more than it saves.
+    const qsizetype min_chunk_size = 16384;
+    int chunks = static_cast<int>(qMin<qsizetype>(QThread::idealThreadCount(), keys.count() / min_chunk_size));
+
+    if (chunks <= 1) {
+        std::sort(keys.begin(), keys.end(), sortKeyLessThan);
+        return;
+    }
+
+    // The comparison only reads the keys and a few settings that don't
+    // change while we're sorting, so the chunks can be sorted concurrently.
+    std::vector<qsizetype> bounds;
+    std::vector<int> starts;
+    for (int i = 0; i <= chunks; i++) {
+        bounds.push_back(keys.count() * i / chunks);
+    }
+    for (int i = 0; i < chunks; i++) {
+        starts.push_back(i);
+    }
+    SortKey *base = keys.data();
+    QtConcurrent::blockingMap(starts, [base, &bounds](const int &chunk) {
+        std::sort(base + bounds[chunk], base + bounds[chunk + 1], sortKeyLessThan);
+    });
+
+    // Merge neighbouring runs, doubling the run length each round.
+    for (int width = 1; width < chunks; width *= 2) {
+        starts.clear();
+        for (int i = 0; i + width < chunks; i += 2 * width) {
+            starts.push_back(i);
+        }
+        QtConcurrent::blockingMap(starts, [base, &bounds, width, chunks](const int &chunk) {
+            std::inplace_merge(base + bounds[chunk],
+                               base + bounds[chunk + width],
+                               base + bounds[qMin(chunk + 2 * width, chunks)],
+                               sortKeyLessThan);
+        });
+    }
+}
+
 // Parses a field as a double. Handle values with suffixes ("12ms"), negative
 // values ("-1.23") and fields with multiple occurrences ("1,2"). Marks values
 // that do not contain any numeric value ("Unknown") as invalid.
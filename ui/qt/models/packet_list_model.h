@@ -359,13 +359,51 @@ private:
     static capture_file *sort_cap_file_;
 
     /**
-     * @brief Compare function used to sort records.
+     * @brief Compare function used to sort records by a column based on frame data.
      * @param r1 The first record.
      * @param r2 The second record.
      * @return True if r1 should appear before r2, false otherwise.
      */
     static bool recordLessThan(PacketListRecord *r1, PacketListRecord *r2);
 
+    /**
+     * @brief Precomputed sort key for a column that requires dissection.
+     *
+     * Extracting the keys up front means each row is dissected at most once
+     * per sort, instead of once per comparison whenever its column text has
+     * been evicted from the record cache.
+     */
+    struct SortKey {
+        QString text;               /**< The column text. */
+        double num;                 /**< The column text parsed as a number, if sort_column_is_numeric_. */
+        bool num_ok;                /**< True if num is valid. */
+        uint32_t frame_num;         /**< Tie breaker. */
+        PacketListRecord *record;   /**< The record this key belongs to. */
+    };
+
+    /**
+     * @brief Compare function used to sort precomputed text column keys.
+     * @param k1 The first key.
+     * @param k2 The second key.
+     * @return True if k1 should appear before k2, false otherwise.
+     */
+    static bool sortKeyLessThan(const SortKey &k1, const SortKey &k2);
+
+    /**
+     * @brief Builds the sort keys for the given rows, dissecting as needed.
+     *
+     * Throws SortAbort if the user stops the sort.
+     * @param rows The rows to extract keys for.
+     * @return One key per row, in the same order.
+     */
+    static QVector<SortKey> extractSortKeys(const QVector<PacketListRecord *> &rows);
+
+    /**
+     * @brief Sorts keys by sorting chunks on worker threads and merging them.
+     * @param keys The keys to sort in place.
+     */
+    static void parallelSortKeys(QVector<SortKey> &keys);
+
     /**
      * @brief Parses a string value from a column as a numeric double.
      * @param val The string value to parse.
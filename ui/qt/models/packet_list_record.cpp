@@ -23,6 +23,8 @@
 #include <QStringList>
 
 QCache<uint32_t, QStringList> PacketListRecord::col_text_cache_(500);
+QHash<QByteArray, QString> PacketListRecord::col_text_interned_;
+QQueue<QByteArray> PacketListRecord::col_text_interned_order_;
 bool PacketListRecord::dissection_paused_ = false;
 QMap<int, int> PacketListRecord::cinfo_column_;
 unsigned PacketListRecord::rows_color_ver_ = 1;
@@ -262,7 +264,7 @@ void PacketListRecord::cacheColumnStrings(column_info *cinfo)
             col_fill_in_frame_data(fdata_, cinfo, column, false);
         }
 
-        col_str = QString(get_column_text(cinfo, column));
+        col_str = internColumnString(get_column_text(cinfo, column));
         *col_text << col_str;
         col_lines = static_cast<int>(col_str.count('\n'));
         if (col_lines > lines_) {
@@ -273,3 +275,46 @@ void PacketListRecord::cacheColumnStrings(column_info *cinfo)
 
     col_text_cache_.insert(fdata_->num, col_text);
 }
+
+// Bounds for the interned column string table. Long strings (typically
+// unique Info column text) aren't worth hashing and would just push the
+// repeated ones out.
+#define COL_TEXT_INTERN_MAX_ENTRIES 16384
+#define COL_TEXT_INTERN_MAX_LEN 256
+
+const QString PacketListRecord::internColumnString(const char *str)
+{
+    if (!str) {
+        return QString();
+    }
+
+    size_t len = strlen(str);
+    if (len == 0 || len > COL_TEXT_INTERN_MAX_LEN) {
+        return QString(str);
+    }
+
+    // Look up without copying the column text.
+    const QByteArray key = QByteArray::fromRawData(str, static_cast<int>(len));
+    QHash<QByteArray, QString>::const_iterator it = col_text_interned_.constFind(key);
+    if (it != col_text_interned_.constEnd()) {
+        return it.value();
+    }
+
+    if (col_text_interned_order_.size() >= COL_TEXT_INTERN_MAX_ENTRIES) {
+        col_text_interned_.remove(col_text_interned_order_.dequeue());
+    }
+
+    // Store a deep copy of the key; the column buffer is reused for the next packet.
+    const QByteArray owned_key(str, static_cast<int>(len));
+    const QString col_str = QString::fromUtf8(owned_key);
+    col_text_interned_.insert(owned_key, col_str);
+    col_text_interned_order_.enqueue(owned_key);
+
+    return col_str;
+}
+
+void PacketListRecord::clearInternedStrings()
+{
+    col_text_interned_.clear();
+    col_text_interned_order_.clear();
+}
@@ -19,7 +19,9 @@
 
 #include <QByteArray>
 #include <QCache>
+#include <QHash>
 #include <QList>
+#include <QQueue>
 #include <QVariant>
 
 struct conversation;
@@ -120,7 +122,7 @@ public:
     /**
      * @brief Clears the column text cache for all records.
      */
-    static void invalidateAllRecords() { col_text_cache_.clear(); }
+    static void invalidateAllRecords() { col_text_cache_.clear(); clearInternedStrings(); }
 
     /**
      * @brief Sets the maximum capacity of the column text cache.
@@ -181,6 +183,8 @@ public:
 
 private:
     static QCache<uint32_t, QStringList> col_text_cache_; /**< The column text for some columns */
+    static QHash<QByteArray, QString> col_text_interned_; /**< Column strings shared between records */
+    static QQueue<QByteArray> col_text_interned_order_; /**< Insertion order of col_text_interned_, oldest first */
     static bool dissection_paused_; /**< Flag indicating if dissection is globally paused. */
 
     frame_data *fdata_; /**< Pointer to the underlying frame data. */
@@ -214,6 +218,25 @@ private:
      * @param cinfo Pointer to the column information structure.
      */
     void cacheColumnStrings(column_info *cinfo);
+
+    /**
+     * @brief Returns a QString for the given column text, sharing its data
+     * with previously seen identical strings where possible.
+     *
+     * Protocol names, addresses, ports and many Info strings repeat across
+     * a large number of packets, so rather than each cached record owning
+     * its own copy, identical strings are looked up in a bounded table and
+     * the implicitly shared QString is reused. The oldest entries are
+     * evicted first (FIFO, like fifo_string_cache_t).
+     * @param str The column text.
+     * @return The (possibly shared) QString.
+     */
+    static const QString internColumnString(const char *str);
+
+    /**
+     * @brief Empties the interned column string table.
+     */
+    static void clearInternedStrings();
 };
 
 #endif // PACKET_LIST_RECORD_H
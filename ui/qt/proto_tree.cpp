@@ -639,9 +639,11 @@ void ProtoTree::foreachExpand(const QModelIndex &index = QModelIndex()) {
             ProtoNode *node = proto_tree_model_->protoNodeFromIndex(childIndex);
             if (node && node->isValid() && tree_expanded(node->protoNode()->finfo->tree_type)) {
                 expand(childIndex);
+                // We recurse here, but we're limited by tree depth checks in epan.
+                // Collapsed branches are restored by syncExpanded when they're
+                // opened, so that we don't create model nodes for them now.
+                foreachExpand(childIndex);
             }
-            // We recurse here, but we're limited by tree depth checks in epan
-            foreachExpand(childIndex);
         }
     }
 }
@@ -724,6 +726,11 @@ void ProtoTree::syncExpanded(const QModelIndex &index) {
     if (finfo.treeType() != -1) {
         tree_expanded_set(finfo.treeType(), true);
     }
+
+    // Restore the expanded state of the branches below this one.
+    disconnect(this, &ProtoTree::expanded, this, &ProtoTree::syncExpanded);
+    foreachExpand(index);
+    connect(this, &ProtoTree::expanded, this, &ProtoTree::syncExpanded);
 }
 
 void ProtoTree::syncCollapsed(const QModelIndex &index) {
@@ -55,6 +55,7 @@ RtpAudioStream::RtpAudioStream(QObject *parent, rtpstream_id_t *id, bool stereo_
     , audio_out_rate_(0)
     , audio_requested_out_rate_(0)
     , visual_sample_rate_(default_visual_sample_rate_)
+    , visual_samples_rate_(0)
     , max_sample_val_(1)
     , max_sample_val_used_(1)
     , color_(QColor())
@@ -157,6 +158,7 @@ void RtpAudioStream::clearPackets()
     memset(&rtpstream_, 0, sizeof(rtpstream_));
     rtpstream_id_copy(&id_, &rtpstream_.id);
     first_packet_ = true;
+    visual_samples_rate_ = 0;
 }
 
 void RtpAudioStream::reset(double global_start_time)
@@ -167,6 +169,7 @@ void RtpAudioStream::reset(double global_start_time)
     max_sample_val_ = 1;
     packet_timestamps_.clear();
     visual_samples_.clear();
+    visual_samples_rate_ = 0;
     out_of_seq_timestamps_.clear();
     jitter_drop_timestamps_.clear();
 }
@@ -181,11 +184,36 @@ void RtpAudioStream::setAudioRouting(AudioRouting audio_routing)
     audio_routing_ = audio_routing;
 }
 
+void RtpAudioStream::prepareDecode()
+{
+    for (int cur_packet = 0; cur_packet < rtp_packets_.size(); cur_packet++) {
+        rtp_packet_t *rtp_packet = rtp_packets_[cur_packet];
+
+        QString payload_name;
+        if (rtp_packet->info->info_payload_type_str) {
+            payload_name = rtp_packet->info->info_payload_type_str;
+        } else {
+            payload_name = try_val_to_str_ext(rtp_packet->info->info_payload_type, get_external_value_string_ext("rtp_payload_type_short_vals_ext"));
+        }
+        if (!payload_name.isEmpty()) {
+            payload_names_ << payload_name;
+        }
+
+        decode_rtp_prepare_decoder(rtp_packet, decoders_hash_);
+    }
+}
+
+bool RtpAudioStream::canDecodeConcurrently() const
+{
+    return rtp_decoders_thread_safe(decoders_hash_);
+}
+
 void RtpAudioStream::decode(QAudioDevice out_device)
 {
     if (rtp_packets_.size() < 1) return;
 
     audio_file_->setFrameWriteStage();
+    visual_samples_rate_ = 0;
     decodeAudio(out_device);
 
     decodeVisual();
@@ -258,16 +286,6 @@ void RtpAudioStream::decodeAudio(QAudioDevice out_device)
 
         stop_rel_time_ = start_rel_time_ + rtp_packet->arrive_offset;
 
-        QString payload_name;
-        if (rtp_packet->info->info_payload_type_str) {
-            payload_name = rtp_packet->info->info_payload_type_str;
-        } else {
-            payload_name = try_val_to_str_ext(rtp_packet->info->info_payload_type, get_external_value_string_ext("rtp_payload_type_short_vals_ext"));
-        }
-        if (!payload_name.isEmpty()) {
-            payload_names_ << payload_name;
-        }
-
         if (cur_packet < 1) { // First packet
             start_timestamp = rtp_packet->info->info_extended_timestamp;
             start_rtp_time = 0;
@@ -452,6 +470,14 @@ void RtpAudioStream::decodeAudio(QAudioDevice out_device)
 #define VISUAL_BUFF_BYTES (SAMPLE_BYTES * VISUAL_BUFF_LEN)
 void RtpAudioStream::decodeVisual()
 {
+    // The waveform depends only on the decoded audio and the visual rate.
+    // createPlot() overwrites max_sample_val_ with the common scale, so put
+    // back our own maximum as a full pass would have.
+    if (visual_samples_rate_ != 0 && visual_samples_rate_ == visual_sample_rate_) {
+        max_sample_val_ = max_sample_val_used_;
+        return;
+    }
+
     spx_uint32_t read_len = 0;
     int32_t read_buff_bytes = VISUAL_BUFF_BYTES;
     SAMPLE *read_buff = (SAMPLE *) g_malloc(read_buff_bytes);
@@ -502,6 +528,7 @@ void RtpAudioStream::decodeVisual()
     }
 
     max_sample_val_used_ = max_sample_val_;
+    visual_samples_rate_ = visual_sample_rate_;
     g_free(resample_buff);
     g_free(read_buff);
 
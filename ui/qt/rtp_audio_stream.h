@@ -109,14 +109,33 @@ public:
      */
     void setAudioRouting(AudioRouting audio_routing);
 
+    /**
+     * @brief Creates the codec decoders for the stream's payload types and
+     * collects the payload names. Must be called from the GUI thread before
+     * decode(), as creating decoders uses shared epan and codec state.
+     */
+    void prepareDecode();
+
+    /**
+     * @brief Checks whether this stream may be decoded while other streams
+     * are being decoded. Only valid after prepareDecode().
+     * @return true if all of the stream's codecs allow concurrent decoding.
+     */
+    bool canDecodeConcurrently() const;
+
     /**
      * @brief Decodes the audio stream using the specified output device.
+     * Once prepareDecode() has been called, this only uses this stream's
+     * own audio file, resamplers, and codec contexts, so streams for which
+     * canDecodeConcurrently() is true may be decoded concurrently.
      * @param out_device The audio output device.
      */
     void decode(QAudioDevice out_device);
 
     /**
      * @brief Decodes the stream data for visualization.
+     * The result is cached until the audio is decoded again or the visual
+     * sample rate changes.
      */
     void decodeVisual();
 
@@ -480,6 +499,8 @@ private:
     quint32 audio_requested_out_rate_;
     /** @brief The sample rate used for visualization generation. */
     uint32_t visual_sample_rate_;
+    /** @brief The sample rate visual_samples_ were generated at, or 0 if they are stale. */
+    uint32_t visual_samples_rate_;
     /** @brief Unique set of payload type names in the stream. */
     QSet<QString> payload_names_;
     /** @brief Resampler state for generating visual samples. */
@@ -47,6 +47,7 @@
 #include <QMenu>
 #include <QVBoxLayout>
 #include <QTimer>
+#include <QtConcurrent>
 
 #include <QAudioFormat>
 #include <QAudioOutput>
@@ -476,6 +477,8 @@ void RtpPlayerDialog::rescanPackets(bool rescale_axes)
 
     QAudioDevice cur_out_device = getCurrentDeviceInfo();
     int row_count = ui->streamTreeWidget->topLevelItemCount();
+    QList<RtpAudioStream *> concurrent_streams;
+    QList<RtpAudioStream *> serial_streams;
 
     // Reset stream values
     for (int row = 0; row < row_count; row++) {
@@ -498,10 +501,22 @@ void RtpPlayerDialog::rescanPackets(bool rescale_axes)
             break;
         }
         audio_stream->setTimingMode(timing_mode);
+        audio_stream->prepareDecode();
+        if (audio_stream->canDecodeConcurrently()) {
+            concurrent_streams << audio_stream;
+        } else {
+            serial_streams << audio_stream;
+        }
+    }
 
-	       //if (!cur_out_device.isNull()) {
-            audio_stream->decode(cur_out_device);
-        //}
+    // With their decoders created above, each stream decodes into its own
+    // file with its own codec contexts, so streams whose codecs allow it
+    // can be decoded side by side. The rest are decoded one at a time.
+    QtConcurrent::blockingMap(concurrent_streams, [cur_out_device](RtpAudioStream *audio_stream) {
+        audio_stream->decode(cur_out_device);
+    });
+    foreach(RtpAudioStream *audio_stream, serial_streams) {
+        audio_stream->decode(cur_out_device);
     }
 
     for (int col = 0; col < ui->streamTreeWidget->columnCount() - 1; col++) {
@@ -19,6 +19,9 @@
 #include <ui/qt/widgets/qcp_axis_ticker_elided.h>
 #include "ui/recent.h"
 
+#include <climits>
+#include <cmath>
+
 #include <QFont>
 #include <QFontMetrics>
 #include <QPalette>
@@ -157,6 +160,7 @@ int SequenceDiagram::adjacentPacket(bool next)
 void SequenceDiagram::setData(_seq_analysis_info *sainfo)
 {
     data_->clear();
+    frame_keys_.clear();
     sainfo_ = sainfo;
     if (!sainfo) return;
 
@@ -173,6 +177,7 @@ void SequenceDiagram::setData(_seq_analysis_info *sainfo)
             new_data.key = cur_key;
             new_data.value = sai;
             data_->insert(new_data.key, new_data);
+            frame_keys_.insert(sai->frame_number, cur_key);
 
             key_ticks.append(cur_key);
             key_labels.append(sai->time_str);
@@ -207,6 +212,8 @@ void SequenceDiagram::setSelectedPacket(int selected_packet)
     selected_key_ = -1;
     if (selected_packet > 0) {
         selected_packet_ = selected_packet;
+        // draw() only visits visible rows, so look the key up here.
+        selected_key_ = frame_keys_.value(selected_packet_, -1);
     } else {
         selected_packet_ = 0;
     }
@@ -269,12 +276,31 @@ void SequenceDiagram::draw(QCPPainter *painter)
     painter->restore();
     fg_pen = pen();
 
-    WSCPSeqDataMap::const_iterator it;
-    for (it = data_->constBegin(); it != data_->constEnd(); ++it) {
+    // Level of detail. Only rows that touch the visible key range are
+    // drawn. Labels are left out when rows are too short to read them, and
+    // when a row is less than a pixel high, rows landing on the same
+    // pixel are collapsed into the first one.
+    QFontMetrics cfm(comment_axis_->tickLabelFont());
+    double row_height = qAbs(key_axis_->coordToPixel(1) - key_axis_->coordToPixel(0));
+    bool draw_labels = row_height >= cfm.height() / 2.0;
+    bool collapse_rows = row_height < 1.0;
+    int last_row_pixel = INT_MIN;
+
+    WSCPSeqDataMap::const_iterator it = data_->lowerBound(std::floor(key_axis_->range().lower - 0.5));
+    WSCPSeqDataMap::const_iterator end = data_->upperBound(std::ceil(key_axis_->range().upper + 0.5));
+    for (; it != end; ++it) {
         double cur_key = it.key();
         seq_analysis_item_t *sai = it.value().value;
         QColor bg_color;
 
+        if (collapse_rows) {
+            int row_pixel = static_cast<int>(key_axis_->coordToPixel(cur_key));
+            if (row_pixel == last_row_pixel && sai->frame_number != selected_packet_) {
+                continue;
+            }
+            last_row_pixel = row_pixel;
+        }
+
         if (sai->frame_number == selected_packet_) {
             QPalette sel_pal;
             fg_pen.setColor(sel_pal.color(QPalette::HighlightedText));
@@ -328,7 +354,6 @@ void SequenceDiagram::draw(QCPPainter *painter)
         if (pen().style() != Qt::NoPen && pen().color().alpha() != 0) {
             painter->save();
 
-            QFontMetrics cfm(comment_axis_->tickLabelFont());
             double en_w = cfm.height() / 2.0;
             int dir_mul = (sai->src_node < sai->dst_node) ? 1 : -1;
             double ah_size = (cfm.height() / 5) * dir_mul;
@@ -348,6 +373,11 @@ void SequenceDiagram::draw(QCPPainter *painter)
             painter->drawLine(arrow_line);
             painter->drawPolygon(arrow_head);
 
+            if (!draw_labels) {
+                painter->restore();
+                continue;
+            }
+
             double comment_start = (sai->src_node < sai->dst_node)
                     ? arrow_start.x() : arrow_end.x();
             double arrow_width = (arrow_end.x() - arrow_start.x()) * dir_mul;
@@ -14,6 +14,7 @@
 
 #include <epan/address.h>
 
+#include <QHash>
 #include <QObject>
 #include <QMultiMap>
 #include <ui/qt/widgets/qcustomplot.h>
@@ -124,7 +125,7 @@ public:
     /**
      * @brief Removes all data points from the internal data map.
      */
-    virtual void clearData() { data_->clear(); }
+    virtual void clearData() { data_->clear(); frame_keys_.clear(); }
 
     /**
      * @brief Returns the distance from @p pos to the nearest data point for
@@ -146,8 +147,10 @@ public slots:
 
 protected:
     /**
-     * @brief Draws all sequence diagram arrows, participant labels, and comment
-     *        text onto @p painter.
+     * @brief Draws the sequence diagram arrows, participant labels, and comment
+     *        text that fall within the visible key range onto @p painter.
+     *        When rows are shorter than a line of text the labels are left
+     *        out, and when several rows share a pixel only the first is drawn.
      * @param painter QCustomPlot painter to render with.
      */
     virtual void draw(QCPPainter *painter) Q_DECL_OVERRIDE;
@@ -181,6 +184,7 @@ private:
     QCPAxis              *value_axis_;   /**< Axis for the value (participant column) dimension. */
     QCPAxis              *comment_axis_; /**< Axis used to position and clip comment text. */
     WSCPSeqDataMap       *data_;         /**< Internal map of all sequence diagram data points. */
+    QHash<uint32_t, double> frame_keys_; /**< Frame number to the key of its last data point. */
     struct _seq_analysis_info *sainfo_;  /**< Source sequence analysis info driving the diagram. */
     uint32_t              selected_packet_; /**< Frame number of the currently selected packet. */
     double                selected_key_;   /**< Plot key coordinate of the currently selected data point. */
@@ -11,6 +11,7 @@
 #include <ui_tcp_stream_dialog.h>
 
 #include <algorithm> // for std::sort
+#include <climits> // for INT_MIN
 #include <utility> // for std::pair
 #include <vector>
 
@@ -97,6 +98,77 @@ double QCPErrorBarsNotSelectable::selectTest(const QPointF &pos, bool onlySelect
     return -1.0;
 }
 
+void QCPErrorBarsNotSelectable::draw(QCPPainter *painter)
+{
+    QCPAxis *key_axis = mKeyAxis.data();
+    QCPAxis *value_axis = mValueAxis.data();
+
+    if (!mDataPlottable || !key_axis || !value_axis || mDataContainer->isEmpty() ||
+            mErrorType != etValueError || key_axis->orientation() != Qt::Horizontal ||
+            !mDataPlottable->interface1D()->sortKeyIsMainKey()) {
+        QCPErrorBars::draw(painter);
+        return;
+    }
+
+    QCPErrorBarsDataContainer::const_iterator begin, end;
+    getVisibleDataBounds(begin, end, QCPDataRange(0, dataCount()));
+    int columns = key_axis->axisRect()->width();
+
+    // Few enough bars that each one is distinguishable; draw them normally.
+    if (end - begin <= 2 * columns) {
+        QCPErrorBars::draw(painter);
+        return;
+    }
+
+    // Per pixel column min/max decimation. Error bars are vertical, so the
+    // bars in a column are covered by one line from the lowest bottom to
+    // the highest top.
+    QCPPlottableInterface1D *data_interface = mDataPlottable->interface1D();
+    QVector<QLineF> backbones;
+    backbones.reserve(columns + 1);
+
+    int cur_column = INT_MIN;
+    double col_min = 0, col_max = 0;
+    for (QCPErrorBarsDataContainer::const_iterator it = begin; it != end; ++it) {
+        int index = int(it - mDataContainer->constBegin());
+        double value = data_interface->dataMainValue(index);
+        if (qIsNaN(value) || qIsNaN(it->errorMinus) || qIsNaN(it->errorPlus)) {
+            continue;
+        }
+
+        int column = int(key_axis->coordToPixel(data_interface->dataMainKey(index)));
+        double bottom = value_axis->coordToPixel(value - it->errorMinus);
+        double top = value_axis->coordToPixel(value + it->errorPlus);
+        if (bottom > top) {
+            qSwap(bottom, top);
+        }
+
+        if (column != cur_column) {
+            if (cur_column != INT_MIN) {
+                backbones.append(QLineF(cur_column, col_min, cur_column, col_max));
+            }
+            cur_column = column;
+            col_min = bottom;
+            col_max = top;
+        } else {
+            col_min = qMin(col_min, bottom);
+            col_max = qMax(col_max, top);
+        }
+    }
+    if (cur_column != INT_MIN) {
+        backbones.append(QLineF(cur_column, col_min, cur_column, col_max));
+    }
+
+    applyDefaultAntialiasingHint(painter);
+    painter->setBrush(Qt::NoBrush);
+    QPen pen(mPen);
+    if (pen.capStyle() == Qt::SquareCap) {
+        pen.setCapStyle(Qt::FlatCap);
+    }
+    painter->setPen(pen);
+    painter->drawLines(backbones);
+}
+
 void QCPErrorBarsNotSelectable::drawLegendIcon(QCPPainter *painter, const QRectF &rect) const
 {
     applyDefaultAntialiasingHint(painter);
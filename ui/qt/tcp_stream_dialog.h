@@ -69,6 +69,17 @@ public:
      * @param rect The rectangle defining the icon bounds.
      */
     virtual void drawLegendIcon(QCPPainter *painter, const QRectF &rect) const override;
+
+protected:
+    /**
+     * @brief Draws the visible error bars.
+     *
+     * When there are more bars in view than pixel columns, the bars that
+     * fall into each column are merged into a single line spanning their
+     * combined extent, much like QCPGraph's adaptive sampling.
+     * @param painter The QCPPainter to draw with.
+     */
+    virtual void draw(QCPPainter *painter) override;
 };
 
 /**
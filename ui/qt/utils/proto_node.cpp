@@ -12,26 +12,35 @@
 
 #include <epan/prefs.h>
 
-// NOLINTNEXTLINE(misc-no-recursion)
-ProtoNode::ProtoNode(proto_node *node, ProtoNode *parent) :
-    node_(node), parent_(parent)
+ProtoNode::ProtoNode(proto_node *node, ProtoNode *parent, int row) :
+    node_(node), children_built_(false), parent_(parent), row_(row)
 {
-    if (node_) {
+}
+
+void ProtoNode::buildChildren() const
+{
+    if (children_built_) {
+        return;
+    }
+    children_built_ = true;
 
-        int num_children = 0;
-        for (proto_node *child = node_->first_child; child; child = child->next) {
-            if (!isHidden(child)) {
-                num_children++;
-            }
+    if (!node_) {
+        return;
+    }
+
+    int num_children = 0;
+    for (proto_node *child = node_->first_child; child; child = child->next) {
+        if (!isHidden(child)) {
+            num_children++;
         }
+    }
 
-        m_children.reserve(num_children);
+    m_children.reserve(num_children);
 
-        for (proto_node *child = node_->first_child; child; child = child->next) {
-            if (!isHidden(child)) {
-                // We recurse here, but we're limited by tree depth checks in epan
-                m_children.append(new ProtoNode(child, this));
-            }
+    ProtoNode *self = const_cast<ProtoNode *>(this);
+    for (proto_node *child = node_->first_child; child; child = child->next) {
+        if (!isHidden(child)) {
+            m_children.append(new ProtoNode(child, self, (int)m_children.size()));
         }
     }
 }
@@ -93,6 +102,7 @@ int ProtoNode::childrenCount() const
 {
     if (!node_) return 0;
 
+    buildChildren();
     return (int)m_children.count();
 }
 
@@ -102,7 +112,7 @@ int ProtoNode::row()
         return -1;
     }
 
-    return (int)parent_->m_children.indexOf(const_cast<ProtoNode*>(this));
+    return row_;
 }
 
 bool ProtoNode::isExpanded() const
@@ -120,6 +130,7 @@ proto_node * ProtoNode::protoNode() const
 
 ProtoNode* ProtoNode::child(int row)
 {
+    buildChildren();
     if (row < 0 || row >= m_children.size())
         return nullptr;
     return m_children.at(row);
@@ -63,10 +63,14 @@ public:
 
     /**
      * @brief Constructs a new ProtoNode instance.
+     *
+     * Child ProtoNodes are created the first time they are asked for, so
+     * wrapping a large tree only costs as much as the part that is shown.
      * @param node The underlying core proto_node, defaults to NULL.
      * @param parent The parent ProtoNode, defaults to nullptr.
+     * @param row The index of this node among its parent's children.
      */
-    explicit ProtoNode(proto_node * node = NULL, ProtoNode *parent = nullptr);
+    explicit ProtoNode(proto_node * node = NULL, ProtoNode *parent = nullptr, int row = -1);
 
     /**
      * @brief Destroys the ProtoNode.
@@ -139,11 +143,22 @@ private:
     proto_node * node_;
 
     /** Cached list of child ProtoNode instances. */
-    QVector<ProtoNode*>m_children;
+    mutable QVector<ProtoNode*>m_children;
+
+    /** True once m_children has been filled in. */
+    mutable bool children_built_;
 
     /** Pointer to the parent ProtoNode. */
     ProtoNode *parent_;
 
+    /** Index of this node in parent_->m_children. */
+    int row_;
+
+    /**
+     * @brief Creates the (direct) child ProtoNodes if they don't exist yet.
+     */
+    void buildChildren() const;
+
     /**
      * @brief Determines if a given proto_node should be hidden from display.
      * @param node The node to check.
@@ -50,7 +50,7 @@ void FollowStreamText::addTruncated(int cur_pos)
         QTextCharFormat tcf = currentCharFormat();
         tcf.setBackground(palette().base().color());
         tcf.setForeground(metainfo_fg_);
-        insertPlainText("\n" + tr("[Stream output truncated]"));
+        insertPlainText("\n" + tr("[Stream output truncated. Save As writes the entire stream.]"));
         moveCursor(QTextCursor::End);
     } else {
         verticalScrollBar()->setValue(cur_pos);
@@ -182,6 +182,8 @@ QTreeView * TrafficTab::createTree(int protoId)
         });
         connect(proxyModel, &TrafficDataFilterProxy::modelReset, this, &TrafficTab::modelReset);
         connect(proxyModel, &TrafficDataFilterProxy::layoutChanged, this, &TrafficTab::modelReset);
+        connect(proxyModel, &TrafficDataFilterProxy::rowsInserted, this, &TrafficTab::modelReset);
+        connect(proxyModel, &TrafficDataFilterProxy::rowsRemoved, this, &TrafficTab::modelReset);
 
         /* If the columns for the tree have changed, contact the tab. By also having the tab
          * columns changed signal connecting back to the tree, it will propagate to all trees
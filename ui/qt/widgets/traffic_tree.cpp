@@ -575,6 +575,7 @@ void TrafficTree::setModel(QAbstractItemModel * model)
             disconnect(_header, &TrafficTreeHeaderView::filterOnColumn, proxy, &TrafficDataFilterProxy::filterForColumn);
             disconnect(proxy, &TrafficDataFilterProxy::dataChanged, this, &TrafficTree::handleDataChanged);
             disconnect(proxy, &TrafficDataFilterProxy::layoutChanged, this, &TrafficTree::handleLayoutChanged);
+            disconnect(proxy, &TrafficDataFilterProxy::rowsInserted, this, &TrafficTree::handleRowsInserted);
         }
     }
     if (model) {
@@ -583,6 +584,7 @@ void TrafficTree::setModel(QAbstractItemModel * model)
             connect(_header, &TrafficTreeHeaderView::filterOnColumn, proxy, &TrafficDataFilterProxy::filterForColumn);
             connect(proxy, &TrafficDataFilterProxy::dataChanged, this, &TrafficTree::handleDataChanged);
             connect(proxy, &TrafficDataFilterProxy::layoutChanged, this, &TrafficTree::handleLayoutChanged);
+            connect(proxy, &TrafficDataFilterProxy::rowsInserted, this, &TrafficTree::handleRowsInserted);
         }
     }
 }
@@ -804,6 +806,13 @@ void TrafficTree::handleLayoutChanged(const QList<QPersistentModelIndex>, QAbstr
     scrollTo(currentIndex());
 }
 
+void TrafficTree::handleRowsInserted(const QModelIndex &, int, int)
+{
+    for (int col = 0; col < model()->columnCount(); ++col) {
+        widenColumnToContents(col);
+    }
+}
+
 void TrafficTree::toggleSaveRawAction()
 {
     if (_exportRole == ATapDataModel::UNFORMATTED_DISPLAYDATA)
@@ -418,6 +418,11 @@ private slots:
      * @brief Handles updates when the model layout changes.
      */
     void handleLayoutChanged(const QList<QPersistentModelIndex>, QAbstractItemModel::LayoutChangeHint);
+
+    /**
+     * @brief Handles updates when rows are added to the model.
+     */
+    void handleRowsInserted(const QModelIndex &, int, int);
 };
 
 #endif // TRAFFIC_TREE_H
@@ -88,6 +88,18 @@ decode_rtp_find_or_create_decoder(uint8_t payload_type, const char *payload_type
     return decoder;
 }
 
+/*
+ * Return a new fmtp map for decoding IuUP payloads, which are converted
+ * to octet-aligned AMR.
+ */
+static wmem_map_t *
+iuup_amr_fmtp_map_new(void)
+{
+    wmem_map_t *iuup_decode_amr_fmtp = wmem_map_new(wmem_epan_scope(), wmem_str_hash, g_str_equal);
+    wmem_map_insert(iuup_decode_amr_fmtp, "octet-align", "1");
+    return iuup_decode_amr_fmtp;
+}
+
 /****************************************************************************/
 /** Decode payload from an RTP packet
  * For RTP packets with dynamic payload types, the payload name, clock rate,
@@ -248,13 +260,11 @@ decode_iuup_packet(rtp_packet_t *rp, SAMPLE **out_buff, GHashTable *decoders_has
     /* Look for registered codecs */
     decoder = decode_rtp_find_decoder(rp->info->info_payload_type, decoders_hash);
     if (!decoder) {
-            wmem_map_t *iuup_decode_amr_fmtp = wmem_map_new(wmem_epan_scope(), wmem_str_hash, g_str_equal);
-            wmem_map_insert(iuup_decode_amr_fmtp, "octet-align", "1");
             decoder = decode_rtp_create_decoder(rp->info->info_payload_type,
                                                 "amr",
                                                 rp->info->info_payload_rate,
                                                 rp->info->info_payload_channels,
-                                                iuup_decode_amr_fmtp,
+                                                iuup_amr_fmtp_map_new(),
                                                 decoders_hash);
             ws_assert(decoder);
     }
@@ -298,6 +308,53 @@ decode_rtp_packet(rtp_packet_t *rp, SAMPLE **out_buff, GHashTable *decoders_hash
                                      out_buff, channels_ptr, sample_rate_ptr);
 }
 
+/****************************************************************************/
+void
+decode_rtp_prepare_decoder(rtp_packet_t *rp, GHashTable *decoders_hash)
+{
+    if ((rp->payload_data == NULL) || (rp->info->info_payload_len == 0) ) {
+        return;
+    }
+
+    if (decode_rtp_find_decoder(rp->info->info_payload_type, decoders_hash))
+        return;
+
+    if (rp->info->info_is_iuup) {
+        decode_rtp_create_decoder(rp->info->info_payload_type,
+                                  "amr",
+                                  rp->info->info_payload_rate,
+                                  rp->info->info_payload_channels,
+                                  iuup_amr_fmtp_map_new(),
+                                  decoders_hash);
+    } else {
+        decode_rtp_create_decoder(rp->info->info_payload_type,
+                                  rp->info->info_payload_type_str,
+                                  rp->info->info_payload_rate,
+                                  rp->info->info_payload_channels,
+                                  rp->info->info_payload_fmtp_map,
+                                  decoders_hash);
+    }
+}
+
+/****************************************************************************/
+bool
+rtp_decoders_thread_safe(GHashTable *decoders_hash)
+{
+    GHashTableIter iter;
+    void *value;
+
+    g_hash_table_iter_init(&iter, decoders_hash);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        rtp_decoder_t *dec = (rtp_decoder_t *)value;
+
+        /* Payloads without a codec are only turned into silence */
+        if (dec->handle && !codec_decode_is_thread_safe(dec->handle)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 /****************************************************************************/
 static void
 rtp_decoder_value_destroy(void *dec_arg)
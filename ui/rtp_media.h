@@ -64,6 +64,31 @@ GHashTable *rtp_decoder_hash_table_new(void);
  */
 size_t decode_rtp_packet(rtp_packet_t *rp, SAMPLE **out_buff, GHashTable *decoders_hash, unsigned *channels_ptr, unsigned *sample_rate_ptr);
 
+/** Create the decoder decode_rtp_packet will use for an RTP packet, if
+ * decoders_hash doesn't have one for its payload type yet.
+ *
+ * Creating a decoder looks up shared value_string tables, allocates in
+ * wmem_epan_scope() and calls the codec's init routine, none of which
+ * may be done from more than one thread at a time. Once this has been
+ * called for every packet of a stream, decode_rtp_packet only uses the
+ * decoders in decoders_hash, so streams with different hash tables can
+ * be decoded in different threads if rtp_decoders_thread_safe says their
+ * codecs allow it.
+ *
+ * @param rp Wrapper for per-packet RTP tap data.
+ * @param decoders_hash Hash table created with rtp_decoder_hash_table_new.
+ */
+void decode_rtp_prepare_decoder(rtp_packet_t *rp, GHashTable *decoders_hash);
+
+/** Check whether the decoders in a hash table may decode while other
+ * streams are being decoded in other threads.
+ *
+ * @param decoders_hash Hash table created with rtp_decoder_hash_table_new.
+ * @return true if every codec in decoders_hash was registered with
+ * CODEC_DECODE_THREAD_SAFE.
+ */
+bool rtp_decoders_thread_safe(GHashTable *decoders_hash);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -190,6 +190,9 @@ static int packet_preamble_len;
 static time_t   ts_sec;
 static uint32_t ts_nsec;
 static bool ts_fmt_iso;
+/* The strptime format split at "%f", done once per import rather than per packet */
+static char *ts_fmt_main;
+static const char *ts_fmt_subsecs;
 static struct tm timecode_default;
 static bool timecode_warned;
 /* The time delta to add to packets without a valid time code.
@@ -406,18 +409,28 @@ parse_num(const char *str, int offset, uint32_t* num)
     return IMPORT_SUCCESS;
 }
 
+/*----------------------------------------------------------------------
+ * Get the value of a hex digit that the scanner has already checked
+ * ([[:xdigit:]]). Bit 6 is set for letters, and the low nibble of 'A'-'F'
+ * and 'a'-'f' is 1-6, so this needs no table and no branches.
+ */
+static inline uint8_t
+hex_digit_value(char c)
+{
+    return (uint8_t)((c & 0x0f) + 9 * ((c >> 6) & 1));
+}
+
 /*----------------------------------------------------------------------
  * Write this byte into current packet
+ *
+ * This is called for every byte of every packet, so it decodes the two
+ * hex digits of a T_BYTE token directly rather than going through
+ * strtoul().
  */
 static import_status_t
 write_byte(const char *str)
 {
-    uint32_t num;
-
-    if (parse_num(str, false, &num) != IMPORT_SUCCESS)
-        return IMPORT_FAILURE;
-
-    packet_buf[curr_offset] = (uint8_t) num;
+    packet_buf[curr_offset] = (uint8_t)((hex_digit_value(str[0]) << 4) | hex_digit_value(str[1]));
     curr_offset++;
     if (curr_offset >= info_p->max_frame_length) /* packet full */
         if (start_new_packet(true) != IMPORT_SUCCESS)
@@ -429,12 +442,13 @@ write_byte(const char *str)
 static import_status_t
 write_bytes(const char *str)
 {
-    uint32_t num;
+    uint32_t num = 0;
+    int len;
 
-    if (parse_num(str, false, &num) != IMPORT_SUCCESS)
-        return IMPORT_FAILURE;
+    /* T_BYTES tokens are 4 to 8 hex digits, so this can't overflow. */
+    for (len = 0; str[len] != '\0'; len++)
+        num = (num << 4) | hex_digit_value(str[len]);
 
-    int len = (int)strlen(str);
     /* There's always extra room in the packet_buf for the dummy headers
      * compared to max_frame_length, so we could copy all the bytes at
      * once and then check for overflow afterwards (copying it off).
@@ -1142,9 +1156,7 @@ _parse_time(const unsigned char* start_field, const unsigned char* end_field, co
     int nsec_buf = 0;
 
     char field[PARSE_BUF];
-    char format[PARSE_BUF];
 
-    char* subsecs_fmt;
     int  subseclen = -1;
 
     char *cursor;
@@ -1160,8 +1172,6 @@ _parse_time(const unsigned char* start_field, const unsigned char* end_field, co
         *sec = ts_iso.secs;
         *nsec = (unsigned)ts_iso.nsecs;
     } else {
-        (void) g_strlcpy(format, _format, PARSE_BUF);
-
         /*
          * Initialize to today, local time, just in case not all fields
          * of the date and time are specified.
@@ -1170,20 +1180,17 @@ _parse_time(const unsigned char* start_field, const unsigned char* end_field, co
         cursor = &field[0];
 
         /*
-         * %f is for fractions of seconds not supported by strptime
+         * %f is for fractions of seconds not supported by strptime;
+         * text_import() split the format there (_format is the whole
+         * thing).
          */
-        subsecs_fmt = g_strrstr(format, "%f");
-        if (subsecs_fmt) {
-            *subsecs_fmt = 0;
-        }
-
-        cursor = ws_strptime_p(cursor, format, &timecode);
+        cursor = ws_strptime_p(cursor, ts_fmt_main, &timecode);
 
         if (cursor == NULL) {
             return false;
         }
 
-        if (subsecs_fmt != NULL) {
+        if (ts_fmt_subsecs != NULL) {
             /*
              * Parse subsecs and any following format
              */
@@ -1194,7 +1201,7 @@ _parse_time(const unsigned char* start_field, const unsigned char* end_field, co
 
             subseclen = (int) (p - cursor);
             cursor = p;
-            cursor = ws_strptime_p(cursor, subsecs_fmt + 2, &timecode);
+            cursor = ws_strptime_p(cursor, ts_fmt_subsecs, &timecode);
             if (cursor == NULL) {
                 return false;
             }
@@ -1852,6 +1859,19 @@ text_import(text_import_info_t * const info)
     } else {
         ts_fmt_iso = true;
     }
+    g_free(ts_fmt_main);
+    ts_fmt_main = NULL;
+    ts_fmt_subsecs = NULL;
+    if (info->timestamp_format != NULL && !ts_fmt_iso) {
+        char *subsecs_fmt;
+
+        ts_fmt_main = g_strdup(info->timestamp_format);
+        subsecs_fmt = g_strrstr(ts_fmt_main, "%f");
+        if (subsecs_fmt) {
+            *subsecs_fmt = '\0';
+            ts_fmt_subsecs = subsecs_fmt + 2;
+        }
+    }
     offset_warned = false;
     timecode_warned = false;
 
@@ -1991,6 +2011,9 @@ text_import(text_import_info_t * const info)
     }
     g_free(packet_buf);
     ws_buffer_free(&prefix_buf);
+    g_free(ts_fmt_main);
+    ts_fmt_main = NULL;
+    ts_fmt_subsecs = NULL;
     return ret;
 }
 
@@ -2093,5 +2116,10 @@ text_import_pre_open(wtap_dump_params * const params, int file_type_subtype, con
 
     }
 
+    /* Packets are written strictly in order, so let the output be written
+     * on a background thread while we carry on parsing. */
+    params->buffered = true;
+    params->async_flush = true;
+
     return EXIT_SUCCESS;
 }
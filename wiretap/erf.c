@@ -71,6 +71,8 @@ static bool erf_read_header(wtap *wth, FILE_T fh,
                                 GPtrArray *anchor_mappings_to_update);
 static bool erf_read(wtap *wth, wtap_rec *rec,
                          int *err, char **err_info, int64_t *data_offset);
+static bool erf_read_header_only(wtap *wth, wtap_rec *rec,
+                                 int *err, char **err_info, int64_t *data_offset);
 static bool erf_seek_read(wtap *wth, int64_t seek_off,
                               wtap_rec *rec,
                               int *err, char **err_info);
@@ -564,6 +566,7 @@ extern wtap_open_return_val erf_open(wtap *wth, int *err, char **err_info)
   wth->file_encap = WTAP_ENCAP_ERF;
 
   wth->subtype_read = erf_read;
+  wth->subtype_read_header_only = erf_read_header_only;
   wth->subtype_seek_read = erf_seek_read;
   wth->subtype_close = erf_close;
   wth->file_tsprec = WTAP_TSPREC_NSEC;
@@ -574,8 +577,8 @@ extern wtap_open_return_val erf_open(wtap *wth, int *err, char **err_info)
 }
 
 /* Read the next packet */
-static bool erf_read(wtap *wth, wtap_rec *rec,
-                         int *err, char **err_info, int64_t *data_offset)
+static bool erf_read_record(wtap *wth, wtap_rec *rec, bool header_only,
+                            int *err, char **err_info, int64_t *data_offset)
 {
   erf_header_t erf_header;
   uint32_t     packet_size, bytes_read;
@@ -593,6 +596,19 @@ static bool erf_read(wtap *wth, wtap_rec *rec,
       return false;
     }
 
+    /*
+     * Provenance metadata records describe the interfaces, so they're
+     * always read; the data of anything else can be skipped if the
+     * caller only wants the record header.
+     */
+    if (header_only && (erf_header.type & 0x7F) != ERF_TYPE_META) {
+      if (!wtap_read_bytes(wth->fh, NULL, packet_size, err, err_info)) {
+        g_ptr_array_free(anchor_mappings_to_update, true);
+        return false;
+      }
+      continue;
+    }
+
     if (!wtap_read_bytes_buffer(wth->fh, &rec->data, packet_size, err, err_info)) {
       g_ptr_array_free(anchor_mappings_to_update, true);
       return false;
@@ -618,6 +634,18 @@ static bool erf_read(wtap *wth, wtap_rec *rec,
   return true;
 }
 
+static bool erf_read(wtap *wth, wtap_rec *rec,
+                         int *err, char **err_info, int64_t *data_offset)
+{
+  return erf_read_record(wth, rec, false, err, err_info, data_offset);
+}
+
+static bool erf_read_header_only(wtap *wth, wtap_rec *rec,
+                                 int *err, char **err_info, int64_t *data_offset)
+{
+  return erf_read_record(wth, rec, true, err, err_info, data_offset);
+}
+
 static bool erf_seek_read(wtap *wth, int64_t seek_off,
                               wtap_rec *rec,
                               int *err, char **err_info)
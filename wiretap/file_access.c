@@ -383,9 +383,10 @@ static const struct open_info open_info_base[] = {
 	{ "CAM Inspector file",                     OPEN_INFO_HEURISTIC, camins_open,              "camins",   NULL, NULL },
 };
 
-/* this is only used to build the dynamic array on load, do NOT use this
- * for anything else, because the size of the actual array will change if
- * Lua scripts register a new file reader.
+/* this is only used to build the dynamic array on load and to index
+ * open_info_base[] itself, do NOT use this for anything else, because the
+ * size of the actual array will change if Lua scripts register a new file
+ * reader.
  */
 #define N_OPEN_INFO_ROUTINES  array_length(open_info_base)
 
@@ -694,6 +695,115 @@ get_file_extension(const char *pathname)
 	return extensionp;
 }
 
+/*
+ * Magic numbers that identify a file format on their own.
+ *
+ * For the magic-number readers, each of these is checked by the reader's
+ * open routine before it looks at anything else, and none of them is
+ * accepted by any reader that precedes that reader in open_info_base[].
+ * If a file starts with one of them, trying that reader first gives the
+ * same answer as trying every magic-number reader in order, without all
+ * the others having to read and reject the file.  pcap and pcapng
+ * aren't listed; they're the first two readers in open_info_base[], so
+ * they're already tried first.
+ *
+ * For the heuristic readers, these are the lines such files start with.
+ * The heuristic readers are already tried out of order, depending on the
+ * file's extension, so the reader whose signature matches is tried ahead
+ * of them (but after all the magic-number readers), just as one whose
+ * extension matches would be.
+ */
+typedef struct {
+	const char          *magic;
+	unsigned             magic_len;
+	wtap_open_routine_t  open_routine;
+} open_magic_hint_t;
+
+static const open_magic_hint_t open_magic_hints[] = {
+	/* Magic-number readers */
+	{ "TRSNIFF data",       12, ngsniffer_open },
+	{ "snoop\0\0\0",        8,  snoop_open },
+	{ "iptrace ",           8,  iptrace_open },
+	{ "RTSS",               4,  netmon_open },
+	{ "GMBU",               4,  netmon_open },
+	{ "btsnoop\0",          8,  btsnoop_open },
+	{ "LOGG",               4,  blf_open },
+
+	/* Heuristic readers */
+	{ "__CURSOR=",          9,  systemd_journal_open }, /* journalctl -o export */
+	{ ";$FILEVERSION=",     14, peak_trc_open },
+	{ "***BUSMASTER",       12, busmaster_open },
+};
+
+#define OPEN_MAGIC_HINT_PREFIX_LEN	16	/* at least the longest magic in open_magic_hints[] */
+
+/*
+ * Return the index in open_routines[] of "open_routine", if the
+ * part of open_routines[] from "start" up to it holds the same readers,
+ * in the same order, as the part of open_info_base[] from "base_start"
+ * on; a reader registered ahead of the built-in ones may want to claim
+ * the file itself.  Otherwise, return -1.
+ */
+static int
+find_hinted_routine(wtap_open_routine_t open_routine, unsigned start,
+    unsigned end, unsigned base_start)
+{
+	unsigned j, k;
+
+	for (j = start, k = base_start; j < end && k < N_OPEN_INFO_ROUTINES; j++, k++) {
+		if (open_routines[j].open_routine != open_info_base[k].open_routine)
+			return -1;
+		if (open_routines[j].open_routine == open_routine)
+			return (int)j;
+	}
+	return -1;
+}
+
+/*
+ * Look at the first few bytes of the file corresponding to "wth" and,
+ * if they're one of open_magic_hints[], return the index in
+ * open_routines[] of the reader to try first.  Returns -1 if there's
+ * no hint.
+ */
+static int
+open_routine_for_magic(wtap *wth)
+{
+	uint8_t prefix[OPEN_MAGIC_HINT_PREFIX_LEN];
+	int bytes_read;
+	unsigned i, base_heuristic_idx;
+	int idx;
+	int err;
+
+	if (file_seek(wth->fh, 0, SEEK_SET, &err) == -1)
+		return -1;
+	bytes_read = file_read(prefix, sizeof prefix, wth->fh);
+	if (bytes_read <= 0)
+		return -1;
+
+	for (i = 0; i < array_length(open_magic_hints); i++) {
+		const open_magic_hint_t *hint = &open_magic_hints[i];
+
+		if (hint->magic_len > (unsigned)bytes_read ||
+		    memcmp(prefix, hint->magic, hint->magic_len) != 0)
+			continue;
+
+		idx = find_hinted_routine(hint->open_routine, 0,
+		    heuristic_open_routine_idx, 0);
+		if (idx >= 0)
+			return idx;
+
+		for (base_heuristic_idx = 0; base_heuristic_idx < N_OPEN_INFO_ROUTINES; base_heuristic_idx++) {
+			if (open_info_base[base_heuristic_idx].type == OPEN_INFO_HEURISTIC)
+				break;
+		}
+		return find_hinted_routine(hint->open_routine,
+		    heuristic_open_routine_idx, open_info_arr->len,
+		    base_heuristic_idx);
+	}
+
+	return -1;
+}
+
 /*
  * Check if file extension is used in this heuristic
  */
@@ -768,6 +878,7 @@ try_open(wtap *wth, unsigned int type, int *err, char **err_info)
 {
 	int result = WTAP_OPEN_NOT_MINE;
 	unsigned i;
+	int hint_idx;
 	char *extension;
 
 	/* 'type' is 1-based. */
@@ -776,8 +887,19 @@ try_open(wtap *wth, unsigned int type, int *err, char **err_info)
 		return try_one_open(wth, &open_routines[type - 1], err, err_info);
 	}
 
-	/* First, all file types that support magic numbers. */
+	/* First, the reader for the file's magic number, if we recognize it. */
+	hint_idx = open_routine_for_magic(wth);
+	if (hint_idx >= 0 && (unsigned)hint_idx < heuristic_open_routine_idx) {
+		result = try_one_open(wth, &open_routines[hint_idx], err, err_info);
+		if (result != WTAP_OPEN_NOT_MINE) {
+			return result;
+		}
+	}
+
+	/* Then, all the other file types that support magic numbers. */
 	for (i = 0; i < heuristic_open_routine_idx && result == WTAP_OPEN_NOT_MINE; i++) {
+		if ((int)i == hint_idx)
+			continue;
 		result = try_one_open(wth, &open_routines[i], err, err_info);
 	}
 
@@ -785,6 +907,14 @@ try_open(wtap *wth, unsigned int type, int *err, char **err_info)
 		return result;
 	}
 
+	/* Then the heuristic reader whose signature the file starts with. */
+	if (hint_idx >= 0 && (unsigned)hint_idx >= heuristic_open_routine_idx) {
+		result = try_one_open(wth, &open_routines[hint_idx], err, err_info);
+		if (result != WTAP_OPEN_NOT_MINE) {
+			return result;
+		}
+	}
+
 	/* Does this file's name have an extension? */
 	extension = get_file_extension(wth->pathname);
 	if (extension != NULL) {
@@ -816,6 +946,8 @@ try_open(wtap *wth, unsigned int type, int *err, char **err_info)
 
 		for (pass = 0; pass < 3 && result == WTAP_OPEN_NOT_MINE; pass++) {
 			for (i = heuristic_open_routine_idx; i < open_info_arr->len && result == WTAP_OPEN_NOT_MINE; i++) {
+				if ((int)i == hint_idx)
+					continue;
 				if (   (pass == 0 && heuristic_uses_extension(i, extension))
 				    || (pass == 1 && open_routines[i].extensions == NULL)
 				    || (pass == 2 && open_routines[i].extensions != NULL
@@ -829,6 +961,8 @@ try_open(wtap *wth, unsigned int type, int *err, char **err_info)
 	} else {
 		/* No extension.  Try all the heuristic types in order. */
 		for (i = heuristic_open_routine_idx; i < open_info_arr->len && result == WTAP_OPEN_NOT_MINE; i++) {
+			if ((int)i == hint_idx)
+				continue;
 			result = try_one_open(wth, &open_routines[i], err, err_info);
 		}
 	}
@@ -2105,6 +2239,7 @@ wtap_dump_can_compress(int file_type_subtype _U_)
 }
 #endif
 
+static void wtap_dump_batch_start(wtap_dumper *wdh);
 static bool wtap_dump_open_finish(wtap_dumper *wdh, int *err,
 				      char **err_info);
 
@@ -2181,6 +2316,8 @@ wtap_dump_init_dumper(int file_type_subtype, ws_compression_type compression_typ
 	wdh->snaplen = params->snaplen;
 	wdh->file_encap = params->encap;
 	wdh->compression_type = compression_type;
+	wdh->buffered = params->buffered;
+	wdh->async_flush = params->async_flush;
 	wdh->wslua_data = NULL;
 	wdh->shb_iface_to_global = params->shb_iface_to_global;
 	wdh->interface_data = g_array_new(false, false, sizeof(wtap_block_t));
@@ -2464,6 +2601,9 @@ wtap_dump_open_finish(wtap_dumper *wdh, int *err, char **err_info)
 	if (file_type_subtype_table[wdh->file_type_subtype].wslua_info)
 		wdh->wslua_data = file_type_subtype_table[wdh->file_type_subtype].wslua_info->wslua_data;
 
+	if (wdh->buffered)
+		wtap_dump_batch_start(wdh);
+
 	/* Now try to open the file for writing. */
 	if (!(*file_type_subtype_table[wdh->file_type_subtype].dump_open)(wdh, err,
 	    err_info)) {
@@ -2561,9 +2701,214 @@ wtap_dump(wtap_dumper *wdh, const wtap_rec *rec, int *err, char **err_info)
 	return (wdh->subtype_write)(wdh, rec, err, err_info);
 }
 
+/*
+ * Batched output.
+ *
+ * For uncompressed output, once batching is turned on, everything passed
+ * to wtap_dump_file_write() is copied into wdh->batch_buf, and the buffer
+ * is handed to the file in one piece when it fills up.  That replaces
+ * several small fwrite() calls per record, each of which takes the stdio
+ * lock, with a memcpy().
+ *
+ * With async_flush, a full buffer is swapped with a spare one and written
+ * by a background thread while the dumper fills the other.  Only one
+ * buffer is in flight at a time, so memory use is bounded at two buffers.
+ * Anything that touches the FILE * directly - seeking, telling, flushing
+ * and closing - first waits for the background write to finish.
+ */
+#define WTAP_DUMP_BATCH_BUF_SIZE	(1024 * 1024)
+
+struct wtap_dump_flusher {
+	GThread *thread;
+	GMutex mutex;
+	GCond cond;
+	FILE *fh;
+	uint8_t *buf;	/* buffer being written, or the spare buffer */
+	size_t len;	/* number of bytes to write; 0 if idle */
+	bool quit;
+	int err;	/* first write error, or 0 */
+};
+
+static void *
+wtap_dump_flusher_thread(void *data)
+{
+	struct wtap_dump_flusher *flusher = (struct wtap_dump_flusher *)data;
+	size_t len;
+	int err;
+
+	g_mutex_lock(&flusher->mutex);
+	for (;;) {
+		while (flusher->len == 0 && !flusher->quit)
+			g_cond_wait(&flusher->cond, &flusher->mutex);
+		if (flusher->len == 0)
+			break;
+		len = flusher->len;
+		g_mutex_unlock(&flusher->mutex);
+
+		err = 0;
+		errno = WTAP_ERR_CANT_WRITE;
+		if (fwrite(flusher->buf, 1, len, flusher->fh) != len) {
+			if (ferror(flusher->fh))
+				err = errno;
+			else
+				err = WTAP_ERR_SHORT_WRITE;
+		}
+
+		g_mutex_lock(&flusher->mutex);
+		if (err != 0 && flusher->err == 0)
+			flusher->err = err;
+		flusher->len = 0;
+		g_cond_broadcast(&flusher->cond);
+	}
+	g_mutex_unlock(&flusher->mutex);
+	return NULL;
+}
+
+/* Wait for the background write, if any, to finish. */
+static bool
+wtap_dump_flusher_wait(struct wtap_dump_flusher *flusher, int *err)
+{
+	int flusher_err;
+
+	g_mutex_lock(&flusher->mutex);
+	while (flusher->len != 0)
+		g_cond_wait(&flusher->cond, &flusher->mutex);
+	flusher_err = flusher->err;
+	g_mutex_unlock(&flusher->mutex);
+	if (flusher_err != 0) {
+		*err = flusher_err;
+		return false;
+	}
+	return true;
+}
+
+static void
+wtap_dump_batch_start(wtap_dumper *wdh)
+{
+	struct wtap_dump_flusher *flusher;
+
+	/* The compressors do their own buffering. */
+	if (wdh->batch_buf != NULL || wdh->compression_type != WS_FILE_UNCOMPRESSED)
+		return;
+
+	wdh->batch_buf = (uint8_t *)g_malloc(WTAP_DUMP_BATCH_BUF_SIZE);
+	wdh->batch_len = 0;
+	if (!wdh->async_flush)
+		return;
+
+	flusher = g_new0(struct wtap_dump_flusher, 1);
+	g_mutex_init(&flusher->mutex);
+	g_cond_init(&flusher->cond);
+	flusher->fh = (FILE *)wdh->fh;
+	flusher->buf = (uint8_t *)g_malloc(WTAP_DUMP_BATCH_BUF_SIZE);
+	flusher->thread = g_thread_try_new("wtap_dump_flush",
+	    wtap_dump_flusher_thread, flusher, NULL);
+	if (flusher->thread == NULL) {
+		/* Just write synchronously. */
+		g_free(flusher->buf);
+		g_cond_clear(&flusher->cond);
+		g_mutex_clear(&flusher->mutex);
+		g_free(flusher);
+		return;
+	}
+	wdh->flusher = flusher;
+}
+
+/* Hand the contents of the batch buffer to the file. */
+static bool
+wtap_dump_batch_drain(wtap_dumper *wdh, int *err)
+{
+	struct wtap_dump_flusher *flusher = wdh->flusher;
+	uint8_t *spare;
+
+	if (wdh->batch_len == 0)
+		return true;
+
+	if (flusher != NULL) {
+		if (!wtap_dump_flusher_wait(flusher, err))
+			return false;
+		g_mutex_lock(&flusher->mutex);
+		spare = flusher->buf;
+		flusher->buf = wdh->batch_buf;
+		flusher->len = wdh->batch_len;
+		g_cond_broadcast(&flusher->cond);
+		g_mutex_unlock(&flusher->mutex);
+		wdh->batch_buf = spare;
+	} else {
+		errno = WTAP_ERR_CANT_WRITE;
+		if (fwrite(wdh->batch_buf, 1, wdh->batch_len, (FILE *)wdh->fh) != wdh->batch_len) {
+			if (ferror((FILE *)wdh->fh))
+				*err = errno;
+			else
+				*err = WTAP_ERR_SHORT_WRITE;
+			return false;
+		}
+	}
+	wdh->batch_len = 0;
+	return true;
+}
+
+/*
+ * Make sure everything that's been written has been passed to the
+ * FILE *, so that it can be used directly.
+ */
+static bool
+wtap_dump_batch_sync(wtap_dumper *wdh, int *err)
+{
+	if (wdh->batch_buf == NULL)
+		return true;
+	if (!wtap_dump_batch_drain(wdh, err))
+		return false;
+	if (wdh->flusher != NULL)
+		return wtap_dump_flusher_wait(wdh->flusher, err);
+	return true;
+}
+
+/* Stop the background writer and free the buffers, without writing them. */
+static void
+wtap_dump_batch_stop(wtap_dumper *wdh)
+{
+	struct wtap_dump_flusher *flusher = wdh->flusher;
+
+	if (flusher != NULL) {
+		g_mutex_lock(&flusher->mutex);
+		flusher->quit = true;
+		g_cond_broadcast(&flusher->cond);
+		g_mutex_unlock(&flusher->mutex);
+		g_thread_join(flusher->thread);
+		g_free(flusher->buf);
+		g_cond_clear(&flusher->cond);
+		g_mutex_clear(&flusher->mutex);
+		g_free(flusher);
+		wdh->flusher = NULL;
+	}
+	g_free(wdh->batch_buf);
+	wdh->batch_buf = NULL;
+	wdh->batch_len = 0;
+}
+
+bool
+wtap_dump_batch(wtap_dumper *wdh, const wtap_rec *recs, unsigned nrecs,
+    int *err, char **err_info)
+{
+	unsigned i;
+
+	*err = 0;
+	*err_info = NULL;
+	wtap_dump_batch_start(wdh);
+	for (i = 0; i < nrecs; i++) {
+		if (!(wdh->subtype_write)(wdh, &recs[i], err, err_info))
+			return false;
+	}
+	return true;
+}
+
 bool
 wtap_dump_flush(wtap_dumper *wdh, int *err)
 {
+	if (!wtap_dump_batch_sync(wdh, err))
+		return false;
+
 	switch (wdh->compression_type) {
 #if defined (HAVE_ZLIB) || defined (HAVE_ZLIBNG)
 	case WS_FILE_GZIP_COMPRESSED:
@@ -2595,6 +2940,7 @@ wtap_dump_close(wtap_dumper *wdh, bool *needs_reload,
     int *err, char **err_info)
 {
 	bool ret = true;
+	int sync_err;
 
 	*err = 0;
 	*err_info = NULL;
@@ -2603,6 +2949,11 @@ wtap_dump_close(wtap_dumper *wdh, bool *needs_reload,
 		if (!(wdh->subtype_finish)(wdh, err, err_info))
 			ret = false;
 	}
+	if (!wtap_dump_batch_sync(wdh, &sync_err)) {
+		if (ret)
+			*err = sync_err;
+		ret = false;
+	}
 	errno = WTAP_ERR_CANT_CLOSE;
 	if (wtap_dump_file_close(wdh) == EOF) {
 		if (ret) {
@@ -2773,6 +3124,20 @@ wtap_dump_file_write(wtap_dumper *wdh, const void *buf, size_t bufsize, int *err
 		break;
 #endif /* HAVE_LZ4FRAME_H */
 	default:
+		if (wdh->batch_buf != NULL) {
+			if (wdh->batch_len + bufsize > WTAP_DUMP_BATCH_BUF_SIZE &&
+			    !wtap_dump_batch_drain(wdh, err))
+				return false;
+			if (bufsize <= WTAP_DUMP_BATCH_BUF_SIZE) {
+				memcpy(wdh->batch_buf + wdh->batch_len, buf, bufsize);
+				wdh->batch_len += bufsize;
+				break;
+			}
+			/* Too big to buffer; write it directly. */
+			if (wdh->flusher != NULL &&
+			    !wtap_dump_flusher_wait(wdh->flusher, err))
+				return false;
+		}
 		errno = WTAP_ERR_CANT_WRITE;
 		nwritten = fwrite(buf, 1, bufsize, (FILE *)wdh->fh);
 		/*
@@ -2795,6 +3160,9 @@ wtap_dump_file_write(wtap_dumper *wdh, const void *buf, size_t bufsize, int *err
 static int
 wtap_dump_file_close(wtap_dumper *wdh)
 {
+	/* Anything still buffered has been written by wtap_dump_close(). */
+	wtap_dump_batch_stop(wdh);
+
 	switch (wdh->compression_type) {
 #if defined (HAVE_ZLIB) || defined (HAVE_ZLIBNG)
 	case WS_FILE_GZIP_COMPRESSED:
@@ -2819,6 +3187,8 @@ wtap_dump_file_seek(wtap_dumper *wdh, int64_t offset, int whence, int *err)
 	} else
 #endif
 	{
+		if (!wtap_dump_batch_sync(wdh, err))
+			return -1;
 		if (-1 == ws_fseek64((FILE *)wdh->fh, offset, whence)) {
 			*err = errno;
 			return -1;
@@ -2846,6 +3216,8 @@ wtap_dump_file_tell(wtap_dumper *wdh, int *err)
 	} else
 #endif
 	{
+		if (!wtap_dump_batch_sync(wdh, err))
+			return -1;
 		if (-1 == (rval = ws_ftell64((FILE *)wdh->fh))) {
 			*err = errno;
 			return -1;
@@ -78,10 +78,13 @@ static try_record_ret_t libpcap_try_record(wtap *wth, pcap_variant_t variant,
 
 static bool libpcap_read(wtap *wth, wtap_rec *rec,
     int *err, char **err_info, int64_t *data_offset);
+static bool libpcap_read_header_only(wtap *wth, wtap_rec *rec,
+    int *err, char **err_info, int64_t *data_offset);
 static bool libpcap_seek_read(wtap *wth, int64_t seek_off,
     wtap_rec *rec, int *err, char **err_info);
+static bool libpcap_seek_sequential(wtap *wth, int64_t seek_off, int *err);
 static bool libpcap_read_packet(wtap *wth, FILE_T fh,
-    wtap_rec *rec, int *err, char **err_info);
+    wtap_rec *rec, bool header_only, int *err, char **err_info);
 static bool libpcap_read_header(wtap *wth, FILE_T fh, int *err, char **err_info,
     struct pcaprec_ss990915_hdr *hdr);
 static void libpcap_close(wtap *wth);
@@ -351,7 +354,9 @@ wtap_open_return_val libpcap_open(wtap *wth, int *err, char **err_info)
 
 	/* This is a libpcap file */
 	wth->subtype_read = libpcap_read;
+	wth->subtype_read_header_only = libpcap_read_header_only;
 	wth->subtype_seek_read = libpcap_seek_read;
+	wth->subtype_seek_sequential = libpcap_seek_sequential;
 	wth->subtype_close = libpcap_close;
 	wth->snapshot_length = hdr.snaplen;
 	libpcap = g_new0(libpcap_t, 1);
@@ -708,6 +713,14 @@ wtap_open_return_val libpcap_open(wtap *wth, int *err, char **err_info)
 	if (wth->file_encap == WTAP_ENCAP_ERF) {
 		/* Reset the ERF interface lookup table */
 		libpcap->encap_priv = erf_priv_create();
+
+		/*
+		 * ERF interfaces are added as they first appear in the
+		 * packets, so interface IDs depend on all the packets
+		 * before the current one; we can't start reading in the
+		 * middle of the file.
+		 */
+		wth->subtype_seek_sequential = NULL;
 	} else {
 		/*
 		 * Add an IDB; we don't know how many interfaces were
@@ -1288,7 +1301,16 @@ static bool libpcap_read(wtap *wth, wtap_rec *rec,
 {
 	*data_offset = file_tell(wth->fh);
 
-	return libpcap_read_packet(wth, wth->fh, rec, err, err_info);
+	return libpcap_read_packet(wth, wth->fh, rec, false, err, err_info);
+}
+
+/* Read the header of the next packet, skipping its data */
+static bool libpcap_read_header_only(wtap *wth, wtap_rec *rec,
+    int *err, char **err_info, int64_t *data_offset)
+{
+	*data_offset = file_tell(wth->fh);
+
+	return libpcap_read_packet(wth, wth->fh, rec, true, err, err_info);
 }
 
 static bool
@@ -1298,7 +1320,7 @@ libpcap_seek_read(wtap *wth, int64_t seek_off, wtap_rec *rec,
 	if (file_seek(wth->random_fh, seek_off, SEEK_SET, err) == -1)
 		return false;
 
-	if (!libpcap_read_packet(wth, wth->random_fh, rec, err, err_info)) {
+	if (!libpcap_read_packet(wth, wth->random_fh, rec, false, err, err_info)) {
 		if (*err == 0)
 			*err = WTAP_ERR_SHORT_READ;
 		return false;
@@ -1306,8 +1328,19 @@ libpcap_seek_read(wtap *wth, int64_t seek_off, wtap_rec *rec,
 	return true;
 }
 
+/*
+ * Continue sequential reads at the packet at seek_off. Other than for
+ * ERF, where this isn't used, there's no state that depends on the
+ * packets before it, so we just move the stream.
+ */
 static bool
-libpcap_read_packet(wtap *wth, FILE_T fh, wtap_rec *rec,
+libpcap_seek_sequential(wtap *wth, int64_t seek_off, int *err)
+{
+	return file_seek(wth->fh, seek_off, SEEK_SET, err) != -1;
+}
+
+static bool
+libpcap_read_packet(wtap *wth, FILE_T fh, wtap_rec *rec, bool header_only,
     int *err, char **err_info)
 {
 	struct pcaprec_ss990915_hdr hdr;
@@ -1320,6 +1353,13 @@ libpcap_read_packet(wtap *wth, FILE_T fh, wtap_rec *rec,
 	if (!libpcap_read_header(wth, fh, err, err_info, &hdr))
 		return false;
 
+	/*
+	 * If we'd need the packet data to get the lengths right,
+	 * read it even if the caller only wants the header.
+	 */
+	if (header_only && !pcap_header_only_supported(wth->file_encap))
+		header_only = false;
+
 	if (hdr.hdr.incl_len > wtap_max_snaplen_for_encap(wth->file_encap)) {
 		/*
 		 * Probably a corrupt capture file; return an error,
@@ -1411,6 +1451,18 @@ libpcap_read_packet(wtap *wth, FILE_T fh, wtap_rec *rec,
 		rec->rec_header.packet_header.len = 0;
 	}
 
+	if (header_only) {
+		/*
+		 * Skip the packet data, and do the post-processing that
+		 * doesn't need it, so that the lengths match a full read.
+		 */
+		if (!wtap_read_bytes(fh, NULL, rec->rec_header.packet_header.caplen, err, err_info))
+			return false;
+		pcap_read_post_process_header_only(wth->file_encap, rec,
+		    libpcap->fcs_len);
+		return true;
+	}
+
 	/*
 	 * Read the packet data.
 	 */
@@ -1323,6 +1323,8 @@ merge_files_common(const char* out_filename, /* filename in normal output mode,
         wtap_dump_params params = WTAP_DUMP_PARAMS_INIT;
         params.encap = frame_type;
         params.snaplen = snaplen;
+        params.buffered = true;
+        params.async_flush = true;
         /*
          * Does this file type support identifying the interfaces on
          * which packets arrive?
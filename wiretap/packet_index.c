@@ -0,0 +1,394 @@
+/* packet_index.c
+ * Routines for reading and writing companion packet index files
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+#define WS_LOG_DOMAIN LOG_DOMAIN_WIRETAP
+#include "packet_index.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <wsutil/crc32.h>
+#include <wsutil/file_util.h>
+#include <wsutil/pint.h>
+#include <wsutil/wslog.h>
+
+/*
+ * File layout; all values are little-endian.
+ *
+ * Header:
+ *   0  magic                8 bytes, "WTAPIDX\0"
+ *   8  version              4 bytes
+ *  12  record size          4 bytes
+ *  16  capture file size    8 bytes
+ *  24  capture file mtime   8 bytes, seconds since the Epoch
+ *  32  head checksum        4 bytes, CRC-32 of the first HEAD_CHECK_LEN bytes
+ *  36  flags                4 bytes, INDEX_FLAG_ values
+ *  40  record count         8 bytes
+ *
+ * Followed by "record count" fixed-size records:
+ *   0  offset               8 bytes
+ *   8  time stamp seconds   8 bytes
+ *  16  time stamp nsecs     4 bytes
+ *  20  record type          4 bytes
+ *  24  presence flags       4 bytes
+ *  28  captured length      4 bytes
+ *  32  original length      4 bytes
+ *  36  interface ID         4 bytes
+ *
+ * The record size is in the header so that fields can be added at the
+ * end of a record without breaking older readers.
+ */
+static const uint8_t index_magic[8] = { 'W', 'T', 'A', 'P', 'I', 'D', 'X', '\0' };
+
+#define INDEX_VERSION           1
+#define INDEX_HEADER_LEN        48
+#define INDEX_RECORD_LEN        40
+
+/* Every record has a time stamp, and none is earlier than the one before. */
+#define INDEX_FLAG_TIME_ORDERED 0x00000001
+
+/* How much of the start of the capture file to checksum. */
+#define HEAD_CHECK_LEN          65536
+
+typedef struct {
+    uint64_t file_size;
+    int64_t  mtime;
+    uint32_t head_crc;
+} index_key_t;
+
+struct wtap_packet_index {
+    GMappedFile *mapped;
+    const uint8_t *records;
+    uint32_t record_len;
+    uint32_t flags;
+    uint64_t count;
+};
+
+struct wtap_packet_index_writer {
+    FILE    *fh;
+    char    *index_filename;
+    char    *tmp_filename;
+    index_key_t key;
+    uint32_t flags;
+    nstime_t last_ts;
+    uint64_t count;
+};
+
+/*
+ * Identify the current contents of a capture file. The size and mtime
+ * catch almost all changes; the checksum catches a file that was
+ * replaced by another capture of the same size within the same second.
+ */
+static bool
+get_index_key(const char *filename, index_key_t *key, int *err)
+{
+    ws_statb64 statb;
+    FILE *fh;
+    uint8_t *buf;
+    size_t nread;
+
+    fh = ws_fopen(filename, "rb");
+    if (fh == NULL) {
+        *err = errno;
+        return false;
+    }
+    if (ws_fstat64(ws_fileno(fh), &statb) < 0) {
+        *err = errno;
+        fclose(fh);
+        return false;
+    }
+    buf = (uint8_t *)g_malloc(HEAD_CHECK_LEN);
+    nread = fread(buf, 1, HEAD_CHECK_LEN, fh);
+    if (ferror(fh)) {
+        *err = errno;
+        g_free(buf);
+        fclose(fh);
+        return false;
+    }
+    fclose(fh);
+
+    key->file_size = (uint64_t)statb.st_size;
+    key->mtime = (int64_t)statb.st_mtime;
+    key->head_crc = crc32_ccitt(buf, (unsigned)nread);
+    g_free(buf);
+    return true;
+}
+
+static void
+fill_index_header(uint8_t *hdr, const index_key_t *key, uint32_t flags,
+                  uint64_t count)
+{
+    memcpy(hdr, index_magic, sizeof index_magic);
+    phtoleu32(hdr + 8, INDEX_VERSION);
+    phtoleu32(hdr + 12, INDEX_RECORD_LEN);
+    phtoleu64(hdr + 16, key->file_size);
+    phtoleu64(hdr + 24, (uint64_t)key->mtime);
+    phtoleu32(hdr + 32, key->head_crc);
+    phtoleu32(hdr + 36, flags);
+    phtoleu64(hdr + 40, count);
+}
+
+char *
+wtap_packet_index_filename(const char *filename)
+{
+    return g_strconcat(filename, WTAP_PACKET_INDEX_SUFFIX, NULL);
+}
+
+wtap_packet_index_t *
+wtap_packet_index_open(const char *filename)
+{
+    char *index_filename;
+    GMappedFile *mapped;
+    const uint8_t *hdr;
+    size_t len;
+    uint32_t record_len;
+    uint64_t count;
+    index_key_t key;
+    int err;
+    wtap_packet_index_t *idx;
+
+    index_filename = wtap_packet_index_filename(filename);
+    mapped = g_mapped_file_new(index_filename, false, NULL);
+    g_free(index_filename);
+    if (mapped == NULL) {
+        /* No index, or we can't read it; either way, there's nothing to use. */
+        return NULL;
+    }
+
+    len = g_mapped_file_get_length(mapped);
+    hdr = (const uint8_t *)g_mapped_file_get_contents(mapped);
+    if (len < INDEX_HEADER_LEN || memcmp(hdr, index_magic, sizeof index_magic) != 0) {
+        ws_debug("%s: not a packet index", filename);
+        goto unusable;
+    }
+    if (pletohu32(hdr + 8) != INDEX_VERSION) {
+        ws_debug("%s: unsupported packet index version %u", filename,
+                 pletohu32(hdr + 8));
+        goto unusable;
+    }
+    record_len = pletohu32(hdr + 12);
+    count = pletohu64(hdr + 40);
+    if (record_len < INDEX_RECORD_LEN ||
+        count != (len - INDEX_HEADER_LEN) / record_len ||
+        (len - INDEX_HEADER_LEN) % record_len != 0) {
+        ws_debug("%s: packet index is truncated", filename);
+        goto unusable;
+    }
+
+    if (!get_index_key(filename, &key, &err)) {
+        goto unusable;
+    }
+    if (pletohu64(hdr + 16) != key.file_size ||
+        (int64_t)pletohu64(hdr + 24) != key.mtime ||
+        pletohu32(hdr + 32) != key.head_crc) {
+        ws_debug("%s: packet index is out of date", filename);
+        goto unusable;
+    }
+
+    idx = g_new(wtap_packet_index_t, 1);
+    idx->mapped = mapped;
+    idx->records = hdr + INDEX_HEADER_LEN;
+    idx->record_len = record_len;
+    idx->flags = pletohu32(hdr + 36);
+    idx->count = count;
+    return idx;
+
+unusable:
+    g_mapped_file_unref(mapped);
+    return NULL;
+}
+
+uint64_t
+wtap_packet_index_count(const wtap_packet_index_t *idx)
+{
+    return idx->count;
+}
+
+bool
+wtap_packet_index_get(const wtap_packet_index_t *idx, uint64_t n,
+                      wtap_packet_index_entry_t *entry)
+{
+    const uint8_t *p;
+
+    if (n >= idx->count)
+        return false;
+
+    p = idx->records + n * idx->record_len;
+    entry->offset = (int64_t)pletohu64(p);
+    entry->ts.secs = (time_t)(int64_t)pletohu64(p + 8);
+    entry->ts.nsecs = (int)pletohu32(p + 16);
+    entry->rec_type = pletohu32(p + 20);
+    entry->presence_flags = pletohu32(p + 24);
+    entry->caplen = pletohu32(p + 28);
+    entry->len = pletohu32(p + 32);
+    entry->interface_id = pletohu32(p + 36);
+    return true;
+}
+
+bool
+wtap_packet_index_is_time_ordered(const wtap_packet_index_t *idx)
+{
+    return (idx->flags & INDEX_FLAG_TIME_ORDERED) != 0;
+}
+
+uint64_t
+wtap_packet_index_find_time(const wtap_packet_index_t *idx, const nstime_t *ts)
+{
+    uint64_t lo = 0, hi = idx->count;
+
+    /* Find the first record whose time stamp isn't before ts. */
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        const uint8_t *p = idx->records + mid * idx->record_len;
+        nstime_t rec_ts;
+
+        rec_ts.secs = (time_t)(int64_t)pletohu64(p + 8);
+        rec_ts.nsecs = (int)pletohu32(p + 16);
+        if (nstime_cmp(&rec_ts, ts) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+void
+wtap_packet_index_close(wtap_packet_index_t *idx)
+{
+    if (idx == NULL)
+        return;
+    g_mapped_file_unref(idx->mapped);
+    g_free(idx);
+}
+
+wtap_packet_index_writer_t *
+wtap_packet_index_writer_open(const char *filename, int *err)
+{
+    wtap_packet_index_writer_t *writer;
+    uint8_t hdr[INDEX_HEADER_LEN];
+
+    writer = g_new0(wtap_packet_index_writer_t, 1);
+    if (!get_index_key(filename, &writer->key, err)) {
+        g_free(writer);
+        return NULL;
+    }
+
+    writer->index_filename = wtap_packet_index_filename(filename);
+    writer->tmp_filename = g_strconcat(writer->index_filename, ".tmp", NULL);
+    writer->fh = ws_fopen(writer->tmp_filename, "wb");
+    if (writer->fh == NULL) {
+        *err = errno;
+        goto fail;
+    }
+
+    /*
+     * The flags and record count are filled in when we're done; until
+     * then, assume the records are in time order.
+     */
+    writer->flags = INDEX_FLAG_TIME_ORDERED;
+    nstime_set_zero(&writer->last_ts);
+    fill_index_header(hdr, &writer->key, 0, 0);
+    if (fwrite(hdr, 1, sizeof hdr, writer->fh) != sizeof hdr) {
+        *err = errno;
+        fclose(writer->fh);
+        ws_unlink(writer->tmp_filename);
+        goto fail;
+    }
+    return writer;
+
+fail:
+    g_free(writer->tmp_filename);
+    g_free(writer->index_filename);
+    g_free(writer);
+    return NULL;
+}
+
+bool
+wtap_packet_index_writer_add(wtap_packet_index_writer_t *writer,
+                             int64_t offset, const wtap_rec *rec, int *err)
+{
+    uint8_t buf[INDEX_RECORD_LEN];
+    uint32_t caplen = 0, len = 0, interface_id = 0;
+
+    if (rec->rec_type == REC_TYPE_PACKET) {
+        caplen = rec->rec_header.packet_header.caplen;
+        len = rec->rec_header.packet_header.len;
+        interface_id = rec->rec_header.packet_header.interface_id;
+    }
+
+    phtoleu64(buf, (uint64_t)offset);
+    phtoleu64(buf + 8, (uint64_t)(int64_t)rec->ts.secs);
+    phtoleu32(buf + 16, (uint32_t)rec->ts.nsecs);
+    phtoleu32(buf + 20, rec->rec_type);
+    phtoleu32(buf + 24, rec->presence_flags);
+    phtoleu32(buf + 28, caplen);
+    phtoleu32(buf + 32, len);
+    phtoleu32(buf + 36, interface_id);
+    if (fwrite(buf, 1, sizeof buf, writer->fh) != sizeof buf) {
+        *err = errno;
+        return false;
+    }
+    if (!(rec->presence_flags & WTAP_HAS_TS) ||
+        (writer->count != 0 && nstime_cmp(&rec->ts, &writer->last_ts) < 0)) {
+        writer->flags &= ~INDEX_FLAG_TIME_ORDERED;
+    }
+    writer->last_ts = rec->ts;
+    writer->count++;
+    return true;
+}
+
+bool
+wtap_packet_index_writer_close(wtap_packet_index_writer_t *writer,
+                               bool commit, int *err)
+{
+    uint8_t hdr[INDEX_HEADER_LEN];
+    bool ok = true;
+
+    if (commit) {
+        fill_index_header(hdr, &writer->key, writer->flags, writer->count);
+        if (ws_fseek64(writer->fh, 0, SEEK_SET) != 0 ||
+            fwrite(hdr, 1, sizeof hdr, writer->fh) != sizeof hdr) {
+            *err = errno;
+            ok = false;
+        }
+    }
+    if (fclose(writer->fh) == EOF && ok && commit) {
+        *err = errno;
+        ok = false;
+    }
+    if (commit && ok) {
+        if (ws_rename(writer->tmp_filename, writer->index_filename) < 0) {
+            *err = errno;
+            ok = false;
+        }
+    }
+    if (!commit || !ok) {
+        ws_unlink(writer->tmp_filename);
+    }
+
+    g_free(writer->tmp_filename);
+    g_free(writer->index_filename);
+    g_free(writer);
+    return ok;
+}
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
@@ -0,0 +1,183 @@
+/** @file
+ * Definitions for routines that read and write companion packet index
+ * files for capture files.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __PACKET_INDEX_H__
+#define __PACKET_INDEX_H__
+
+#include "wiretap/wtap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * A packet index is a file stored next to a capture file that lists,
+ * for every record in the capture file, the offset to pass to
+ * wtap_seek_read() along with the record's time stamp, lengths and
+ * interface. With it, a reader can get at any record, or find a record
+ * by time, without reading the capture file from the beginning.
+ *
+ * The index records the size and modification time of the capture
+ * file, and a checksum of its first bytes, when it's written; an
+ * index that doesn't match the capture file any more is ignored.
+ */
+
+/** Suffix appended to a capture file's name to get its index file's name. */
+#define WTAP_PACKET_INDEX_SUFFIX ".wtidx"
+
+/**
+ * @brief One record's worth of information from a packet index.
+ */
+typedef struct {
+    int64_t  offset;            /**< Offset to pass to wtap_seek_read(). */
+    nstime_t ts;                /**< Time stamp, if presence_flags has WTAP_HAS_TS. */
+    unsigned rec_type;          /**< REC_TYPE_ value for the record. */
+    uint32_t presence_flags;    /**< WTAP_HAS_ flags for the record. */
+    uint32_t caplen;            /**< Captured length; 0 for non-packet records. */
+    uint32_t len;               /**< Original length; 0 for non-packet records. */
+    uint32_t interface_id;      /**< Interface ID, if presence_flags has WTAP_HAS_INTERFACE_ID. */
+} wtap_packet_index_entry_t;
+
+typedef struct wtap_packet_index wtap_packet_index_t;
+typedef struct wtap_packet_index_writer wtap_packet_index_writer_t;
+
+/**
+ * @brief Get the name of the index file for a capture file.
+ *
+ * @param filename The capture file name.
+ * @return The index file name; free it with g_free().
+ */
+WS_DLL_PUBLIC
+char *wtap_packet_index_filename(const char *filename);
+
+/**
+ * @brief Open the index for a capture file, if there's a usable one.
+ *
+ * @param filename The capture file name.
+ * @return The index, or NULL if there's no index file, or if it's
+ * damaged or doesn't match the capture file's current contents.
+ */
+WS_DLL_PUBLIC
+wtap_packet_index_t *wtap_packet_index_open(const char *filename);
+
+/**
+ * @brief Get the number of records in an index.
+ *
+ * @param idx The index.
+ * @return The number of records.
+ */
+WS_DLL_PUBLIC
+uint64_t wtap_packet_index_count(const wtap_packet_index_t *idx);
+
+/**
+ * @brief Get a record from an index.
+ *
+ * @param idx The index.
+ * @param n The zero-based record number.
+ * @param entry Filled in with the record's information.
+ * @return true on success, false if n is out of range.
+ */
+WS_DLL_PUBLIC
+bool wtap_packet_index_get(const wtap_packet_index_t *idx, uint64_t n,
+    wtap_packet_index_entry_t *entry);
+
+/**
+ * @brief Check whether the records in an index are in time order.
+ *
+ * @param idx The index.
+ * @return true if every record has a time stamp and no record's time
+ * stamp is earlier than that of the record before it.
+ */
+WS_DLL_PUBLIC
+bool wtap_packet_index_is_time_ordered(const wtap_packet_index_t *idx);
+
+/**
+ * @brief Find the first record at or after a given time.
+ *
+ * This does a binary search, so the result is only meaningful if
+ * wtap_packet_index_is_time_ordered() returns true.
+ *
+ * @param idx The index.
+ * @param ts The time to look for.
+ * @return The zero-based number of the first record whose time stamp
+ * isn't earlier than ts, or the record count if there's no such record.
+ */
+WS_DLL_PUBLIC
+uint64_t wtap_packet_index_find_time(const wtap_packet_index_t *idx,
+    const nstime_t *ts);
+
+/**
+ * @brief Close an index opened with wtap_packet_index_open().
+ *
+ * @param idx The index.
+ */
+WS_DLL_PUBLIC
+void wtap_packet_index_close(wtap_packet_index_t *idx);
+
+/**
+ * @brief Start writing the index for a capture file.
+ *
+ * The index is written to a temporary file, which replaces any existing
+ * index when wtap_packet_index_writer_close() is called with commit set.
+ * Records must be added in the order in which wtap_read() returns them.
+ *
+ * @param filename The capture file name.
+ * @param err Set to an errno value on failure.
+ * @return The writer, or NULL on failure.
+ */
+WS_DLL_PUBLIC
+wtap_packet_index_writer_t *wtap_packet_index_writer_open(const char *filename,
+    int *err);
+
+/**
+ * @brief Add a record to an index being written.
+ *
+ * @param writer The writer.
+ * @param offset The offset returned by wtap_read() for the record.
+ * @param rec The record.
+ * @param err Set to an errno value on failure.
+ * @return true on success, false on failure.
+ */
+WS_DLL_PUBLIC
+bool wtap_packet_index_writer_add(wtap_packet_index_writer_t *writer,
+    int64_t offset, const wtap_rec *rec, int *err);
+
+/**
+ * @brief Finish writing an index.
+ *
+ * @param writer The writer; it's freed in all cases.
+ * @param commit true to install the index, false to discard it, e.g.
+ * because the capture file couldn't be read to the end.
+ * @param err Set to an errno value on failure.
+ * @return true on success, false on failure.
+ */
+WS_DLL_PUBLIC
+bool wtap_packet_index_writer_close(wtap_packet_index_writer_t *writer,
+    bool commit, int *err);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __PACKET_INDEX_H__ */
+
+/*
+ * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
@@ -2613,6 +2613,32 @@ pcap_fixup_len(wtap_rec *rec)
 	}
 }
 
+static void
+pcap_set_eth_fcs_len(wtap_rec *rec, int fcs_len)
+{
+	/*
+	 * The FCS length is supposed to be in bits.
+	 * If it's < 8, assume it's in bytes; otherwise,
+	 * convert it to bytes.
+	 */
+	if (fcs_len < 8)
+		rec->rec_header.packet_header.pseudo_header.eth.fcs_len = fcs_len;
+	else
+		rec->rec_header.packet_header.pseudo_header.eth.fcs_len = fcs_len/8;
+}
+
+static void
+pcap_fixup_erf_len(wtap_rec *rec)
+{
+	/*
+	 * Update packet size to account for ERF padding and snapping.
+	 * Captured length is minimum of wlen and previously calculated
+	 * caplen (which would have included padding but not phdr).
+	 */
+	rec->rec_header.packet_header.len = rec->rec_header.packet_header.pseudo_header.erf.phdr.wlen;
+	rec->rec_header.packet_header.caplen = MIN(rec->rec_header.packet_header.len, rec->rec_header.packet_header.caplen);
+}
+
 void
 pcap_read_post_process(bool is_nokia, int wtap_encap,
     wtap_rec *rec, bool bytes_swapped, int fcs_len)
@@ -2642,15 +2668,7 @@ pcap_read_post_process(bool is_nokia, int wtap_encap,
 		break;
 
 	case WTAP_ENCAP_ETHERNET:
-		/*
-		 * The FCS length is supposed to be in bits.
-		 * If it's < 8, assume it's in bytes; otherwise,
-		 * convert it to bytes.
-		 */
-		if (fcs_len < 8)
-			rec->rec_header.packet_header.pseudo_header.eth.fcs_len = fcs_len;
-		else
-			rec->rec_header.packet_header.pseudo_header.eth.fcs_len = fcs_len/8;
+		pcap_set_eth_fcs_len(rec, fcs_len);
 		break;
 
 	case WTAP_ENCAP_SLL:
@@ -2693,13 +2711,7 @@ pcap_read_post_process(bool is_nokia, int wtap_encap,
 		break;
 
 	case WTAP_ENCAP_ERF:
-		/*
-		 * Update packet size to account for ERF padding and snapping.
-		 * Captured length is minimum of wlen and previously calculated
-		 * caplen (which would have included padding but not phdr).
-		 */
-		rec->rec_header.packet_header.len = rec->rec_header.packet_header.pseudo_header.erf.phdr.wlen;
-		rec->rec_header.packet_header.caplen = MIN(rec->rec_header.packet_header.len, rec->rec_header.packet_header.caplen);
+		pcap_fixup_erf_len(rec);
 		break;
 
 	case WTAP_ENCAP_PFLOG:
@@ -2712,6 +2724,45 @@ pcap_read_post_process(bool is_nokia, int wtap_encap,
 	}
 }
 
+bool
+pcap_header_only_supported(int wtap_encap)
+{
+	/*
+	 * The on-the-network length of Linux memory-mapped USB
+	 * captures is fixed up based on the isochronous descriptors
+	 * in the packet data.
+	 */
+	return wtap_encap != WTAP_ENCAP_USB_LINUX_MMAPPED;
+}
+
+void
+pcap_read_post_process_header_only(int wtap_encap, wtap_rec *rec,
+    int fcs_len)
+{
+	/*
+	 * Pseudo-header byte swapping and ATM traffic type guessing
+	 * work on the packet data, which we don't have; the rest is
+	 * done as in pcap_read_post_process().
+	 */
+	switch (wtap_encap) {
+
+	case WTAP_ENCAP_ETHERNET:
+		pcap_set_eth_fcs_len(rec, fcs_len);
+		break;
+
+	case WTAP_ENCAP_NETANALYZER:
+		rec->rec_header.packet_header.pseudo_header.eth.fcs_len = 4;
+		break;
+
+	case WTAP_ENCAP_ERF:
+		pcap_fixup_erf_len(rec);
+		break;
+
+	default:
+		break;
+	}
+}
+
 bool
 wtap_encap_requires_phdr(int wtap_encap)
 {
@@ -64,6 +64,34 @@ extern int pcap_process_pseudo_header(FILE_T fh, bool is_nokia,
 extern void pcap_read_post_process(bool is_nokia, int wtap_encap,
     wtap_rec *rec, bool bytes_swapped, int fcs_len);
 
+/**
+ * @brief Checks whether a record's data can be skipped by a header-only read.
+ *
+ * For some encapsulations, pcap_read_post_process() works out the record's
+ * lengths from the packet data, so a header-only read has to read the
+ * data anyway to report the same lengths as a full read.
+ *
+ * @param wtap_encap Wiretap encapsulation type for the packet.
+ * @return @c true if the packet data can be skipped.
+ */
+extern bool pcap_header_only_supported(int wtap_encap);
+
+/**
+ * @brief Post-processes a record whose packet data was skipped.
+ *
+ * Does the part of pcap_read_post_process() that doesn't look at the
+ * packet data, so that the lengths and pseudo-header fields that don't
+ * depend on the data are the same as for a full read. Only valid if
+ * pcap_header_only_supported() returns @c true for the encapsulation.
+ *
+ * @param wtap_encap   Wiretap encapsulation type for this packet.
+ * @param rec          wtap record structure to fix up in-place.
+ * @param fcs_len      Frame Check Sequence length, as for
+ *                     pcap_read_post_process().
+ */
+extern void pcap_read_post_process_header_only(int wtap_encap,
+    wtap_rec *rec, int fcs_len);
+
 /**
  * @brief Retrieves the size of the pseudo-header for a given encapsulation type and pseudo-header.
  *
@@ -48,6 +48,9 @@ static bool
 pcapng_read(wtap *wth, wtap_rec *rec, int *err,
             char **err_info, int64_t *data_offset);
 static bool
+pcapng_read_header_only(wtap *wth, wtap_rec *rec, int *err,
+                        char **err_info, int64_t *data_offset);
+static bool
 pcapng_seek_read(wtap *wth, int64_t seek_off,
                  wtap_rec *rec, int *err, char **err_info);
 static void
@@ -2042,6 +2045,7 @@ pcapng_read_packet_block(wtap *wth _U_, FILE_T fh, uint32_t block_type,
     int pseudo_header_len;
     int fcslen;
     bool enhanced = (block_type == BLOCK_TYPE_EPB);
+    bool header_only;
 
     wblock->block = wtap_block_create(WTAP_BLOCK_PACKET);
 
@@ -2260,10 +2264,25 @@ pcapng_read_packet_block(wtap *wth _U_, FILE_T fh, uint32_t block_type,
     /* Add the time stamp offset. */
     wblock->rec->ts.secs = (time_t)(wblock->rec->ts.secs + iface_info.tsoffset);
 
+    /*
+     * If the caller only wants the record header, skip the packet
+     * data, unless we need it to get the lengths right.  The options
+     * are still processed, as a flags option can change the FCS
+     * length.
+     */
+    header_only = wblock->header_only &&
+                  pcap_header_only_supported(iface_info.wtap_encap);
+
     /* "(Enhanced) Packet Block" read capture data */
-    if (!wtap_read_bytes_buffer(fh, &wblock->rec->data,
-                                packet.cap_len - pseudo_header_len, err, err_info))
-        return false;
+    if (header_only) {
+        if (!wtap_read_bytes(fh, NULL, packet.cap_len - pseudo_header_len,
+                             err, err_info))
+            return false;
+    } else {
+        if (!wtap_read_bytes_buffer(fh, &wblock->rec->data,
+                                    packet.cap_len - pseudo_header_len, err, err_info))
+            return false;
+    }
     block_read += packet.cap_len - pseudo_header_len;
 
     /* jump over potential padding bytes at end of the packet data */
@@ -2302,8 +2321,12 @@ pcapng_read_packet_block(wtap *wth _U_, FILE_T fh, uint32_t block_type,
         wtap_block_add_uint64_option(wblock->block, OPT_PKT_DROPCOUNT, (uint64_t)packet.drops_count);
     }
 
-    pcap_read_post_process(false, iface_info.wtap_encap, wblock->rec,
-                           section_info->byte_swapped, fcslen);
+    if (header_only)
+        pcap_read_post_process_header_only(iface_info.wtap_encap,
+                                           wblock->rec, fcslen);
+    else
+        pcap_read_post_process(false, iface_info.wtap_encap, wblock->rec,
+                               section_info->byte_swapped, fcslen);
 
     /*
      * We return these to the caller in pcapng_read().
@@ -3598,6 +3621,7 @@ pcapng_open(wtap *wth, int *err, char **err_info)
     wblock.block = NULL;
     /* we don't expect any packet blocks yet */
     wblock.rec = NULL;
+    wblock.header_only = false;
 
     switch (pcapng_read_section_header_block(wth->fh, &bh, &first_section,
                                              &wblock, err, err_info)) {
@@ -3681,6 +3705,7 @@ pcapng_open(wtap *wth, int *err, char **err_info)
     g_array_append_val(pcapng->sections, first_section);
 
     wth->subtype_read = pcapng_read;
+    wth->subtype_read_header_only = pcapng_read_header_only;
     wth->subtype_seek_read = pcapng_seek_read;
     wth->subtype_close = pcapng_close;
     wth->file_type_subtype = pcapng_file_type_subtype;
@@ -3781,16 +3806,16 @@ pcapng_open(wtap *wth, int *err, char **err_info)
     return WTAP_OPEN_MINE;
 }
 
-/* classic wtap: read packet */
 static bool
-pcapng_read(wtap *wth, wtap_rec *rec, int *err, char **err_info,
-            int64_t *data_offset)
+pcapng_read_record(wtap *wth, wtap_rec *rec, bool header_only, int *err,
+                   char **err_info, int64_t *data_offset)
 {
     pcapng_t *pcapng = (pcapng_t *)wth->priv;
     section_info_t *current_section, new_section;
     wtapng_block_t wblock;
 
     wblock.rec = rec;
+    wblock.header_only = header_only;
 
     /* read next block */
     while (1) {
@@ -3839,6 +3864,22 @@ pcapng_read(wtap *wth, wtap_rec *rec, int *err, char **err_info,
     return true;
 }
 
+/* classic wtap: read packet */
+static bool
+pcapng_read(wtap *wth, wtap_rec *rec, int *err, char **err_info,
+            int64_t *data_offset)
+{
+    return pcapng_read_record(wth, rec, false, err, err_info, data_offset);
+}
+
+/* read the header of the next packet, skipping the packet data and options */
+static bool
+pcapng_read_header_only(wtap *wth, wtap_rec *rec, int *err, char **err_info,
+                        int64_t *data_offset)
+{
+    return pcapng_read_record(wth, rec, true, err, err_info, data_offset);
+}
+
 /* classic wtap: seek to file position and read packet */
 static bool
 pcapng_seek_read(wtap *wth, int64_t seek_off, wtap_rec *rec,
@@ -3887,6 +3928,7 @@ pcapng_seek_read(wtap *wth, int64_t seek_off, wtap_rec *rec,
     }
 
     wblock.rec = rec;
+    wblock.header_only = false;
 
     /* read the block */
     if (!pcapng_read_block(wth, wth->random_fh, section_info,
@@ -81,6 +81,7 @@ typedef struct wtapng_block_s {
     bool         internal;  /**< True if this block type is for internal use only and should not be returned from pcapng_read(). */
     wtap_block_t block;     /**< Generic wtap block handle carrying the block's parsed option data. */
     wtap_rec    *rec;       /**< Pointer to the wtap record populated from this block, or NULL for non-packet blocks. */
+    bool         header_only; /**< True if a packet block reader may skip the packet data (see wtap_read_header_only()). */
 } wtapng_block_t;
 
 
@@ -19,6 +19,7 @@
 #include "wtap_opttypes.h"
 #include "file_wrappers.h"
 #include "wtap_module.h"
+#include "packet_index.h"
 
 #include <wsutil/array.h>
 #include <wsutil/file_util.h>
@@ -1952,6 +1953,146 @@ wtap_read(wtap *wth, wtap_rec *rec, int *err, char **err_info, int64_t *offset)
 	return true;	/* success */
 }
 
+bool
+wtap_read_header_only(wtap *wth, wtap_rec *rec, int *err, char **err_info,
+    int64_t *offset)
+{
+	if (wth->subtype_read_header_only == NULL)
+		return wtap_read(wth, rec, err, err_info, offset);
+
+	/*
+	 * Reset the record to default values.
+	 */
+	wtap_reset_rec(wth, rec);
+
+	*err = 0;
+	*err_info = NULL;
+	if (!wth->subtype_read_header_only(wth, rec, err, err_info, offset)) {
+		/*
+		 * As with wtap_read(), check for a deferred error.
+		 */
+		if (*err == 0)
+			*err = file_error(wth->fh, err_info);
+		if (rec->block != NULL) {
+			wtap_block_unref(rec->block);
+			rec->block = NULL;
+		}
+		return false;	/* failure */
+	}
+
+	if (rec->rec_type == REC_TYPE_PACKET) {
+		ws_assert(rec->rec_header.packet_header.pkt_encap != WTAP_ENCAP_PER_PACKET);
+		ws_assert(rec->rec_header.packet_header.pkt_encap != WTAP_ENCAP_NONE);
+	}
+
+	/*
+	 * The record data wasn't read, so, unlike wtap_read(), don't
+	 * check the buffer against the captured length.
+	 */
+	return true;	/* success */
+}
+
+/*
+ * Continue sequential reads at record n of the index and read it.
+ */
+static bool
+wtap_read_from_index(wtap *wth, const wtap_packet_index_t *idx, uint64_t n,
+    wtap_rec *rec, int *err, char **err_info, int64_t *offset)
+{
+	uint64_t count = wtap_packet_index_count(idx);
+	wtap_packet_index_entry_t entry;
+
+	if (count == 0) {
+		/* No records at all. */
+		*err = 0;
+		*err_info = NULL;
+		return false;
+	}
+
+	wtap_packet_index_get(idx, MIN(n, count - 1), &entry);
+	if (!wth->subtype_seek_sequential(wth, entry.offset, err)) {
+		*err_info = NULL;
+		return false;
+	}
+	if (n >= count) {
+		/*
+		 * We want a record past the last one; skip the last one,
+		 * so that the read below reports the end of the file.
+		 */
+		if (!wtap_read_header_only(wth, rec, err, err_info, offset))
+			return false;
+		wtap_rec_reset(rec);
+	}
+	return wtap_read(wth, rec, err, err_info, offset);
+}
+
+bool
+wtap_read_from_record(wtap *wth, uint64_t rec_num,
+    const struct wtap_packet_index *idx, wtap_rec *rec, int *err,
+    char **err_info, int64_t *offset)
+{
+	uint64_t n;
+
+	if (idx != NULL && wth->subtype_seek_sequential != NULL)
+		return wtap_read_from_index(wth, idx, rec_num, rec, err,
+		    err_info, offset);
+
+	for (n = 0; n < rec_num; n++) {
+		if (!wtap_read_header_only(wth, rec, err, err_info, offset))
+			return false;
+		/* The reader may have attached a block; don't leak it. */
+		wtap_rec_reset(rec);
+	}
+	return wtap_read(wth, rec, err, err_info, offset);
+}
+
+bool
+wtap_read_from_time(wtap *wth, const nstime_t *ts,
+    const struct wtap_packet_index *idx, wtap_rec *rec, int *err,
+    char **err_info, int64_t *offset, uint64_t *rec_num)
+{
+	bool header_only;
+
+	if (idx != NULL && wth->subtype_seek_sequential != NULL &&
+	    wtap_packet_index_is_time_ordered(idx)) {
+		*rec_num = wtap_packet_index_find_time(idx, ts);
+		return wtap_read_from_index(wth, idx, *rec_num, rec, err,
+		    err_info, offset);
+	}
+
+	/*
+	 * No usable index, so look at each record in turn. If we can
+	 * reread the record we stop at, only read the headers; the
+	 * file format can then skip the data of the records before it.
+	 * For compressed files, the sequential reads leave fast seek
+	 * points behind, so the reread doesn't decompress from the
+	 * start of the file.
+	 */
+	header_only = wth->random_fh != NULL &&
+	    wth->subtype_read_header_only != NULL;
+	*rec_num = 0;
+	for (;;) {
+		if (header_only) {
+			if (!wtap_read_header_only(wth, rec, err, err_info, offset))
+				return false;
+		} else {
+			if (!wtap_read(wth, rec, err, err_info, offset))
+				return false;
+		}
+		if ((rec->presence_flags & WTAP_HAS_TS) &&
+		    nstime_cmp(&rec->ts, ts) >= 0)
+			break;
+		/* The reader may have attached a block; don't leak it. */
+		wtap_rec_reset(rec);
+		(*rec_num)++;
+	}
+	if (header_only) {
+		wtap_rec_reset(rec);
+		return wtap_seek_read(wth, *offset, rec, err, err_info);
+	}
+	return true;
+}
+
 /*
  * Read a given number of bytes from a file into a buffer or, if
  * buf is NULL, just discard them.
@@ -1748,6 +1748,10 @@ typedef struct wtap_dump_params {
                                                  This array may grow since the dumper was opened and will subsequently
                                                  be written before newer packets are written in wtap_dump. */
     bool        dont_copy_idbs;             /**< XXX - don't copy IDBs; this should eventually always be the case. */
+    bool        buffered;                   /**< Collect written data in a large buffer and write it out in big chunks,
+                                                 as wtap_dump_batch() does. Only applies to uncompressed output. */
+    bool        async_flush;                /**< If buffered, write full buffers out on a background thread while
+                                                 the next one is being filled. */
 } wtap_dump_params;
 
 /* Zero-initializer for wtap_dump_params. */
@@ -2234,6 +2238,109 @@ WS_DLL_PUBLIC
 bool wtap_read(wtap *wth, wtap_rec *rec, int *err, char **err_info,
     int64_t *offset);
 
+/**
+ * @brief Read the header of the next record in the file, skipping its data.
+ *
+ * Fills in the same record header information as wtap_read() - record
+ * type, time stamp, lengths, encapsulation and interface ID - but, for
+ * file types that support it, seeks past the record data instead of
+ * reading it. This is much cheaper for callers that only need record
+ * metadata. Where a file type works out a record's lengths from its
+ * data, as for Linux memory-mapped USB captures, the data is read
+ * anyway, so the lengths are always the same as with wtap_read().
+ * Pseudo-header fields that are derived from the data, such as a
+ * guessed ATM traffic type, aren't filled in.
+ *
+ * The contents of rec->data and rec->block are unspecified afterwards;
+ * for file types that don't support header-only reads, this is the same
+ * as wtap_read() and they're filled in as usual. Blocks that describe
+ * the file, such as interface descriptions and name resolution, are
+ * still processed.
+ *
+ * @param wth a wtap * returned by a call that opened a file for reading.
+ * @param rec a pointer to a wtap_rec, filled in with information about the
+ * record.
+ * @param err a positive "errno" value, or a negative number indicating
+ * the type of error, if the read failed.
+ * @param err_info for some errors, a string giving more details of
+ * the error
+ * @param offset a pointer to a int64_t, set to the offset in the file
+ * that should be used on calls to wtap_seek_read() to reread that record,
+ * if the read succeeded.
+ * @return true on success, false on failure.
+ */
+WS_DLL_PUBLIC
+bool wtap_read_header_only(wtap *wth, wtap_rec *rec, int *err, char **err_info,
+    int64_t *offset);
+
+struct wtap_packet_index;
+
+/**
+ * @brief Skip to a given record in the file and read it.
+ *
+ * Reads the record with the given zero-based number, as wtap_read() would
+ * if it were called rec_num + 1 times; later calls to wtap_read() return
+ * the records after it. With a packet index for the file, and a file type
+ * that supports it, the records before it aren't read at all; otherwise,
+ * only their headers are read, where the file type supports that.
+ *
+ * This must be called before any other reads from the file.
+ *
+ * @param wth a wtap * returned by a call that opened a file for reading.
+ * @param rec_num the zero-based number of the record to read.
+ * @param idx the packet index for the file, or NULL.
+ * @param rec a pointer to a wtap_rec, filled in with information about the
+ * record.
+ * @param err a positive "errno" value, or a negative number indicating
+ * the type of error, if the read failed; 0 if there are no more than
+ * rec_num records.
+ * @param err_info for some errors, a string giving more details of
+ * the error
+ * @param offset a pointer to a int64_t, set to the offset in the file
+ * that should be used on calls to wtap_seek_read() to reread that record,
+ * if the read succeeded.
+ * @return true on success, false on failure.
+ */
+WS_DLL_PUBLIC
+bool wtap_read_from_record(wtap *wth, uint64_t rec_num,
+    const struct wtap_packet_index *idx, wtap_rec *rec, int *err,
+    char **err_info, int64_t *offset);
+
+/**
+ * @brief Skip to the first record at or after a given time and read it.
+ *
+ * Reads the first record whose time stamp isn't earlier than ts; later
+ * calls to wtap_read() return the records after it, whatever their time
+ * stamps. If idx is a packet index for the file that says the records are
+ * in time order, and the file type supports it, the record is found with
+ * a binary search of the index and the records before it aren't read at
+ * all. Otherwise, the records before it are read in turn; if the file was
+ * opened for random access, only their headers are read, where the file
+ * type supports that, and the record is then reread in full.
+ *
+ * This must be called before any other reads from the file.
+ *
+ * @param wth a wtap * returned by a call that opened a file for reading.
+ * @param ts the time to look for.
+ * @param idx the packet index for the file, or NULL.
+ * @param rec a pointer to a wtap_rec, filled in with information about the
+ * record.
+ * @param err a positive "errno" value, or a negative number indicating
+ * the type of error, if the read failed; 0 if there's no such record.
+ * @param err_info for some errors, a string giving more details of
+ * the error
+ * @param offset a pointer to a int64_t, set to the offset in the file
+ * that should be used on calls to wtap_seek_read() to reread that record,
+ * if the read succeeded.
+ * @param rec_num a pointer to a uint64_t, set to the zero-based number of
+ * the record, i.e. the number of records before it.
+ * @return true on success, false on failure.
+ */
+WS_DLL_PUBLIC
+bool wtap_read_from_time(wtap *wth, const nstime_t *ts,
+    const struct wtap_packet_index *idx, wtap_rec *rec, int *err,
+    char **err_info, int64_t *offset, uint64_t *rec_num);
+
 /**
  * @brief Read the record at a specified offset in a capture file, filling in
  * *phdr and *buf.
@@ -2912,6 +3019,32 @@ bool wtap_dump_add_idb(wtap_dumper *wdh, wtap_block_t idb, int *err,
 WS_DLL_PUBLIC
 bool wtap_dump(wtap_dumper *wdh, const wtap_rec *rec, int *err, char **err_info);
 
+/**
+ * @brief Write several records to the dump file.
+ *
+ * The records are serialized into a large in-memory buffer, which is
+ * written to the file when it fills up, when wtap_dump_flush() is
+ * called, or when the file is closed, rather than with a write call or
+ * two per record. Once this has been called, records written with
+ * wtap_dump() are buffered in the same way; see also the buffered and
+ * async_flush members of wtap_dump_params.
+ *
+ * Compressed output is already buffered by the compressor, so this is
+ * the same as calling wtap_dump() for each record.
+ *
+ * @param wdh handle for the file we're writing.
+ * @param recs the records to write.
+ * @param nrecs the number of records in recs.
+ * @param[out] err Will be set to an error code on failure.
+ * @param[out] err_info for some errors, a string giving more details of
+ * the error.
+ * @return true on success, false on failure. On failure, the records
+ * before the one that failed have been written.
+ */
+WS_DLL_PUBLIC
+bool wtap_dump_batch(wtap_dumper *wdh, const wtap_rec *recs, unsigned nrecs,
+     int *err, char **err_info);
+
 /**
  * @brief Flushes the dump file.
  *
@@ -52,6 +52,17 @@ typedef bool (*subtype_read_func)(struct wtap* wtap, wtap_rec* rec,
 typedef bool (*subtype_seek_read_func)(struct wtap* wtap, int64_t seek_off, wtap_rec* rec,
                                        int* err, char** err_info);
 
+/**
+ * @brief Function pointer type for moving the sequential read position.
+ *
+ * @param wtap Wiretap handle.
+ * @param seek_off Offset of a record, as returned by a sequential read.
+ * @param err Error code output.
+ * @return true on success, false on failure.
+ */
+typedef bool (*subtype_seek_sequential_func)(struct wtap* wtap, int64_t seek_off,
+                                             int* err);
+
 /**
  * Struct holding data of the currently read file.
  */
@@ -77,7 +88,9 @@ struct wtap {
     void                        *wslua_data;            /**< Stores wslua state info and is not free'd */
 
     subtype_read_func           subtype_read;           /**< Function called for sequential reads */
+    subtype_read_func           subtype_read_header_only; /**< Function called for sequential reads that skip the record data, or NULL if not supported */
     subtype_seek_read_func      subtype_seek_read;      /**< Function called for random access reads */
+    subtype_seek_sequential_func subtype_seek_sequential; /**< Function called to continue sequential reads at a given record, or NULL if not supported */
     void                        (*subtype_sequential_close)(struct wtap*); /**< Cleanup for sequential read state. */
     void                        (*subtype_close)(struct wtap*);            /**< Cleanup for general file state. */
     int                         file_encap;    /**< Per-file encapsulation type, for those
@@ -199,6 +212,12 @@ struct wtap_dumper {
     unsigned                dsbs_growing_written;   /**< Number of already processed DSBs in dsbs_growing. */
     unsigned                mevs_growing_written;   /**< Number of already processed meta events in mevs_growing. */
     unsigned                dpibs_growing_written;   /**< Number of already processed DPIBs in dsbs_growing. */
+
+    uint8_t                 *batch_buf;      /**< Data written but not yet passed to the file, or NULL if unbuffered. */
+    size_t                  batch_len;       /**< Number of bytes in batch_buf. */
+    bool                    buffered;        /**< Start buffering as soon as the file is opened. */
+    bool                    async_flush;     /**< Write full batch buffers on a background thread. */
+    struct wtap_dump_flusher *flusher;       /**< Background writer thread state, or NULL. */
 };
 
 /**
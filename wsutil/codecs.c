@@ -79,6 +79,7 @@ struct codec_handle {
     codec_get_channels_fn channels_fn;
     codec_get_frequency_fn frequency_fn;
     codec_decode_fn decode_fn;
+    unsigned flags;
 };
 
 /*
@@ -104,6 +105,16 @@ bool
 register_codec(const char *name, codec_init_fn init_fn, codec_release_fn release_fn,
         codec_get_channels_fn channels_fn, codec_get_frequency_fn frequency_fn,
         codec_decode_fn decode_fn)
+{
+    return register_codec_with_flags(name, init_fn, release_fn, channels_fn,
+            frequency_fn, decode_fn, 0);
+}
+
+/* Register a codec by name, with capability flags. */
+bool
+register_codec_with_flags(const char *name, codec_init_fn init_fn, codec_release_fn release_fn,
+        codec_get_channels_fn channels_fn, codec_get_frequency_fn frequency_fn,
+        codec_decode_fn decode_fn, unsigned flags)
 {
     struct codec_handle *handle;
     char *key;
@@ -131,6 +142,7 @@ register_codec(const char *name, codec_init_fn init_fn, codec_release_fn release
     handle->channels_fn = channels_fn;
     handle->frequency_fn = frequency_fn;
     handle->decode_fn = decode_fn;
+    handle->flags = flags;
 
     g_hash_table_insert(registered_codecs, (void *)key, (void *) handle);
     return true;
@@ -180,6 +192,12 @@ size_t codec_decode(codec_handle_t codec, codec_context_t *context, const void *
     return (codec->decode_fn)(context, input, inputSizeBytes, output, outputSizeBytes);
 }
 
+bool codec_decode_is_thread_safe(codec_handle_t codec)
+{
+    if (!codec) return false;
+    return (codec->flags & CODEC_DECODE_THREAD_SAFE) != 0;
+}
+
 /*
  * Editor modelines  -  https://www.wireshark.org/tools/modelines.html
  *
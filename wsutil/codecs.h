@@ -130,6 +130,12 @@ typedef unsigned (*codec_get_frequency_fn)(codec_context_t *context);
  *      outputSamples points to allocated memory, outputSamplesSize is set to
  *      value returned in step (1)
  *
+ *  Unless the codec was registered with CODEC_DECODE_THREAD_SAFE, this is
+ *  never called from more than one thread at a time. With the flag set,
+ *  the RTP player may call it from different threads at the same time,
+ *  each with its own context. The init and release functions are always
+ *  called from one thread.
+ *
  * @param context Pointer to codec context
  * @param inputBytes Pointer to input frame
  * @param inputBytesSize Length of input frame in bytes
@@ -167,6 +173,33 @@ WS_DLL_PUBLIC bool register_codec(const char *name, codec_init_fn init_fn,
         codec_release_fn release_fn, codec_get_channels_fn channels_fn,
         codec_get_frequency_fn frequency_fn, codec_decode_fn decode_fn);
 
+/**
+ * The codec's decode function keeps all of its state in the context it is
+ * given, so different contexts can be decoded from different threads at the
+ * same time.
+ */
+#define CODEC_DECODE_THREAD_SAFE 0x00000001
+
+/**
+ * @brief Register a new codec implementation with capability flags.
+ *
+ * Same as register_codec(), with `flags` describing what the codec supports.
+ * register_codec() registers with no flags set.
+ *
+ * @param name          Unique name identifying the codec.
+ * @param init_fn       Function to initialize codec state.
+ * @param release_fn    Function to release codec resources.
+ * @param channels_fn   Function to query channel count.
+ * @param frequency_fn  Function to query sample rate.
+ * @param decode_fn     Function to decode input bytes into audio samples.
+ * @param flags         Bitwise OR of CODEC_* capability flags.
+ * @return              `true` if registration succeeded, `false` otherwise.
+ */
+WS_DLL_PUBLIC bool register_codec_with_flags(const char *name, codec_init_fn init_fn,
+        codec_release_fn release_fn, codec_get_channels_fn channels_fn,
+        codec_get_frequency_fn frequency_fn, codec_decode_fn decode_fn,
+        unsigned flags);
+
 /**
  * @brief Deregister a previously registered codec.
  *
@@ -249,6 +282,14 @@ WS_DLL_PUBLIC size_t codec_decode(codec_handle_t codec, codec_context_t *context
         const void *inputBytes, size_t inputBytesSize,
         void *outputSamples, size_t *outputSamplesSize);
 
+/**
+ * @brief Check whether a codec may decode from several threads at once.
+ *
+ * @param codec Handle to the codec.
+ * @return      `true` if the codec was registered with CODEC_DECODE_THREAD_SAFE.
+ */
+WS_DLL_PUBLIC bool codec_decode_is_thread_safe(codec_handle_t codec);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
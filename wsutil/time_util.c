@@ -280,6 +280,31 @@ ws_clock_get_realtime(struct timespec *ts)
 #endif
 }
 
+uint64_t
+ws_clock_get_monotonic_ns(void)
+{
+#if defined(_WIN32)
+	static LARGE_INTEGER freq;
+	LARGE_INTEGER count;
+
+	if (freq.QuadPart == 0) {
+		QueryPerformanceFrequency(&freq);
+	}
+	QueryPerformanceCounter(&count);
+	/* Split the conversion so that it can't overflow. */
+	return (uint64_t)(count.QuadPart / freq.QuadPart) * 1000000000 +
+		(uint64_t)(count.QuadPart % freq.QuadPart) * 1000000000 / freq.QuadPart;
+#elif defined(HAVE_CLOCK_GETTIME) && defined(CLOCK_MONOTONIC)
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+		return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+	return (uint64_t)g_get_monotonic_time() * 1000;
+#else
+	return (uint64_t)g_get_monotonic_time() * 1000;
+#endif
+}
+
 struct tm *
 ws_localtime_r(const time_t *timep, struct tm *result)
 {
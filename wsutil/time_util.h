@@ -98,6 +98,19 @@ void ws_tzset(void);
 WS_DLL_PUBLIC
 struct timespec *ws_clock_get_realtime(struct timespec *ts);
 
+/**
+ * @brief Retrieves a monotonic clock value in nanoseconds.
+ *
+ * The value has no defined epoch; only differences between two readings
+ * are meaningful. It is intended for measuring short intervals, e.g. when
+ * profiling, where the microsecond resolution of g_get_monotonic_time()
+ * is too coarse.
+ *
+ * @return The current monotonic time in nanoseconds.
+ */
+WS_DLL_PUBLIC
+uint64_t ws_clock_get_monotonic_ns(void);
+
 /**
  * @brief Converts a time value to local time.
  *
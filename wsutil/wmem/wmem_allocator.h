@@ -14,6 +14,7 @@
 #define __WMEM_ALLOCATOR_H__
 
 #include <glib.h>
+#include <stdint.h>
 #include <string.h>
 
 #ifdef __cplusplus
@@ -49,6 +50,7 @@ struct _wmem_allocator_t {
     void *private_data; /**< Allocator-specific internal state. */
     enum _wmem_allocator_type_t type; /**< Allocator type (e.g., scope, file-backed, slab). */
     bool in_scope; /**< Indicates whether the allocator is currently active in a scope. */
+    uint64_t bytes_requested; /**< Running total of bytes requested through walloc/wrealloc, see wmem_count_bytes_requested(). */
 };
 
 #ifdef __cplusplus
@@ -28,6 +28,9 @@
 static bool do_override;
 static wmem_allocator_type_t override_type;
 
+/* Set by wmem_count_bytes_requested(), for profiling. */
+static bool count_bytes_requested;
+
 void *
 wmem_alloc(wmem_allocator_t *allocator, const size_t size)
 {
@@ -41,6 +44,10 @@ wmem_alloc(wmem_allocator_t *allocator, const size_t size)
         return NULL;
     }
 
+    if (G_UNLIKELY(count_bytes_requested)) {
+        allocator->bytes_requested += size;
+    }
+
     return allocator->walloc(allocator->private_data, size);
 }
 
@@ -93,6 +100,10 @@ wmem_realloc(wmem_allocator_t *allocator, void *ptr, const size_t size)
 
     ws_assert(allocator->in_scope);
 
+    if (G_UNLIKELY(count_bytes_requested)) {
+        allocator->bytes_requested += size;
+    }
+
     return allocator->wrealloc(allocator->private_data, ptr, size);
 }
 
@@ -110,6 +121,22 @@ wmem_free_all(wmem_allocator_t *allocator)
     wmem_free_all_real(allocator, false);
 }
 
+void
+wmem_count_bytes_requested(bool enable)
+{
+    count_bytes_requested = enable;
+}
+
+uint64_t
+wmem_bytes_requested(const wmem_allocator_t *allocator)
+{
+    if (allocator == NULL) {
+        return 0;
+    }
+
+    return allocator->bytes_requested;
+}
+
 void
 wmem_gc(wmem_allocator_t *allocator)
 {
@@ -142,6 +169,7 @@ wmem_allocator_new(const wmem_allocator_type_t type)
     allocator->type      = real_type;
     allocator->callbacks = NULL;
     allocator->in_scope  = true;
+    allocator->bytes_requested = 0;
 
     switch (real_type) {
         case WMEM_ALLOCATOR_SIMPLE:
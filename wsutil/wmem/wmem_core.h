@@ -195,6 +195,34 @@ WS_DLL_PUBLIC
 void
 wmem_free_all(wmem_allocator_t *allocator);
 
+/**
+ * @brief Turns counting of the bytes requested from pools on or off.
+ *
+ * Counting is off by default, so that it costs nothing in the allocation
+ * path unless a profiler wants it. It applies to all pools.
+ *
+ * @param enable true to count the bytes requested, false to stop.
+ */
+WS_DLL_PUBLIC
+void
+wmem_count_bytes_requested(bool enable);
+
+/**
+ * @brief Returns the number of bytes requested from a pool since it was created.
+ *
+ * The counter covers wmem_alloc() and wmem_realloc() while counting is turned
+ * on with wmem_count_bytes_requested(), and is never decreased by frees, so
+ * the difference between two readings is the amount of memory asked for in
+ * between. Profilers use this to attribute allocations to code.
+ *
+ * @param allocator The allocator to query. NULL (the system allocator) is not
+ * tracked and always returns 0.
+ * @return The running total of requested bytes.
+ */
+WS_DLL_PUBLIC
+uint64_t
+wmem_bytes_requested(const wmem_allocator_t *allocator);
+
 /**
  * @brief Triggers a garbage-collection in the allocator.
  *
@@ -137,6 +137,41 @@ wmem_test_foreach_cb(const void *key _U_, void *value, void *user_data)
 
 /* ALLOCATOR TESTING FUNCTIONS (/wmem/allocator/) */
 
+static void
+wmem_test_allocator_bytes_requested(void)
+{
+    wmem_allocator_t *allocator;
+    void *ptr;
+
+    allocator = wmem_allocator_new(WMEM_ALLOCATOR_BLOCK);
+
+    /* Nothing is counted unless counting is turned on. */
+    ptr = wmem_alloc(allocator, 100);
+    wmem_free(allocator, ptr);
+    g_assert_true(wmem_bytes_requested(allocator) == 0);
+
+    wmem_count_bytes_requested(true);
+
+    ptr = wmem_alloc(allocator, 100);
+    g_assert_true(wmem_bytes_requested(allocator) == 100);
+
+    ptr = wmem_realloc(allocator, ptr, 200);
+    g_assert_true(wmem_bytes_requested(allocator) == 300);
+
+    /* Frees don't decrease the running total. */
+    wmem_free(allocator, ptr);
+    wmem_free_all(allocator);
+    g_assert_true(wmem_bytes_requested(allocator) == 300);
+
+    g_assert_true(wmem_bytes_requested(NULL) == 0);
+
+    wmem_count_bytes_requested(false);
+    ptr = wmem_alloc(allocator, 100);
+    g_assert_true(wmem_bytes_requested(allocator) == 300);
+
+    wmem_destroy_allocator(allocator);
+}
+
 static void
 wmem_test_allocator_callbacks(void)
 {
@@ -1470,6 +1505,7 @@ main(int argc, char **argv)
     g_test_add_func("/wmem/allocator/simple",    wmem_test_allocator_simple);
     g_test_add_func("/wmem/allocator/strict",    wmem_test_allocator_strict);
     g_test_add_func("/wmem/allocator/callbacks", wmem_test_allocator_callbacks);
+    g_test_add_func("/wmem/allocator/bytes_requested", wmem_test_allocator_bytes_requested);
 
     g_test_add_func("/wmem/utils/misc",    wmem_test_miscutls);
     g_test_add_func("/wmem/utils/strings", wmem_test_strutls);